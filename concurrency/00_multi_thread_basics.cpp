@@ -4,8 +4,13 @@
 #include <vector>
 #include <atomic>
 #include <chrono>
+#include <string>
+#include <sstream>
+#include <iomanip>
 #include <unistd.h>
 
+#include "topology.h"
+
 using namespace std;
 
 static volatile uint64_t blackhole_mt = 0; // prevents over-optimization
@@ -23,6 +28,164 @@ void worker(uint64_t start, uint64_t end, atomic<uint64_t>& total) {
     total.fetch_add(part); // default (seq_cst) for clarity
 }
 
+// ============================================================================
+// Placement: the same kind of work on per-worker data, three ways
+// ============================================================================
+//   naive  : no affinity, main thread allocates/initializes ALL data (so on a
+//            NUMA box every page sits on main's node), partial sums go into
+//            ONE shared atomic every 4096 elements (every core fights for it)
+//   pinned : workers pinned in topology order (cores first, then SMT
+//            siblings), data and reduction as in naive - isolates placement
+//   placed : pinned + each worker allocates and first-touches its own block
+//            (node-local) + hierarchical reduction: private partial ->
+//            per-node atomic -> one global add per node
+
+enum class Mode { Naive, Pinned, Placed };
+
+const char* mode_name(Mode m) {
+    switch (m) {
+        case Mode::Naive: return "naive";
+        case Mode::Pinned: return "pinned";
+        case Mode::Placed: return "placed";
+    }
+    return "?";
+}
+
+struct alignas(64) NodeSum {   // own cache line per node
+    atomic<uint64_t> sum{0};
+    atomic<int> arrived{0};
+};
+
+const uint64_t kFlushEvery = 4096;
+const int kPasses = 4;
+
+uint64_t sum_block(const uint64_t* data, size_t n, atomic<uint64_t>* shared) {
+    uint64_t part = 0;
+    for (int pass = 0; pass < kPasses; pass++) {
+        for (size_t i = 0; i < n; i++) {
+            part += data[i] * data[i];
+            if (shared && (i + 1) % kFlushEvery == 0) {  // periodic publish (naive/pinned)
+                shared->fetch_add(part);
+                part = 0;
+            }
+        }
+    }
+    if (shared) {
+        shared->fetch_add(part);
+        return 0;
+    }
+    return part;
+}
+
+// Returns elapsed milliseconds; `result` receives the reduced total.
+double run_placement(const topo::Topology& topo, unsigned T, size_t total_elems, Mode mode,
+                     uint64_t& result) {
+    vector<int> order = topo.placement_order();
+    size_t per = total_elems / T;
+
+    // naive/pinned: one big block initialized by main (first touch = main's node)
+    vector<uint64_t> shared_data;
+    if (mode != Mode::Placed) {
+        shared_data.resize(per * T);
+        for (size_t i = 0; i < shared_data.size(); i++) shared_data[i] = i & 0xffff;
+    }
+
+    // Workers per node (for the last-arriver check in the hierarchical reduce)
+    vector<NodeSum> nodes(topo.nodes());
+    vector<int> members(nodes.size(), 0);
+    for (unsigned w = 0; w < T; w++) members[topo.cpu(order[w % order.size()]).node_index]++;
+    vector<uint64_t*> owned(T, nullptr);  // Placed mode: freed after the clock stops
+
+    atomic<uint64_t> total{0};
+    atomic<unsigned> ready{0};
+    atomic<bool> go{false};
+    vector<thread> threads;
+    threads.reserve(T);
+
+    for (unsigned w = 0; w < T; w++) {
+        threads.emplace_back([&, w]() {
+            int cpu = order[w % order.size()];
+            if (mode != Mode::Naive) topo::pin_current_thread(cpu);
+
+            const uint64_t* data;
+            uint64_t* own = nullptr;
+            if (mode == Mode::Placed) {
+                own = owned[w] = topo::alloc_local<uint64_t>(per);  // first touch on our node
+                for (size_t i = 0; i < per; i++) own[i] = (w * per + i) & 0xffff;
+                data = own;
+            } else {
+                data = shared_data.data() + w * per;
+            }
+
+            ready++;
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+
+            if (mode == Mode::Placed) {
+                uint64_t part = sum_block(data, per, nullptr);  // private, in a register
+                const int node = topo.cpu(cpu).node_index;
+                NodeSum& ns = nodes[node];
+                ns.sum.fetch_add(part);
+                if (ns.arrived.fetch_add(1) + 1 == members[node]) {
+                    total.fetch_add(ns.sum.load());  // one global update per node
+                }
+            } else {
+                sum_block(data, per, &total);
+            }
+        });
+    }
+
+    while (ready.load() < T) this_thread::yield();  // setup (allocation) is not timed
+    auto t0 = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (auto& th : threads) th.join();
+    auto t1 = chrono::steady_clock::now();
+    for (uint64_t* own : owned) topo::free_local(own, per);  // munmap is not part of the work
+
+    result = total.load();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void benchmark_placement() {
+    cout << "\n=== THREAD PLACEMENT: SCALING CURVES ===" << "\n";
+    topo::Topology topo = topo::Topology::discover();
+    topo.print(cout);
+
+    cout << "Placement order:";
+    for (int c : topo.placement_order()) cout << " cpu" << c;
+    cout << "\n\n";
+
+    const size_t elems = 8'000'000;  // 64 MB of uint64_t
+    unsigned max_threads = 2 * unsigned(topo.cpus().size());  // include oversubscription
+    vector<unsigned> counts;
+    for (unsigned t = 1; t <= max_threads; t *= 2) counts.push_back(t);
+    if (counts.back() != max_threads) counts.push_back(max_threads);
+
+    cout << left << setw(10) << "threads";
+    for (Mode m : {Mode::Naive, Mode::Pinned, Mode::Placed}) cout << right << setw(14) << mode_name(m);
+    cout << "   (ms, lower is better; speedup vs 1 thread)\n";
+
+    vector<double> base(3, 0);
+    for (unsigned T : counts) {
+        cout << left << setw(10) << T;
+        int col = 0;
+        uint64_t expected = 0;
+        for (Mode m : {Mode::Naive, Mode::Pinned, Mode::Placed}) {
+            uint64_t result = 0;
+            double ms = run_placement(topo, T, elems, m, result);
+            if (col == 0) expected = result;
+            if (base[col] == 0) base[col] = ms;
+            ostringstream cell;
+            cell << fixed << setprecision(1) << ms << " (" << setprecision(2) << base[col] / ms << "x)";
+            cout << right << setw(14) << cell.str();
+            if (result != expected) cout << " MISMATCH";
+            col++;
+        }
+        cout << "\n";
+    }
+    cout << "\nOn a single-node, non-SMT machine the columns converge: placement can only" << "\n";
+    cout << "help when there are siblings to avoid and remote nodes to keep data off." << "\n";
+}
+
 int main() {
     cout << "Multi-thread basics" << "\n";
     cout << "PID: " << getpid() << "\n";
@@ -55,5 +218,8 @@ int main() {
     cout << "Work: sum_{i=1.." << N << "} i^2" << "\n";
     cout << "Total result: " << total.load() << "\n";
     cout << "Elapsed: " << us << " us\n";
+
+    // Same idea at scale: where threads run and where their data lives
+    benchmark_placement();
     return 0;
 }
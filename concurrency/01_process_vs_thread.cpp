@@ -38,6 +38,7 @@
  * CONTEXT SWITCH COST (approximate):
  * - Thread context switch: 1-2 microseconds
  * - Process context switch: 10-20 microseconds (TLB flush, page table reload)
+ * - Measure on YOUR machine: 08_ipc_benchmark.cpp (spawn + IPC histograms)
  */
 
 #include <iostream>
@@ -127,11 +128,12 @@ void demonstrate_processes() {
 
 void compare_performance() {
     cout << "\n=== PERFORMANCE COMPARISON ===" << endl;
+    const int N = 100;
     
     // Thread creation time
     auto start = chrono::high_resolution_clock::now();
     vector<thread> threads;
-    for(int i = 0; i < 100; i++) {
+    for(int i = 0; i < N; i++) {
         threads.push_back(thread([](){
             // Do minimal work
             volatile int x = 0;
@@ -144,13 +146,28 @@ void compare_performance() {
     auto end = chrono::high_resolution_clock::now();
     auto thread_time = chrono::duration_cast<chrono::microseconds>(end - start);
     
-    cout << "Creating/joining 100 threads: " << thread_time.count() << " μs" << endl;
-    cout << "Average per thread: " << thread_time.count() / 100.0 << " μs" << endl;
+    cout << "Creating/joining " << N << " threads: " << thread_time.count() << " μs" << endl;
+    cout << "Average per thread: " << thread_time.count() / double(N) << " μs" << endl;
     
-    // Process creation is much slower - don't create 100!
-    // Just demonstrating the concept
-    cout << "\nNote: Process creation is ~10x slower" << endl;
-    cout << "fork() involves copying page tables, setting up new address space" << endl;
+    // Process creation: measured the same way instead of assumed.
+    // fork() copies page tables and marks pages copy-on-write, so the cost
+    // grows with the parent's memory (see 08_ipc_benchmark.cpp, 256MB case).
+    start = chrono::high_resolution_clock::now();
+    for(int i = 0; i < N; i++) {
+        pid_t pid = fork();
+        if(pid == 0) {
+            _exit(0);  // child: no work, no stdio flush
+        }
+        waitpid(pid, NULL, 0);
+    }
+    end = chrono::high_resolution_clock::now();
+    auto fork_time = chrono::duration_cast<chrono::microseconds>(end - start);
+    
+    cout << "Creating/reaping " << N << " processes: " << fork_time.count() << " μs" << endl;
+    cout << "Average per process: " << fork_time.count() / double(N) << " μs" << endl;
+    cout << "Measured ratio (process / thread): "
+         << (thread_time.count() ? double(fork_time.count()) / thread_time.count() : 0) << "x" << endl;
+    cout << "Full histograms (fork, vfork, posix_spawn, threads): make FILE=08_ipc_benchmark.cpp run" << endl;
 }
 
 int main() {
@@ -172,7 +189,7 @@ int main() {
     cout << "\n=== KEY TAKEAWAYS ===" << endl;
     cout << "1. Threads share memory (code, data, heap) - faster IPC" << endl;
     cout << "2. Processes isolated - safer but higher overhead" << endl;
-    cout << "3. Thread context switch ~10x faster than process" << endl;
+    cout << "3. Thread creation measurably cheaper than fork (ratio printed above)" << endl;
     cout << "4. Use threads when: Need fast IPC, shared state" << endl;
     cout << "5. Use processes when: Need isolation, security, stability" << endl;
     
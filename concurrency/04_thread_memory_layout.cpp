@@ -71,9 +71,22 @@
 #include <iostream>
 #include <thread>
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <deque>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <pthread.h>
 #include <unistd.h>
 #include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "tcache_allocator.h"
+#include "thread_stack.h"
 
 using namespace std;
 
@@ -175,7 +188,13 @@ void demonstrate_stack_independence() {
     }
     
     cout << "\nNotice: Each thread's stack is at different address!" << endl;
-    cout << "These are separate 8MB regions in same address space" << endl;
+    pthread_attr_t attr;
+    size_t default_stack = 0;
+    pthread_attr_init(&attr);
+    pthread_attr_getstacksize(&attr, &default_stack);
+    pthread_attr_destroy(&attr);
+    cout << "These are separate " << default_stack / (1024 * 1024)
+         << "MB regions in same address space (pthread default = RLIMIT_STACK)" << endl;
 }
 
 void demonstrate_tls() {
@@ -210,20 +229,280 @@ void demonstrate_tls() {
     cout << "\nTLS provides per-thread variables without locking!" << endl;
 }
 
+// ============================================================================
+// TLS IN PRACTICE: THREAD-LOCAL CACHING ALLOCATOR (tcache_allocator.h)
+// ============================================================================
+// Every `new` above goes to the SHARED heap, so malloc must synchronize
+// between threads. tcache keeps per-thread free lists in TLS (no locks on
+// the fast path), refills/returns in batches from a global depot, and sends
+// objects freed by another thread back to their owner through a lock-free
+// remote-free stack.
+
+void demonstrate_tls_allocator() {
+    cout << "\n=== TLS ALLOCATOR: LOCAL vs REMOTE FREES ===" << endl;
+
+    const int N = 10000;
+    vector<void*> objects(N);
+    tcache::Stats before = tcache::stats();
+
+    atomic<int> phase{0}; // 1 = allocated, 2 = freed
+    const void* producer_heap = nullptr;
+    const void* consumer_heap = nullptr;
+
+    // Producer thread allocates: objects are carved from ITS spans. It stays
+    // alive until the consumer is done, so the two threads own different heaps.
+    thread producer([&objects, &phase, &producer_heap]() {
+        for (int i = 0; i < N; i++) objects[i] = tcache::allocate(64);
+        producer_heap = tcache::thread_cache().heap();
+        cout << "Producer heap (TLS): " << producer_heap
+             << ", first object at " << objects[0] << endl;
+        phase = 1;
+        while (phase != 2) this_thread::yield();
+    });
+
+    // Consumer thread frees: every free is REMOTE (span owned by producer)
+    thread consumer([&objects, &phase, &consumer_heap]() {
+        while (phase != 1) this_thread::yield();
+        consumer_heap = tcache::thread_cache().heap();
+        cout << "Consumer heap (TLS): " << consumer_heap << endl;
+        for (void* p : objects) tcache::deallocate(p, 64);
+        tcache::flush();
+        phase = 2;
+    });
+    producer.join();
+    consumer.join();
+
+    tcache::Stats after = tcache::stats();
+    cout << "allocs:           " << after.allocs - before.allocs << endl;
+    cout << "remote frees:     " << after.remote_frees - before.remote_frees
+         << " in " << after.remote_pushes - before.remote_pushes << " CAS pushes (batched)" << endl;
+    cout << "depot refills:    " << after.depot_refills - before.depot_refills << endl;
+    cout << "spans carved:     " << after.spans - before.spans << " x 64KB" << endl;
+
+    // A new thread adopts whichever heap was parked last (thread exit order
+    // decides). Only the producer's heap has remote frees waiting in it.
+    thread reuse([producer_heap, consumer_heap]() {
+        tcache::Stats s0 = tcache::stats();
+        void* p = tcache::allocate(64);
+        tcache::Stats s1 = tcache::stats();
+        const void* heap = tcache::thread_cache().heap();
+        cout << "New thread adopted heap " << heap << " ("
+             << (heap == producer_heap ? "the producer's"
+                 : heap == consumer_heap ? "the consumer's" : "another parked heap")
+             << "), reclaimed " << s1.remote_reclaimed - s0.remote_reclaimed
+             << " remotely freed objects with ONE exchange" << endl;
+        tcache::deallocate(p, 64);
+    });
+    reuse.join();
+}
+
+struct GlibcMalloc {
+    static const char* name() { return "glibc malloc"; }
+    static void* alloc(size_t n) { return malloc(n); }
+    static void release(void* p, size_t) { free(p); }
+};
+
+struct TlsCache {
+    static const char* name() { return "tcache"; }
+    static void* alloc(size_t n) { return tcache::allocate(n); }
+    static void release(void* p, size_t n) { tcache::deallocate(p, n); }
+};
+
+// Bounded single-producer/single-consumer hand-off of pointers.
+class PtrRing {
+    static const size_t kCap = 1024;
+    void* slots[kCap];
+    alignas(64) atomic<size_t> head{0};
+    alignas(64) atomic<size_t> tail{0};
+
+public:
+    void push(void* p) {
+        size_t h = head.load(memory_order_relaxed);
+        while (h - tail.load(memory_order_acquire) == kCap) this_thread::yield();
+        slots[h % kCap] = p;
+        head.store(h + 1, memory_order_release);
+    }
+    void* pop() {
+        size_t t = tail.load(memory_order_relaxed);
+        while (head.load(memory_order_acquire) == t) this_thread::yield();
+        void* p = slots[t % kCap];
+        tail.store(t + 1, memory_order_release);
+        return p;
+    }
+};
+
+size_t size_for(size_t i) { return 16 + (i * 37) % 497; } // 16..512, mixed classes
+
+// Pattern 1: every thread allocates and frees its own objects.
+template <typename A>
+void churn_local(int threads, size_t ops_per_thread) {
+    vector<thread> ts;
+    for (int t = 0; t < threads; t++) {
+        ts.emplace_back([ops_per_thread]() {
+            void* live[64];
+            for (size_t i = 0; i < ops_per_thread; i += 64) {
+                for (size_t k = 0; k < 64; k++) live[k] = A::alloc(size_for(i + k));
+                for (size_t k = 0; k < 64; k++) A::release(live[k], size_for(i + k));
+            }
+        });
+    }
+    for (auto& t : ts) t.join();
+}
+
+// Pattern 2: producer allocates messages, its paired consumer frees them.
+template <typename A>
+void producer_consumer(int pairs, size_t ops_per_pair) {
+    vector<PtrRing> rings(pairs);
+    vector<thread> ts;
+    for (int p = 0; p < pairs; p++) {
+        ts.emplace_back([&rings, p, ops_per_pair]() {
+            for (size_t i = 0; i < ops_per_pair; i++) rings[p].push(A::alloc(64));
+        });
+        ts.emplace_back([&rings, p, ops_per_pair]() {
+            for (size_t i = 0; i < ops_per_pair; i++) A::release(rings[p].pop(), 64);
+        });
+    }
+    for (auto& t : ts) t.join();
+}
+
+// Pattern 3: pool - one submitter allocates mixed-size tasks, N workers free.
+// The queue is bounded so both allocators are measured at the same backlog.
+template <typename A>
+void submitter_pool(int workers, size_t ops) {
+    const size_t kMaxBatches = 16;
+    mutex m;
+    deque<vector<pair<void*, size_t>>> batches;
+    bool done = false;
+    vector<thread> ts;
+    for (int w = 0; w < workers; w++) {
+        ts.emplace_back([&]() {
+            for (;;) {
+                vector<pair<void*, size_t>> batch;
+                {
+                    lock_guard<mutex> lock(m);
+                    if (!batches.empty()) {
+                        batch = move(batches.front());
+                        batches.pop_front();
+                    } else if (done) {
+                        return;
+                    }
+                }
+                if (batch.empty()) {
+                    this_thread::yield();
+                    continue;
+                }
+                for (auto& [p, n] : batch) A::release(p, n);
+            }
+        });
+    }
+    for (size_t i = 0; i < ops; i += 64) {
+        vector<pair<void*, size_t>> batch;
+        batch.reserve(64);
+        for (size_t k = 0; k < 64; k++) batch.push_back({A::alloc(size_for(i + k)), size_for(i + k)});
+        for (;;) {
+            {
+                lock_guard<mutex> lock(m);
+                if (batches.size() < kMaxBatches) {
+                    batches.push_back(move(batch));
+                    break;
+                }
+            }
+            this_thread::yield();
+        }
+    }
+    {
+        lock_guard<mutex> lock(m);
+        done = true;
+    }
+    for (auto& t : ts) t.join();
+}
+
+long peak_rss_kb() {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f) return 0;
+    char line[256];
+    long kb = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) kb = atol(line + 6);
+    }
+    fclose(f);
+    return kb;
+}
+
+// Runs fn in a forked child so each allocator starts from a clean heap and
+// its peak RSS is its own. Returns {alloc+free pairs per second, peak RSS KB}.
+template <typename Fn>
+pair<double, long> measure_isolated(Fn fn, size_t ops) {
+    int fds[2];
+    if (pipe(fds) < 0) return {0, 0};
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        auto start = chrono::steady_clock::now();
+        fn();
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        pair<double, long> r{ops / secs, peak_rss_kb()};
+        ssize_t w = write(fds[1], &r, sizeof(r));
+        _exit(w == sizeof(r) ? 0 : 1);
+    }
+    close(fds[1]);
+    pair<double, long> r{0, 0};
+    ssize_t n = read(fds[0], &r, sizeof(r));
+    (void)n;
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return r;
+}
+
+template <typename A>
+void run_allocator_patterns(size_t ops) {
+    auto local = measure_isolated([ops]() { churn_local<A>(4, ops / 4); }, ops);
+    auto pc = measure_isolated([ops]() { producer_consumer<A>(2, ops / 2); }, ops);
+    auto pool = measure_isolated([ops]() { submitter_pool<A>(4, ops); }, ops);
+    cout << left << setw(14) << A::name() << right << fixed << setprecision(1);
+    for (auto r : {local, pc, pool}) {
+        cout << setw(12) << r.first / 1e6 << setw(10) << r.second / 1024.0;
+    }
+    cout << defaultfloat << endl;
+}
+
+void benchmark_tls_allocator() {
+    const size_t ops = 4000000;
+    cout << "\n=== ALLOCATOR BENCHMARK: " << ops / 1000000 << "M alloc+free pairs per pattern ===" << endl;
+    cout << "(Mops/s and peak RSS in MB; each run in a fresh forked process)\n" << endl;
+    cout << left << setw(14) << "" << right << setw(22) << "local churn x4"
+         << setw(22) << "prod->cons x2" << setw(22) << "pool 1->4" << endl;
+    cout << left << setw(14) << "allocator" << right;
+    for (int i = 0; i < 3; i++) cout << setw(12) << "Mops/s" << setw(10) << "RSS MB";
+    cout << endl;
+
+    run_allocator_patterns<GlibcMalloc>(ops);
+    run_allocator_patterns<TlsCache>(ops);
+
+    cout << "\nCross-thread frees are where per-thread caches usually fail: the consumer" << endl;
+    cout << "would hoard the producer's memory. Remote-free stacks hand it back in batches." << endl;
+}
+
 void show_actual_stack_usage() {
     cout << "\n=== ACTUAL STACK USAGE ===" << endl;
     
+    const int depth = 100;
     auto recursive_func = [](auto& self, int depth, void* initial_sp) -> void {
         char buffer[100];  // Allocate on stack
+        buffer[0] = char(depth);
         
         if(depth == 0) {
             void* current_sp = &buffer;
             size_t stack_used = (char*)initial_sp - (char*)current_sp;
             cout << "  Stack used in recursion: " << stack_used << " bytes" << endl;
+            cout << "  Per frame: ~" << stack_used / 100
+                 << " bytes (buffer + saved registers + return address + alignment)" << endl;
             return;
         }
         
         self(self, depth - 1, initial_sp);
+        asm volatile("" : : "r"(buffer) : "memory");  // keep the frame (no tail call)
     };
     
     thread t([&recursive_func]() {
@@ -231,15 +510,219 @@ void show_actual_stack_usage() {
         void* initial_sp = &marker;
         cout << "Thread starting, stack pointer at: " << initial_sp << endl;
         
-        recursive_func(recursive_func, 100, initial_sp);
+        recursive_func(recursive_func, depth, initial_sp);
     });
     
     t.join();
-    
-    cout << "Each recursion used ~100 bytes (local variables + return address)" << endl;
 }
 
-int main() {
+// ============================================================================
+// STACK SIZING: explicit sizes, guard pages, high-water profiling
+// (thread_stack.h)
+// ============================================================================
+
+// Three thread functions with very different stack appetites.
+void shallow_worker() {
+    volatile int counter = 0;
+    for (int i = 0; i < 1000; i++) counter = counter + i;  // (+= on volatile is deprecated in C++20)
+}
+
+// Body of every thread in the parked fleet below: a little work, then block
+// in cv.wait until released. The wait (pthread_cond_wait -> futex) is part
+// of the stack the fleet needs, so this - not shallow_worker alone - is what
+// gets profiled.
+struct ParkingLot {
+    mutex m;
+    condition_variable cv;
+    bool release = false;
+    int parked = 0;
+
+    void wait_parked(int count) {
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&]() { return parked == count; });
+    }
+    void release_all() {
+        {
+            lock_guard<mutex> lock(m);
+            release = true;
+        }
+        cv.notify_all();
+    }
+};
+
+void fleet_worker(ParkingLot& lot) {
+    shallow_worker();
+    unique_lock<mutex> lock(lot.m);
+    lot.parked++;
+    lot.cv.notify_all();
+    lot.cv.wait(lock, [&]() { return lot.release; });
+}
+
+int parse_depth(int depth) {
+    char token[128];  // one frame per nesting level
+    snprintf(token, sizeof(token), "level-%d", depth);
+    int r = depth == 0 ? int(strlen(token)) : parse_depth(depth - 1) + token[0];
+    asm volatile("" : : "r"(token) : "memory");
+    return r;
+}
+
+void recursive_parser() { parse_depth(200); }
+
+void buffer_formatter() {
+    char line[16 * 1024];  // big local buffer: the classic stack hog
+    int n = 0;
+    for (int i = 0; i < 500; i++) n += snprintf(line + n, sizeof(line) - n, "%d,", i);
+    asm volatile("" : : "r"(line) : "memory");
+}
+
+void profile_thread_stacks() {
+    cout << "\n=== STACK HIGH-WATER PROFILER ===" << endl;
+    cout << "Each thread gets a painted 1MB stack; after join the untouched paint tells" << endl;
+    cout << "how deep the function really went.\n" << endl;
+
+    struct Job { const char* name; void (*fn)(); };
+    for (Job job : {Job{"shallow_worker", shallow_worker}, Job{"recursive_parser", recursive_parser},
+                    Job{"buffer_formatter", buffer_formatter}}) {
+        for (int run = 0; run < 3; run++) {
+            tstack::StackOptions opt;
+            opt.size = 1024 * 1024;
+            opt.paint = true;
+            opt.name = job.name;
+            tstack::Thread t(job.fn, opt);
+            t.join();
+        }
+    }
+    for (int run = 0; run < 3; run++) {  // the fleet body, parked then released
+        tstack::StackOptions opt;
+        opt.size = 1024 * 1024;
+        opt.paint = true;
+        opt.name = "fleet_worker";
+        ParkingLot lot;
+        tstack::Thread t([&lot]() { fleet_worker(lot); }, opt);
+        lot.wait_parked(1);
+        lot.release_all();
+        t.join();
+    }
+
+    // Same measurement on a 2MB-aligned huge-page stack (one TLB entry).
+    tstack::StackOptions huge;
+    huge.size = tstack::kHugePage;
+    huge.huge_pages = true;
+    huge.paint = true;
+    huge.name = "recursive_parser/2MB";
+    tstack::Thread(recursive_parser, huge).join();
+
+    tstack::profiler().print(cout);
+}
+
+struct FleetResult {
+    int started;
+    long vm_kb;   // virtual address space
+    long rss_kb;  // resident memory
+    long pte_kb;  // page tables
+};
+
+long status_kb(const char* key) {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f) return 0;
+    char line[256];
+    long kb = 0;
+    size_t len = strlen(key);
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, key, len) == 0) kb = atol(line + len);
+    }
+    fclose(f);
+    return kb;
+}
+
+// Starts `count` parked threads with the given stack options in a forked child
+// and reports how much the process grew while they were all alive.
+FleetResult measure_stack_fleet(int count, tstack::StackOptions opt) {
+    int fds[2];
+    if (pipe(fds) < 0) return {0, 0, 0, 0};
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        FleetResult before{0, status_kb("VmSize:"), status_kb("VmRSS:"), status_kb("VmPTE:")};
+        ParkingLot lot;
+        vector<tstack::Thread> threads;
+        threads.reserve(count);
+        for (int i = 0; i < count; i++) {
+            try {
+                threads.emplace_back([&lot]() { fleet_worker(lot); }, opt);
+            } catch (const exception&) {
+                break;  // out of threads / address space: report how far we got
+            }
+        }
+        lot.wait_parked(int(threads.size()));
+        FleetResult r{int(threads.size()), status_kb("VmSize:") - before.vm_kb,
+                      status_kb("VmRSS:") - before.rss_kb, status_kb("VmPTE:") - before.pte_kb};
+        lot.release_all();
+        for (auto& t : threads) t.join();
+        ssize_t w = write(fds[1], &r, sizeof(r));
+        _exit(w == sizeof(r) ? 0 : 1);
+    }
+    close(fds[1]);
+    FleetResult r{0, 0, 0, 0};
+    ssize_t n = read(fds[0], &r, sizeof(r));
+    (void)n;
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return r;
+}
+
+void compare_stack_fleets(int count) {
+    cout << "\n=== " << count << " PARKED THREADS: DEFAULT vs PROFILED STACK SIZE ===" << endl;
+
+    size_t recommended = tstack::profiler().recommend("fleet_worker");
+    struct Variant { string label; tstack::StackOptions opt; };
+    vector<Variant> variants(3);
+    variants[0].label = "default";
+    variants[1].label = "256 KB";
+    variants[1].opt.size = 256 * 1024;
+    variants[2].label = "profiled " + to_string(recommended / 1024) + " KB";
+    variants[2].opt.size = recommended;
+
+    cout << left << setw(18) << "stack" << right << setw(10) << "threads" << setw(16) << "virtual (MB)"
+         << setw(12) << "RSS (MB)" << setw(18) << "page tables (KB)" << endl;
+    vector<FleetResult> results;
+    for (auto& v : variants) {
+        FleetResult r = measure_stack_fleet(count, v.opt);
+        results.push_back(r);
+        cout << left << setw(18) << v.label << right << setw(10) << r.started << setw(16)
+             << r.vm_kb / 1024 << setw(12) << r.rss_kb / 1024 << setw(18) << r.pte_kb << endl;
+    }
+    if (results[0].started && results[2].started) {
+        double per_default = double(results[0].vm_kb) / results[0].started;
+        double per_profiled = double(results[2].vm_kb) / results[2].started;
+        cout << "\nSaved per " << count << " threads: " << fixed << setprecision(1)
+             << (per_default - per_profiled) * count / (1024 * 1024) << defaultfloat << " GB of address space, "
+             << (results[0].pte_kb - results[2].pte_kb) << " KB of page tables" << endl;
+    }
+    cout << "RSS barely moves: untouched stack pages are never faulted in. The cost of" << endl;
+    cout << "big stacks is address space, VMAs and page tables (and overcommit limits)." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    const int kMaxFleet = 1000000;
+    int fleet_threads = 10000;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string value = arg.rfind("--threads=", 0) == 0 ? arg.substr(10) : "";
+        size_t used = 0;
+        long n = 0;
+        try {
+            n = value.empty() || value[0] == '-' ? 0 : stol(value, &used);
+        } catch (const exception&) {
+        }
+        if (used == 0 || used != value.size() || n < 1 || n > kMaxFleet) {
+            cerr << "usage: " << argv[0] << " [--threads=1.." << kMaxFleet << "]" << endl;
+            return 2;
+        }
+        fleet_threads = int(n);
+    }
+    
     cout << "THREAD MEMORY LAYOUT - DEEP DIVE" << endl;
     cout << "===================================" << endl;
     
@@ -262,9 +745,17 @@ int main() {
     // Show thread-local storage
     demonstrate_tls();
     
+    // TLS applied: per-thread allocator caches
+    demonstrate_tls_allocator();
+    benchmark_tls_allocator();
+    
     // Show actual stack usage
     show_actual_stack_usage();
     
+    // Size stacks from measurements instead of the 8MB default
+    profile_thread_stacks();
+    compare_stack_fleets(fleet_threads);
+    
     cout << "\n=== SUMMARY: THREAD MEMORY MODEL ===" << endl;
     cout << "┌─────────────────────────────────────────────┐" << endl;
     cout << "│ SHARED (All threads see same memory):      │" << endl;
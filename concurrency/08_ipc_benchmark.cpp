@@ -0,0 +1,622 @@
+/**
+ * Part 8: Measured IPC & Process-Creation Benchmark Suite
+ *
+ * WHY THIS FILE EXISTS:
+ * =====================
+ * 01_process_vs_thread.cpp and 02_ipc_internals.cpp explain the mechanisms.
+ * This file MEASURES them on the machine you run it on, instead of quoting
+ * rule-of-thumb numbers. Results depend heavily on:
+ *   - CPU count (1 CPU: every hand-off between processes is a context switch)
+ *   - kernel version / mitigations (syscall entry cost)
+ *   - parent RSS for fork() (page tables are copied, pages are COW-marked)
+ *
+ * TRANSPORTS (all bidirectional, parent <-> forked child):
+ * =========================================================
+ *   pipe        : two pipe(2)s, byte stream, 1 syscall per send/recv
+ *   socketpair  : AF_UNIX SOCK_STREAM, byte stream
+ *   unix_dgram  : AF_UNIX SOCK_DGRAM, message boundaries preserved
+ *   eventfd     : shared-memory slot ring + two EFD_SEMAPHORE eventfd doorbells
+ *                 (payload never crosses the kernel, only the counter does)
+ *   futex_shm   : shm::ShmRing (shm_ring.h) - syscalls only on empty/full
+ *   posix_mq    : mq_send/mq_receive (size capped by fs.mqueue.msgsize_max)
+ *
+ * MEASUREMENTS:
+ * =============
+ *   ipc_latency    : ping-pong round trip per message size: percentiles plus
+ *                    a log2 histogram (bucket k = [2^k, 2^(k+1)) ns)
+ *   ipc_throughput : one-way stream, messages/sec and MB/s
+ *   spawn          : thread create+join, fork+_exit+wait, vfork+_exit+wait,
+ *                    posix_spawn(/bin/true), fork+exec(/bin/true); each with
+ *                    a small parent and with a large (dirty heap) parent
+ *
+ * OUTPUT (for regression tracking):
+ * =================================
+ *   ./program                 human-readable table
+ *   ./program --format=csv    one row per measurement
+ *   ./program --format=json   array of objects
+ *   ./program --quick         fewer iterations (CI smoke run)
+ *
+ * Build: make FILE=08_ipc_benchmark.cpp run
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <mqueue.h>
+#include <spawn.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "shm_ring.h"
+
+using namespace std;
+
+extern char** environ;
+
+// ==================================================================
+// Results + histogram
+// ==================================================================
+
+struct Result {
+    string category;   // ipc_latency | ipc_throughput | spawn
+    string name;       // transport or spawn method
+    string variant;    // message size or parent size
+    size_t iterations = 0;
+    // latency stats (ns); zero for throughput rows
+    double mean_ns = 0, p50_ns = 0, p90_ns = 0, p99_ns = 0, p999_ns = 0, max_ns = 0;
+    // latency histogram: hist[k] = samples in [2^k, 2^(k+1)) ns, up to the max
+    vector<uint64_t> hist{};
+    // throughput stats; zero for latency rows
+    double msgs_per_sec = 0, mb_per_sec = 0;
+};
+
+// Exact percentiles: keep every sample, sort once (iterations are bounded).
+static Result summarize(string category, string name, string variant, vector<uint64_t>& samples) {
+    Result r{move(category), move(name), move(variant), samples.size()};
+    if (samples.empty()) return r;
+    sort(samples.begin(), samples.end());
+    auto pct = [&](double p) { return double(samples[min(samples.size() - 1, size_t(p * samples.size()))]); };
+    double sum = 0;
+    for (auto s : samples) sum += double(s);
+    r.mean_ns = sum / samples.size();
+    r.p50_ns = pct(0.50);
+    r.p90_ns = pct(0.90);
+    r.p99_ns = pct(0.99);
+    r.p999_ns = pct(0.999);
+    r.max_ns = double(samples.back());
+    for (auto s : samples) {
+        size_t k = s ? size_t(63 - __builtin_clzll(s)) : 0;
+        if (r.hist.size() <= k) r.hist.resize(k + 1);
+        r.hist[k]++;
+    }
+    return r;
+}
+
+// Bucket lower bounds for display: 1024 -> "1.0us", 65536 -> "65.5us"
+static string short_ns(uint64_t ns) {
+    char buf[32];
+    if (ns >= 1000000) snprintf(buf, sizeof(buf), "%.1fms", ns / 1e6);
+    else if (ns >= 1000) snprintf(buf, sizeof(buf), "%.1fus", ns / 1e3);
+    else snprintf(buf, sizeof(buf), "%lluns", (unsigned long long)ns);
+    return buf;
+}
+
+static uint64_t now_ns() {
+    return uint64_t(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ==================================================================
+// Transports: one Channel = two Endpoints created BEFORE fork
+// ==================================================================
+
+// Messages have a fixed size per run, known to both sides.
+class Endpoint {
+public:
+    virtual ~Endpoint() = default;
+    virtual bool send(const char* buf, size_t n) = 0;
+    virtual bool recv(char* buf, size_t n) = 0;
+};
+
+struct Channel {
+    unique_ptr<Endpoint> parent, child;
+};
+
+static bool write_full(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w <= 0) return false;
+        p += w;
+        n -= size_t(w);
+    }
+    return true;
+}
+
+static bool read_full(int fd, char* p, size_t n) {
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r <= 0) return false;
+        p += r;
+        n -= size_t(r);
+    }
+    return true;
+}
+
+// Byte-stream endpoint: pipe pair or stream socket (rfd may equal wfd).
+class StreamEndpoint : public Endpoint {
+    int rfd_, wfd_;
+public:
+    StreamEndpoint(int rfd, int wfd) : rfd_(rfd), wfd_(wfd) {}
+    ~StreamEndpoint() override {
+        close(rfd_);
+        if (wfd_ != rfd_) close(wfd_);
+    }
+    bool send(const char* buf, size_t n) override { return write_full(wfd_, buf, n); }
+    bool recv(char* buf, size_t n) override { return read_full(rfd_, buf, n); }
+};
+
+class DatagramEndpoint : public Endpoint {
+    int fd_;
+public:
+    explicit DatagramEndpoint(int fd) : fd_(fd) {}
+    ~DatagramEndpoint() override { close(fd_); }
+    bool send(const char* buf, size_t n) override { return ::send(fd_, buf, n, 0) == ssize_t(n); }
+    bool recv(char* buf, size_t n) override { return ::recv(fd_, buf, n, 0) == ssize_t(n); }
+};
+
+// One MAP_SHARED region. Both endpoints of a channel hold it (like the
+// shared_ptr<ShmRing>s below), so each process unmaps it once, when its last
+// endpoint goes away - the child can drop the parent's endpoint safely.
+struct SharedSlots {
+    char* base = nullptr;
+    size_t bytes;
+    explicit SharedSlots(size_t n) : bytes(n) {
+        void* mem = mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mem != MAP_FAILED) base = static_cast<char*>(mem);
+    }
+    ~SharedSlots() {
+        if (base) munmap(base, bytes);
+    }
+    SharedSlots(const SharedSlots&) = delete;
+    SharedSlots& operator=(const SharedSlots&) = delete;
+};
+
+// eventfd as a doorbell: payload goes through a shared slot ring, the kernel
+// only counts "slots filled" and "slots free" (EFD_SEMAPHORE: read() takes 1).
+class EventfdEndpoint : public Endpoint {
+public:
+    static constexpr size_t kSlots = 16;
+    struct Direction {
+        shared_ptr<SharedSlots> slots; // kSlots * slot_size bytes
+        int data_efd;                  // counts filled slots
+        int space_efd;                 // counts free slots (starts at kSlots)
+    };
+private:
+    Direction out_, in_;
+    size_t slot_size_;
+    uint64_t sent_ = 0, received_ = 0;
+public:
+    EventfdEndpoint(Direction out, Direction in, size_t slot_size) : out_(out), in_(in), slot_size_(slot_size) {}
+    ~EventfdEndpoint() override {
+        for (int fd : {out_.data_efd, out_.space_efd, in_.data_efd, in_.space_efd}) close(fd);
+    }
+    bool send(const char* buf, size_t n) override {
+        uint64_t one = 1;
+        if (read(out_.space_efd, &one, 8) != 8) return false;        // wait for a free slot
+        memcpy(out_.slots->base + (sent_++ % kSlots) * slot_size_, buf, n);
+        one = 1;
+        return write(out_.data_efd, &one, 8) == 8;                    // ring the doorbell
+    }
+    bool recv(char* buf, size_t n) override {
+        uint64_t one = 1;
+        if (read(in_.data_efd, &one, 8) != 8) return false;
+        memcpy(buf, in_.slots->base + (received_++ % kSlots) * slot_size_, n);
+        one = 1;
+        return write(in_.space_efd, &one, 8) == 8;
+    }
+};
+
+class ShmRingEndpoint : public Endpoint {
+    shared_ptr<shm::ShmRing> out_, in_;
+    bool registered_ = false;
+public:
+    ShmRingEndpoint(shared_ptr<shm::ShmRing> out, shared_ptr<shm::ShmRing> in) : out_(move(out)), in_(move(in)) {}
+    void register_self() {
+        if (registered_) return;
+        out_->register_producer();
+        in_->register_consumer();
+        registered_ = true;
+    }
+    bool send(const char* buf, size_t n) override {
+        register_self();
+        return out_->send(buf, uint32_t(n)) == shm::Status::Ok;
+    }
+    bool recv(char* buf, size_t n) override {
+        register_self();
+        return in_->consume([&](const char* p, uint32_t len) { memcpy(buf, p, min<size_t>(n, len)); }) ==
+               shm::Status::Ok;
+    }
+};
+
+class MqEndpoint : public Endpoint {
+    mqd_t out_, in_;
+public:
+    MqEndpoint(mqd_t out, mqd_t in) : out_(out), in_(in) {}
+    ~MqEndpoint() override {
+        mq_close(out_);
+        mq_close(in_);
+    }
+    bool send(const char* buf, size_t n) override { return mq_send(out_, buf, n, 0) == 0; }
+    bool recv(char* buf, size_t n) override { return mq_receive(in_, buf, n, nullptr) == ssize_t(n); }
+};
+
+struct Transport {
+    string name;
+    function<bool(size_t msg_size, Channel& ch)> make; // false = unsupported size
+};
+
+static size_t mq_msgsize_max() {
+    FILE* f = fopen("/proc/sys/fs/mqueue/msgsize_max", "r");
+    long v = 8192;
+    if (f) {
+        if (fscanf(f, "%ld", &v) != 1) v = 8192;
+        fclose(f);
+    }
+    return size_t(v);
+}
+
+static vector<Transport> all_transports() {
+    vector<Transport> t;
+
+    t.push_back({"pipe", [](size_t, Channel& ch) {
+        int a[2], b[2];  // a: parent->child, b: child->parent
+        if (pipe(a) != 0 || pipe(b) != 0) return false;
+        ch.parent = make_unique<StreamEndpoint>(b[0], a[1]);
+        ch.child = make_unique<StreamEndpoint>(a[0], b[1]);
+        return true;
+    }});
+
+    t.push_back({"socketpair", [](size_t, Channel& ch) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) return false;
+        ch.parent = make_unique<StreamEndpoint>(sv[0], sv[0]);
+        ch.child = make_unique<StreamEndpoint>(sv[1], sv[1]);
+        return true;
+    }});
+
+    t.push_back({"unix_dgram", [](size_t size, Channel& ch) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_DGRAM, 0, sv) != 0) return false;
+        int buf = int(max<size_t>(size * 8, 1 << 16));
+        for (int fd : sv) {
+            setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buf, sizeof(buf));
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buf, sizeof(buf));
+        }
+        ch.parent = make_unique<DatagramEndpoint>(sv[0]);
+        ch.child = make_unique<DatagramEndpoint>(sv[1]);
+        return true;
+    }});
+
+    t.push_back({"eventfd", [](size_t size, Channel& ch) {
+        using Dir = EventfdEndpoint::Direction;
+        const size_t bytes = EventfdEndpoint::kSlots * size;
+        auto make_dir = [&](Dir& d) {
+            d.slots = make_shared<SharedSlots>(bytes);
+            d.data_efd = eventfd(0, EFD_SEMAPHORE);
+            d.space_efd = eventfd(EventfdEndpoint::kSlots, EFD_SEMAPHORE);
+            return d.slots->base && d.data_efd >= 0 && d.space_efd >= 0;
+        };
+        auto close_dir = [](const Dir& d) {
+            for (int fd : {d.data_efd, d.space_efd}) if (fd >= 0) close(fd);
+        };
+        Dir to_child{nullptr, -1, -1}, to_parent{nullptr, -1, -1};
+        if (!make_dir(to_child) || !make_dir(to_parent)) {
+            close_dir(to_child);
+            close_dir(to_parent);
+            return false;  // mappings are released with the last shared_ptr
+        }
+        // Each side closes its own copies of the fds; dup so both own a set.
+        auto dup_dir = [](const Dir& d) { return Dir{d.slots, dup(d.data_efd), dup(d.space_efd)}; };
+        ch.parent = make_unique<EventfdEndpoint>(to_child, to_parent, size);
+        ch.child = make_unique<EventfdEndpoint>(dup_dir(to_parent), dup_dir(to_child), size);
+        return true;
+    }});
+
+    t.push_back({"futex_shm", [](size_t size, Channel& ch) {
+        size_t cap = max<size_t>(size * 32, 1 << 16);
+        auto to_child = make_shared<shm::ShmRing>(shm::ShmRing::create(cap, false));
+        auto to_parent = make_shared<shm::ShmRing>(shm::ShmRing::create(cap, false));
+        ch.parent = make_unique<ShmRingEndpoint>(to_child, to_parent);
+        ch.child = make_unique<ShmRingEndpoint>(to_parent, to_child);
+        return true;
+    }});
+
+    t.push_back({"posix_mq", [](size_t size, Channel& ch) {
+        if (size > mq_msgsize_max()) return false;
+        string base = "/ipcbench_" + to_string(getpid()) + "_" + to_string(size);
+        mq_attr attr{};
+        attr.mq_maxmsg = 10;  // default fs.mqueue.msg_max
+        attr.mq_msgsize = long(size);
+        string a = base + "_a", b = base + "_b";
+        mqd_t qa = mq_open(a.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600, &attr);
+        mqd_t qb = mq_open(b.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600, &attr);
+        // Separate descriptors per side, so each endpoint can close its own
+        mqd_t qa2 = mq_open(a.c_str(), O_RDWR);
+        mqd_t qb2 = mq_open(b.c_str(), O_RDWR);
+        mq_unlink(a.c_str());  // names gone; descriptors survive fork
+        mq_unlink(b.c_str());
+        if (qa == mqd_t(-1) || qb == mqd_t(-1) || qa2 == mqd_t(-1) || qb2 == mqd_t(-1)) return false;
+        ch.parent = make_unique<MqEndpoint>(qa, qb);
+        ch.child = make_unique<MqEndpoint>(qb2, qa2);
+        return true;
+    }});
+
+    return t;
+}
+
+// ==================================================================
+// IPC runs
+// ==================================================================
+
+// Forks a child that runs `child_fn(endpoint)` and returns the pid.
+static pid_t fork_child(Channel& ch, const function<void(Endpoint&)>& child_fn) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        ch.parent.reset();  // drop parent's copies (closes fds in the child)
+        child_fn(*ch.child);
+        ch.child.reset();
+        _exit(0);
+    }
+    ch.child.reset();
+    return pid;
+}
+
+static bool run_latency(const Transport& t, size_t size, size_t rounds, Result& out) {
+    Channel ch;
+    if (!t.make(size, ch)) return false;
+    pid_t pid = fork_child(ch, [&](Endpoint& ep) {
+        vector<char> buf(size);
+        for (size_t i = 0; i < rounds; i++) {
+            if (!ep.recv(buf.data(), size) || !ep.send(buf.data(), size)) return;
+        }
+    });
+    vector<char> buf(size, 'p');
+    vector<uint64_t> samples;
+    samples.reserve(rounds);
+    for (size_t i = 0; i < rounds; i++) {
+        uint64_t t0 = now_ns();
+        if (!ch.parent->send(buf.data(), size) || !ch.parent->recv(buf.data(), size)) break;
+        samples.push_back(now_ns() - t0);
+    }
+    ch.parent.reset();
+    waitpid(pid, nullptr, 0);
+    if (samples.empty()) return false;  // transport refused this size at runtime
+    out = summarize("ipc_latency", t.name, to_string(size), samples);
+    return true;
+}
+
+static bool run_throughput(const Transport& t, size_t size, size_t count, Result& out) {
+    Channel ch;
+    if (!t.make(size, ch)) return false;
+    pid_t pid = fork_child(ch, [&](Endpoint& ep) {
+        vector<char> buf(size);
+        for (size_t i = 0; i < count; i++) {
+            if (!ep.recv(buf.data(), size)) return;
+        }
+        ep.send(buf.data(), size);  // ack: everything arrived
+    });
+    vector<char> buf(size, 't');
+    uint64_t t0 = now_ns();
+    size_t sent = 0;
+    while (sent < count && ch.parent->send(buf.data(), size)) sent++;
+    bool acked = ch.parent->recv(buf.data(), size);
+    double secs = double(now_ns() - t0) / 1e9;
+    ch.parent.reset();
+    waitpid(pid, nullptr, 0);
+    if (!acked || sent == 0) return false;
+    out = Result{"ipc_throughput", t.name, to_string(size), sent};
+    out.msgs_per_sec = sent / secs;
+    out.mb_per_sec = sent * double(size) / secs / (1024 * 1024);
+    return true;
+}
+
+// ==================================================================
+// Spawn runs
+// ==================================================================
+
+static vector<uint64_t> time_n(size_t n, const function<void()>& fn) {
+    vector<uint64_t> samples;
+    samples.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t t0 = now_ns();
+        fn();
+        samples.push_back(now_ns() - t0);
+    }
+    return samples;
+}
+
+static void run_spawn_suite(size_t n, const string& parent_label, vector<Result>& results) {
+    auto add = [&](const string& name, vector<uint64_t> s) {
+        results.push_back(summarize("spawn", name, parent_label, s));
+    };
+
+    add("thread", time_n(n, [] { thread([] {}).join(); }));
+
+    add("fork", time_n(n, [] {
+        pid_t pid = fork();
+        if (pid == 0) _exit(0);
+        waitpid(pid, nullptr, 0);
+    }));
+
+    // vfork: child borrows the parent's address space (no page-table copy);
+    // parent is suspended until the child calls _exit or exec.
+    add("vfork", time_n(n, [] {
+        pid_t pid = vfork();
+        if (pid == 0) _exit(0);
+        waitpid(pid, nullptr, 0);
+    }));
+
+    add("posix_spawn", time_n(n, [] {
+        pid_t pid;
+        char* argv[] = {const_cast<char*>("true"), nullptr};
+        if (posix_spawn(&pid, "/bin/true", nullptr, nullptr, argv, environ) == 0) waitpid(pid, nullptr, 0);
+    }));
+
+    add("fork+exec", time_n(n, [] {
+        pid_t pid = fork();
+        if (pid == 0) {
+            execl("/bin/true", "true", (char*)nullptr);
+            _exit(127);
+        }
+        waitpid(pid, nullptr, 0);
+    }));
+}
+
+// ==================================================================
+// Output
+// ==================================================================
+
+static void print_table(const vector<Result>& results) {
+    string category;
+    for (const auto& r : results) {
+        if (r.category != category) {
+            category = r.category;
+            cout << "\n=== " << category << " ===\n";
+            if (category == "ipc_throughput") {
+                cout << left << setw(12) << "name" << setw(10) << "bytes" << right
+                     << setw(14) << "msgs/s" << setw(12) << "MB/s" << "\n";
+            } else {
+                cout << left << setw(12) << "name" << setw(10) << (category == "spawn" ? "parent" : "bytes")
+                     << right << setw(10) << "p50 us" << setw(10) << "p90 us" << setw(10) << "p99 us"
+                     << setw(10) << "p99.9 us" << setw(10) << "max us" << "\n";
+            }
+        }
+        cout << left << setw(12) << r.name << setw(10) << r.variant << right << fixed;
+        if (r.category == "ipc_throughput") {
+            cout << setprecision(0) << setw(14) << r.msgs_per_sec << setprecision(1) << setw(12) << r.mb_per_sec;
+        } else {
+            cout << setprecision(2);
+            for (double v : {r.p50_ns, r.p90_ns, r.p99_ns, r.p999_ns, r.max_ns}) cout << setw(10) << v / 1000;
+        }
+        cout << "\n" << defaultfloat;
+        if (!r.hist.empty()) {  // bucket lower bound: count, first to last non-empty
+            size_t k = 0;
+            while (r.hist[k] == 0) k++;
+            cout << "    hist";
+            for (; k < r.hist.size(); k++) cout << ' ' << short_ns(uint64_t(1) << k) << ':' << r.hist[k];
+            cout << "\n";
+        }
+    }
+}
+
+static void print_csv(const vector<Result>& results) {
+    cout << "category,name,variant,iterations,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,msgs_per_sec,mb_per_sec,"
+            "hist_log2_ns\n";
+    for (const auto& r : results) {
+        cout << r.category << ',' << r.name << ',' << r.variant << ',' << r.iterations << ','
+             << r.mean_ns << ',' << r.p50_ns << ',' << r.p90_ns << ',' << r.p99_ns << ','
+             << r.p999_ns << ',' << r.max_ns << ',' << r.msgs_per_sec << ',' << r.mb_per_sec << ',';
+        // "lower_ns:count" pairs for the non-empty buckets, space separated
+        const char* sep = "";
+        for (size_t k = 0; k < r.hist.size(); k++) {
+            if (r.hist[k]) {
+                cout << sep << (uint64_t(1) << k) << ':' << r.hist[k];
+                sep = " ";
+            }
+        }
+        cout << '\n';
+    }
+}
+
+static void print_json(const vector<Result>& results) {
+    cout << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        cout << "  {\"category\": \"" << r.category << "\", \"name\": \"" << r.name
+             << "\", \"variant\": \"" << r.variant << "\", \"iterations\": " << r.iterations
+             << ", \"mean_ns\": " << r.mean_ns << ", \"p50_ns\": " << r.p50_ns
+             << ", \"p90_ns\": " << r.p90_ns << ", \"p99_ns\": " << r.p99_ns
+             << ", \"p999_ns\": " << r.p999_ns << ", \"max_ns\": " << r.max_ns
+             << ", \"msgs_per_sec\": " << r.msgs_per_sec << ", \"mb_per_sec\": " << r.mb_per_sec
+             << ", \"hist_log2_ns\": [";
+        const char* sep = "";
+        for (size_t k = 0; k < r.hist.size(); k++) {
+            if (r.hist[k]) {
+                cout << sep << '[' << (uint64_t(1) << k) << ", " << r.hist[k] << ']';
+                sep = ", ";
+            }
+        }
+        cout << "]}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    cout << "]\n";
+}
+
+int main(int argc, char** argv) {
+    string format = "table";
+    bool quick = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--format=", 0) == 0) format = arg.substr(9);
+        else if (arg == "--quick") quick = true;
+        else {
+            cerr << "usage: " << argv[0] << " [--format=table|csv|json] [--quick]\n";
+            return 2;
+        }
+    }
+
+    const vector<size_t> sizes = {64, 1024, 8192, 65536};
+    const size_t rounds = quick ? 2000 : 20000;
+    const size_t stream_bytes = quick ? (16u << 20) : (128u << 20);
+    const size_t spawn_n = quick ? 100 : 500;
+
+    if (format == "table") {
+        cout << "IPC & PROCESS-CREATION BENCHMARK (" << thread::hardware_concurrency()
+             << " CPU(s), " << (quick ? "quick" : "full") << " run)\n";
+    }
+
+    vector<Result> results;
+    auto transports = all_transports();
+    for (const auto& t : transports) {
+        for (size_t size : sizes) {
+            Result r;
+            if (run_latency(t, size, rounds, r)) results.push_back(r);
+        }
+    }
+    for (const auto& t : transports) {
+        for (size_t size : sizes) {
+            Result r;
+            size_t count = max<size_t>(1000, stream_bytes / size);
+            if (run_throughput(t, size, count, r)) results.push_back(r);
+        }
+    }
+
+    run_spawn_suite(spawn_n, "small", results);
+    {
+        // fork() cost grows with the parent's mapped+dirty memory (page-table
+        // copy + COW marking); vfork/posix_spawn should stay flat.
+        const size_t big = 256u << 20;
+        vector<char> ballast(big);
+        for (size_t i = 0; i < big; i += 4096) ballast[i] = 1;  // fault every page in
+        run_spawn_suite(spawn_n / 5, "256MB", results);
+    }
+
+    if (format == "csv") print_csv(results);
+    else if (format == "json") print_json(results);
+    else print_table(results);
+    return 0;
+}
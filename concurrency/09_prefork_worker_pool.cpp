@@ -0,0 +1,278 @@
+/**
+ * Part 9: Prefork Worker Pool (processes + shared-memory task queue)
+ *
+ * WHY:
+ * ====
+ * 07_process_create_basics.cpp forks ONE child per job and waits. That gives
+ * isolation (a segfault kills only the child) but pays fork() + exit + wait
+ * for every task - and fork() gets slower as the parent grows (page tables
+ * are copied). Threads are cheap but a crash in one kills the whole process.
+ *
+ * A prefork pool keeps the isolation and drops the per-task fork():
+ *
+ *   supervisor ──submit()──> pending deque ──dispatch──> Lane[i] (shared mem)
+ *        ^                                                   │
+ *        └──── next_result() <── Done slots <── worker i ────┘
+ *                 │
+ *                 └── waitpid(WNOHANG): crashed? report task, respawn lane
+ *
+ * See prefork_pool.h for the slot state machine and crash handling.
+ *
+ * THIS FILE:
+ * ==========
+ *   1. Demo: 200 tasks, 3 of them poison (SIGSEGV, abort(), exit(3)),
+ *      workers recycled every 25 tasks - every good task still completes.
+ *   2. Benchmark: tasks/sec for light and heavy CPU tasks with
+ *        prefork pool | fork-per-task (same parallelism) | thread pool
+ *      ./program --ballast-mb=256   dirties 256MB first to show how
+ *                                   fork-per-task degrades with parent size
+ *
+ * Build: make FILE=09_prefork_worker_pool.cpp run
+ */
+
+#include "prefork_pool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// ============================================================================
+// Workload: "iterations seed" -> hash as decimal text
+// ============================================================================
+
+uint64_t burn(uint64_t iterations, uint64_t seed) {
+    uint64_t x = seed | 1;
+    for (uint64_t i = 0; i < iterations; i++) { // xorshift64: pure ALU work
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+string make_task(uint64_t iterations, uint64_t seed) {
+    return to_string(iterations) + " " + to_string(seed);
+}
+
+string run_task(string_view task) {
+    if (task == "crash:segv") raise(SIGSEGV);
+    if (task == "crash:abort") abort();
+    if (task == "crash:exit") exit(3);
+    string s(task);
+    size_t space = s.find(' ');
+    uint64_t iterations = stoull(s.substr(0, space));
+    uint64_t seed = stoull(s.substr(space + 1));
+    return to_string(burn(iterations, seed));
+}
+
+// ============================================================================
+// 1. Demo: crashes and recycling
+// ============================================================================
+
+void demonstrate_supervision() {
+    cout << "\n=== PREFORK POOL: CRASH ISOLATION + RECYCLING ===" << endl;
+
+    prefork::PoolOptions opt;
+    opt.workers = 2;
+    opt.recycle_after = 25;
+    prefork::WorkerPool pool(run_task, opt);
+
+    vector<uint64_t> poison;
+    for (int i = 0; i < 200; i++) {
+        if (i == 50) poison.push_back(pool.submit("crash:segv"));
+        else if (i == 100) poison.push_back(pool.submit("crash:abort"));
+        else if (i == 150) poison.push_back(pool.submit("crash:exit"));
+        else pool.submit(make_task(20000, i));
+    }
+
+    prefork::TaskResult r;
+    int ok = 0;
+    while (pool.next_result(r)) {
+        if (r.status == prefork::TaskStatus::Ok) {
+            ok++;
+        } else {
+            cout << "task " << r.id << ": " << prefork::to_string(r.status);
+            if (r.signal) cout << " (signal " << r.signal << ": " << strsignal(r.signal) << ")";
+            cout << endl;
+        }
+    }
+
+    const prefork::PoolStats& st = pool.stats();
+    cout << "completed ok: " << ok << " / " << st.submitted - poison.size() << " good tasks" << endl;
+    cout << "crashed: " << st.crashed << ", recycled: " << st.recycled
+         << ", forks: " << st.spawned << " (2 initial + respawns)" << endl;
+}
+
+// ============================================================================
+// 2. Benchmark
+// ============================================================================
+
+double run_prefork(int workers, const vector<string>& tasks) {
+    prefork::PoolOptions opt;
+    opt.workers = workers;
+    prefork::WorkerPool pool(run_task, opt); // prefork cost is NOT timed: paid once
+
+    auto start = chrono::steady_clock::now();
+    for (const string& t : tasks) pool.submit(t);
+    prefork::TaskResult r;
+    size_t done = 0;
+    while (pool.next_result(r)) done++;
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return done / secs;
+}
+
+// One fork() per task, at most `workers` children alive; the result comes
+// back through a pipe (small, so the child's write never blocks). A task
+// whose fork() fails (EAGAIN/ENOMEM) counts as failed, not as done.
+double run_fork_per_task(int workers, const vector<string>& tasks) {
+    struct Child { pid_t pid; int fd; };
+    vector<Child> alive;
+    size_t next = 0, done = 0, failed = 0;
+
+    auto start = chrono::steady_clock::now();
+    while (done < tasks.size()) {
+        while (next < tasks.size() && alive.size() < size_t(workers)) {
+            int fds[2];
+            if (pipe(fds) < 0) return 0;
+            cout.flush();
+            pid_t pid = fork();
+            if (pid < 0) {
+                close(fds[0]);
+                close(fds[1]);
+                failed++;
+                next++;
+                continue;
+            }
+            if (pid == 0) {
+                close(fds[0]);
+                string out = run_task(tasks[next]);
+                ssize_t w = write(fds[1], out.data(), out.size());
+                _exit(w < 0 ? 1 : 0);
+            }
+            close(fds[1]);
+            alive.push_back({pid, fds[0]});
+            next++;
+        }
+        if (alive.empty()) break; // every remaining task failed to fork
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        for (size_t i = 0; i < alive.size(); i++) {
+            if (alive[i].pid != pid) continue;
+            char buf[64];
+            ssize_t n = read(alive[i].fd, buf, sizeof(buf));
+            (void)n;
+            close(alive[i].fd);
+            alive.erase(alive.begin() + i);
+            done++;
+            break;
+        }
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (failed > 0) cerr << "fork-per-task: fork() failed for " << failed << " task(s)" << endl;
+    return done / secs;
+}
+
+// Classic mutex + condition_variable pool: fastest hand-off, no isolation.
+double run_thread_pool(int workers, const vector<string>& tasks) {
+    mutex m;
+    condition_variable cv;
+    queue<const string*> q;
+    bool closing = false;
+    vector<string> results(tasks.size());
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int i = 0; i < workers; i++) {
+        pool.emplace_back([&]() {
+            for (;;) {
+                unique_lock<mutex> lock(m);
+                cv.wait(lock, [&]() { return closing || !q.empty(); });
+                if (q.empty()) return;
+                const string* t = q.front();
+                q.pop();
+                lock.unlock();
+                results[t - tasks.data()] = run_task(*t);
+            }
+        });
+    }
+    {
+        lock_guard<mutex> lock(m);
+        for (const string& t : tasks) q.push(&t);
+        closing = true;
+    }
+    cv.notify_all();
+    for (thread& t : pool) t.join();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return tasks.size() / secs;
+}
+
+void benchmark_pools(size_t ballast_mb) {
+    vector<char> ballast(ballast_mb << 20, 1); // dirty pages: fork must copy their page tables
+    volatile char keep = ballast.empty() ? 0 : ballast.back();
+    (void)keep;
+    int workers = int(thread::hardware_concurrency());
+    if (workers <= 0) workers = 1;
+
+    cout << "\n=== TASKS/SEC: " << workers << " worker(s), parent ballast "
+         << ballast_mb << " MB ===" << endl;
+    cout << left << setw(22) << "task size" << right << setw(10) << "tasks"
+         << setw(14) << "prefork" << setw(16) << "fork-per-task" << setw(14) << "threads" << endl;
+
+    struct Load { const char* name; uint64_t iterations; size_t count; };
+    for (Load load : {Load{"light (~2 us)", 2000, 4000}, Load{"heavy (~1 ms)", 500000, 400}}) {
+        vector<string> tasks;
+        for (size_t i = 0; i < load.count; i++) tasks.push_back(make_task(load.iterations, i + 1));
+
+        cout << left << setw(22) << load.name << right << setw(10) << load.count << fixed
+             << setprecision(0) << setw(14) << run_prefork(workers, tasks)
+             << setw(16) << run_fork_per_task(workers, tasks)
+             << setw(14) << run_thread_pool(workers, tasks) << defaultfloat << endl;
+    }
+    cout << "\nprefork pays fork() once per worker; per task it costs two shared-memory\n"
+         << "slot hand-offs (plus a futex wake if the other side sleeps). fork-per-task\n"
+         << "pays fork + exit + waitpid every time, so light tasks are dominated by it." << endl;
+}
+
+// Whole argument as a number in 0..max; false if it is not one
+bool parse_number(const string& text, size_t max, size_t& value) {
+    try {
+        size_t used = 0;
+        unsigned long long v = stoull(text, &used);
+        if (used != text.size() || text[0] == '-' || v > max) return false;
+        value = size_t(v);
+        return true;
+    } catch (const exception&) {
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t kMaxBallastMb = 65536;
+    size_t ballast_mb = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--ballast-mb=", 0) != 0 || !parse_number(arg.substr(13), kMaxBallastMb, ballast_mb)) {
+            cerr << "usage: " << argv[0] << " [--ballast-mb=0.." << kMaxBallastMb << "]" << endl;
+            return 2;
+        }
+    }
+
+    demonstrate_supervision();
+    benchmark_pools(ballast_mb);
+    return 0;
+}
@@ -0,0 +1,383 @@
+/**
+ * Part 10: Coroutine Runtime vs Threads
+ *
+ * WHY:
+ * ====
+ * A thread that waits (sleep_for, cv.wait) keeps its stack and kernel task
+ * and costs a futex + context switch to wake. coro_runtime.h runs many
+ * LOGICAL workers (coroutines) on a few OS threads: a waiting coroutine is a
+ * small heap frame; waking it is a queue push and an indirect call.
+ *
+ * THIS FILE:
+ * ==========
+ *   1. Demo: a timer, epoll fd readiness (pipe), a coro::Mutex shared by
+ *      coroutines running on 2 worker threads, and a Channel pipeline.
+ *   2. Capacity: park N workers on a gate, measure spawn time, RSS and
+ *      virtual memory per worker, then wake them all
+ *        coroutines: --workers=N   (default 100000)
+ *        threads:    --threads=N   (default 10000, std::thread defaults)
+ *      each measurement runs in a forked child so they cannot pollute each other
+ *   3. Switch cost: ping-pong hand-offs through a semaphore pair
+ *        threads (mutex + condition_variable, like ../synchronization)
+ *        coroutines on 1 worker thread / on several worker threads
+ *        plus a bare co_await yield() (one trip through the run queue)
+ *
+ * Build: make STD=c++20 FILE=10_coroutine_runtime.cpp run
+ */
+
+#include "coro_runtime.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// ============================================================================
+// 1. Demo
+// ============================================================================
+
+coro::task<int> read_after_ready(coro::Runtime& rt, int fd) {
+    co_await rt.readable(fd); // the worker thread is free while we wait
+    int value = 0;
+    ssize_t n = read(fd, &value, sizeof(value));
+    co_return n == sizeof(value) ? value : -1;
+}
+
+coro::task<void> write_later(coro::Runtime& rt, int fd) {
+    co_await rt.sleep_for(chrono::milliseconds(50));
+    int value = 42;
+    ssize_t n = write(fd, &value, sizeof(value));
+    (void)n;
+}
+
+coro::task<void> add_under_lock(coro::Mutex& mu, long& counter, int times) {
+    for (int i = 0; i < times; i++) {
+        auto guard = co_await mu.scoped_lock();
+        counter++; // plain long: the coro::Mutex is the only protection
+    }
+}
+
+coro::task<void> square_stage(coro::Channel<int>& in, coro::Channel<int>& out) {
+    while (optional<int> v = co_await in.recv()) co_await out.send(*v * *v);
+    out.close();
+}
+
+coro::task<void> demo(coro::Runtime& rt) {
+    // Timer + reactor: one coroutine waits on a pipe, another writes after 50ms.
+    int fds[2];
+    if (pipe(fds) < 0) co_return;
+    auto start = chrono::steady_clock::now();
+    rt.spawn(write_later(rt, fds[1]));
+    int got = co_await read_after_ready(rt, fds[0]);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "pipe read " << got << " after " << fixed << setprecision(1) << ms
+         << " ms (sleep_for + epoll readiness)" << defaultfloat << endl;
+    close(fds[0]);
+    close(fds[1]);
+
+    // Mutex across worker threads.
+    coro::Mutex mu(rt);
+    long counter = 0;
+    vector<coro::task<void>> adders;
+    for (int i = 0; i < 8; i++) adders.push_back(add_under_lock(mu, counter, 10000));
+    co_await coro::when_all(rt, std::move(adders));
+    cout << "8 coroutines x 10000 locked increments on " << rt.threads()
+         << " worker threads: " << counter << " (expected 80000)" << endl;
+
+    // Channel pipeline: source -> square -> sum.
+    coro::Channel<int> numbers(rt, 4), squares(rt, 4);
+    rt.spawn(square_stage(numbers, squares));
+    rt.spawn([](coro::Channel<int>& out) -> coro::task<void> {
+        for (int i = 1; i <= 100; i++) co_await out.send(i);
+        out.close();
+    }(numbers));
+    long sum = 0;
+    while (optional<int> v = co_await squares.recv()) sum += *v;
+    cout << "channel pipeline: sum of squares 1..100 = " << sum << " (expected 338350)" << endl;
+}
+
+void demonstrate_runtime() {
+    cout << "\n=== COROUTINE RUNTIME: TIMER, REACTOR, MUTEX, CHANNEL ===" << endl;
+    coro::Runtime rt(2);
+    rt.block_on(demo(rt));
+}
+
+// ============================================================================
+// 2. Capacity: how many waiting workers, at what cost
+// ============================================================================
+
+struct CapacityResult {
+    size_t started = 0;
+    double spawn_ms = 0;
+    double rss_kb = 0; // growth while all workers are parked
+    double vm_kb = 0;
+    double wake_ms = 0; // open the gate, wait until everyone has finished
+};
+
+long status_kb(const char* key) {
+    ifstream in("/proc/self/status");
+    string line;
+    size_t len = strlen(key);
+    while (getline(in, line)) {
+        if (line.compare(0, len, key) == 0) return stol(line.substr(len + 1));
+    }
+    return 0;
+}
+
+// Runs fn in a forked child; the POD result comes back through a pipe.
+CapacityResult measure_isolated(CapacityResult (*fn)(size_t), size_t n) {
+    CapacityResult r;
+    int fds[2];
+    if (pipe(fds) < 0) return r;
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        CapacityResult out = fn(n);
+        ssize_t w = write(fds[1], &out, sizeof(out));
+        _exit(w == sizeof(out) ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t got = read(fds[0], &r, sizeof(r));
+    if (got != sizeof(r)) r = CapacityResult{};
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return r;
+}
+
+coro::task<void> parked_worker(coro::Latch& gate, coro::Latch& done, atomic<size_t>& parked) {
+    parked.fetch_add(1);
+    co_await gate.wait();
+    done.count_down();
+}
+
+coro::task<void> wait_latch(coro::Latch& l) { co_await l.wait(); }
+
+CapacityResult capacity_coroutines(size_t n) {
+    CapacityResult r;
+    coro::Runtime rt(max(1u, thread::hardware_concurrency()));
+    coro::Latch gate(rt, 1), done(rt, n);
+    atomic<size_t> parked{0};
+    long rss0 = status_kb("VmRSS:"), vm0 = status_kb("VmSize:");
+
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) rt.spawn(parked_worker(gate, done, parked));
+    while (parked.load() < n) this_thread::yield();
+    auto t1 = chrono::steady_clock::now();
+
+    r.started = n;
+    r.rss_kb = double(status_kb("VmRSS:") - rss0);
+    r.vm_kb = double(status_kb("VmSize:") - vm0);
+    gate.count_down();
+    rt.block_on(wait_latch(done));
+    auto t2 = chrono::steady_clock::now();
+    r.spawn_ms = chrono::duration<double, milli>(t1 - t0).count();
+    r.wake_ms = chrono::duration<double, milli>(t2 - t1).count();
+    return r;
+}
+
+CapacityResult capacity_threads(size_t n) {
+    CapacityResult r;
+    mutex m;
+    condition_variable cv;
+    bool open = false;
+    atomic<size_t> parked{0};
+    vector<thread> pool;
+    pool.reserve(n);
+    long rss0 = status_kb("VmRSS:"), vm0 = status_kb("VmSize:");
+
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+        try {
+            pool.emplace_back([&]() {
+                unique_lock<mutex> lock(m);
+                parked.fetch_add(1);
+                cv.wait(lock, [&]() { return open; });
+            });
+        } catch (const system_error&) {
+            break; // hit a limit (threads-max, RLIMIT_NPROC, address space)
+        }
+    }
+    while (parked.load() < pool.size()) this_thread::yield();
+    auto t1 = chrono::steady_clock::now();
+
+    r.started = pool.size();
+    r.rss_kb = double(status_kb("VmRSS:") - rss0);
+    r.vm_kb = double(status_kb("VmSize:") - vm0);
+    {
+        lock_guard<mutex> lock(m);
+        open = true;
+    }
+    cv.notify_all();
+    for (thread& t : pool) t.join();
+    auto t2 = chrono::steady_clock::now();
+    r.spawn_ms = chrono::duration<double, milli>(t1 - t0).count();
+    r.wake_ms = chrono::duration<double, milli>(t2 - t1).count();
+    return r;
+}
+
+void print_capacity(const char* name, size_t asked, const CapacityResult& r) {
+    double per = r.started ? 1.0 / double(r.started) : 0;
+    cout << left << setw(14) << name << right << setw(10) << asked << setw(10) << r.started << fixed
+         << setprecision(2) << setw(12) << r.spawn_ms * 1000.0 * per << setw(14)
+         << r.rss_kb * 1024.0 * per << setw(14) << r.vm_kb * per << setprecision(1) << setw(12)
+         << r.wake_ms << defaultfloat << endl;
+}
+
+void benchmark_capacity(size_t coroutines, size_t threads) {
+    cout << "\n=== CAPACITY: N WORKERS PARKED ON A GATE ===" << endl;
+    cout << left << setw(14) << "worker" << right << setw(10) << "asked" << setw(10) << "parked"
+         << setw(12) << "spawn us/w" << setw(14) << "RSS bytes/w" << setw(14) << "VM KB/w"
+         << setw(12) << "wake all ms" << endl;
+    print_capacity("coroutine", coroutines, measure_isolated(capacity_coroutines, coroutines));
+    print_capacity("std::thread", threads, measure_isolated(capacity_threads, threads));
+    cout << "\nA parked coroutine is its frame (promise + locals + awaiter). A parked\n"
+         << "thread is a stack mapping (default 8MB reserved, touched pages resident),\n"
+         << "a guard page and a kernel task; threads-max and vm.max_map_count bound it." << endl;
+}
+
+// ============================================================================
+// 3. Switch cost
+// ============================================================================
+
+// Same shape as synchronization/semaphore_cpp20.cpp's CountingSemaphore.
+class ThreadSemaphore {
+    mutex m_;
+    condition_variable cv_;
+    long count_ = 0;
+
+public:
+    void acquire() {
+        unique_lock<mutex> lock(m_);
+        cv_.wait(lock, [&]() { return count_ > 0; });
+        count_--;
+    }
+    void release() {
+        lock_guard<mutex> lock(m_);
+        count_++;
+        cv_.notify_one();
+    }
+};
+
+double threads_ping_pong(int rounds) {
+    ThreadSemaphore ping, pong;
+    auto start = chrono::steady_clock::now();
+    thread other([&]() {
+        for (int i = 0; i < rounds; i++) {
+            ping.acquire();
+            pong.release();
+        }
+    });
+    for (int i = 0; i < rounds; i++) {
+        ping.release();
+        pong.acquire();
+    }
+    other.join();
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    return ns / (2.0 * rounds); // two hand-offs per round
+}
+
+coro::task<void> pong_side(coro::Semaphore& ping, coro::Semaphore& pong, int rounds) {
+    for (int i = 0; i < rounds; i++) {
+        co_await ping.acquire();
+        pong.release();
+    }
+}
+
+coro::task<void> ping_side(coro::Semaphore& ping, coro::Semaphore& pong, int rounds) {
+    for (int i = 0; i < rounds; i++) {
+        ping.release();
+        co_await pong.acquire();
+    }
+}
+
+double coroutines_ping_pong(unsigned workers, int rounds) {
+    coro::Runtime rt(workers);
+    coro::Semaphore ping(rt, 0), pong(rt, 0);
+    auto start = chrono::steady_clock::now();
+    vector<coro::task<void>> both;
+    both.push_back(pong_side(ping, pong, rounds));
+    both.push_back(ping_side(ping, pong, rounds));
+    rt.block_on(coro::when_all(rt, std::move(both)));
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    return ns / (2.0 * rounds);
+}
+
+coro::task<void> yield_loop(coro::Runtime& rt, int rounds) {
+    for (int i = 0; i < rounds; i++) co_await rt.yield();
+}
+
+double coroutine_yield(int rounds) {
+    coro::Runtime rt(1);
+    auto start = chrono::steady_clock::now();
+    rt.block_on(yield_loop(rt, rounds));
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    return ns / rounds;
+}
+
+void benchmark_switch(int rounds) {
+    unsigned multi = max(2u, thread::hardware_concurrency());
+    cout << "\n=== SWITCH COST: SEMAPHORE PING-PONG, " << rounds << " ROUNDS ===" << endl;
+    cout << left << setw(40) << "hand-off" << right << setw(14) << "ns / switch" << endl;
+    auto row = [](const string& name, double ns) {
+        cout << left << setw(40) << name << right << setw(14) << fixed << setprecision(0) << ns
+             << defaultfloat << endl;
+    };
+    row("threads (mutex + condition_variable)", threads_ping_pong(rounds));
+    row("coroutines, 1 worker thread", coroutines_ping_pong(1, rounds));
+    row("coroutines, " + to_string(multi) + " worker threads", coroutines_ping_pong(multi, rounds));
+    row("co_await yield() (run-queue trip)", coroutine_yield(rounds));
+    cout << "\nA thread hand-off is futex wake + sleep + a kernel context switch. A\n"
+         << "coroutine hand-off is a locked queue push/pop and a resume() call; extra\n"
+         << "worker threads add cross-thread wakes, so 1 worker is often fastest." << endl;
+}
+
+// Whole argument as a number in 1..max; false if it is not one
+bool parse_number(const string& text, size_t max, size_t& value) {
+    try {
+        size_t used = 0;
+        unsigned long long v = stoull(text, &used);
+        if (used != text.size() || text[0] == '-' || v < 1 || v > max) return false;
+        value = size_t(v);
+        return true;
+    } catch (const exception&) {
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t kMaxCoroutines = 10000000, kMaxThreads = 100000;
+    size_t coroutines = 100000, threads = 10000;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool ok = false;
+        if (arg.rfind("--workers=", 0) == 0) {
+            ok = parse_number(arg.substr(10), kMaxCoroutines, coroutines);
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            ok = parse_number(arg.substr(10), kMaxThreads, threads);
+        }
+        if (!ok) {
+            cerr << "usage: " << argv[0] << " [--workers=1.." << kMaxCoroutines << "] [--threads=1.."
+                 << kMaxThreads << "]" << endl;
+            return 2;
+        }
+    }
+
+    demonstrate_runtime();
+    benchmark_capacity(coroutines, threads);
+    benchmark_switch(200000);
+    return 0;
+}
@@ -0,0 +1,729 @@
+/**
+ * coro_runtime.h - C++20 coroutine runtime: tasks, scheduler, epoll reactor
+ *
+ * WHY:
+ * ====
+ * Every demo so far parks an OS THREAD to wait: sleep_for() in a producer,
+ * cv.wait() in a consumer or pooled_worker. A parked thread still owns a
+ * stack (8MB reserved, a few KB touched), a kernel task_struct, and every
+ * hand-off between two threads is a futex syscall + context switch.
+ * A coroutine that waits is just a heap frame (~100-200 bytes) on a list;
+ * resuming it is an indirect call.
+ *
+ * WHAT IT PROVIDES:
+ * =================
+ *   coro::task<T>            lazy coroutine, co_await it to run it and get T
+ *   coro::Runtime rt(n)      n worker threads + 1 reactor thread
+ *     rt.block_on(task)      run a task from main(), wait for its result
+ *     rt.spawn(task<void>)   fire-and-forget (an escaping exception terminates,
+ *                            like std::thread)
+ *     co_await rt.sleep_for(d)       timer (timerfd)
+ *     co_await rt.readable(fd)       fd readiness (epoll, one waiter per fd)
+ *     co_await rt.yield()            back of the run queue
+ *   coro::Channel<T>         bounded MPMC channel: send() / recv() / close()
+ *   coro::Mutex              co_await m.lock() / m.unlock(), or scoped_lock()
+ *   coro::Semaphore          co_await s.acquire() / s.release()
+ *   coro::Latch              count_down() from anywhere, co_await wait()
+ *   coro::when_all(rt, tasks)  run tasks concurrently, resume when all finish
+ *
+ * HOW IT FITS TOGETHER:
+ * =====================
+ *
+ *   worker threads ──pop──> ready queue <──schedule()── Channel/Mutex/Semaphore
+ *        │ h.resume()           ^                        (wake a waiter)
+ *        ▼                      │
+ *   coroutine runs until   reactor thread: epoll_wait on
+ *   its next co_await        - timerfd   (earliest sleep_for deadline)
+ *                            - eventfd   (wake-up / shutdown)
+ *                            - user fds  (readable/writable, EPOLLONESHOT)
+ *
+ * A waiting coroutine is stored as a coroutine_handle in the primitive's
+ * waiter list; waking it = pushing the handle onto the ready queue. The
+ * primitives never resume inline, so no coroutine runs under another's lock.
+ *
+ * THREAD SAFETY RULE (why await_suspend looks the way it does):
+ * =============================================================
+ * With several workers, a coroutine can be resumed on another thread the
+ * instant its handle is published (pushed to a waiter list, registered in
+ * epoll). The awaiter lives IN that coroutine's frame, so after publishing
+ * await_suspend must not touch `this` again - only the local lock_guard.
+ *
+ * Coroutines still suspended when the Runtime is destroyed are leaked, not
+ * destroyed: block_on() the work you need finished. io_uring would save the
+ * read() after readiness; epoll keeps this header dependency-free.
+ *
+ * Build: needs -std=c++20 (make STD=c++20 FILE=... run)
+ */
+
+#ifndef CORO_RUNTIME_H
+#define CORO_RUNTIME_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "coro_runtime.h needs C++20 coroutines: build with -std=c++20 (make STD=c++20 FILE=... run)"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace coro {
+
+// ============================================================================
+// task<T>: lazy, single-awaiter coroutine with symmetric transfer
+// ============================================================================
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+struct promise_base {
+    std::coroutine_handle<> continuation_ = std::noop_coroutine();
+    std::exception_ptr error_;
+
+    std::suspend_always initial_suspend() noexcept { return {}; } // lazy: runs when awaited
+
+    // On completion jump straight to whoever awaited us (no queue, no stack growth).
+    struct final_awaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+            return h.promise().continuation_;
+        }
+        void await_resume() noexcept {}
+    };
+    final_awaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error_ = std::current_exception(); }
+};
+
+template <typename T>
+struct promise : promise_base {
+    std::optional<T> value_;
+    template <typename U>
+    void return_value(U&& v) { value_.emplace(std::forward<U>(v)); }
+    T result() {
+        if (error_) std::rethrow_exception(error_);
+        return std::move(*value_);
+    }
+};
+
+template <>
+struct promise<void> : promise_base {
+    void return_void() {}
+    void result() {
+        if (error_) std::rethrow_exception(error_);
+    }
+};
+
+} // namespace detail
+
+template <typename T>
+class task {
+public:
+    struct promise_type : detail::promise<T> {
+        task get_return_object() { return task(handle::from_promise(*this)); }
+    };
+    using handle = std::coroutine_handle<promise_type>;
+
+    task(task&& other) noexcept : h_(std::exchange(other.h_, {})) {}
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(other.h_, {});
+        }
+        return *this;
+    }
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    ~task() {
+        if (h_) h_.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        h_.promise().continuation_ = caller;
+        return h_; // start (or continue) the child on this thread
+    }
+    T await_resume() { return h_.promise().result(); }
+
+private:
+    explicit task(handle h) : h_(h) {}
+    handle h_;
+};
+
+class Runtime;
+
+namespace detail {
+
+// Self-destroying root frame for spawn(): starts suspended so the Runtime can
+// put it on the ready queue, frees itself when the wrapped task finishes.
+struct detached {
+    struct promise_type {
+        detached get_return_object() {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> h;
+};
+
+inline detached run_detached(task<void> t) { co_await t; }
+
+} // namespace detail
+
+// ============================================================================
+// Runtime: worker pool + reactor
+// ============================================================================
+
+class Runtime {
+    using clock = std::chrono::steady_clock; // CLOCK_MONOTONIC, same as timerfd
+
+    static constexpr uint64_t kWakeTag = 0;
+    static constexpr uint64_t kTimerTag = 1;
+
+    struct Timer {
+        clock::time_point when;
+        uint64_t seq; // FIFO among equal deadlines
+        std::coroutine_handle<> h;
+        bool operator>(const Timer& o) const {
+            return when != o.when ? when > o.when : seq > o.seq;
+        }
+    };
+
+    // Run queue
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::deque<std::coroutine_handle<>> ready_;
+    unsigned idle_ = 0;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+
+    // Reactor
+    int epfd_ = -1, wakefd_ = -1, timerfd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread reactor_;
+    std::mutex timer_m_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    uint64_t timer_seq_ = 0;
+
+    void worker_loop() {
+        for (;;) {
+            std::coroutine_handle<> h;
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                idle_++;
+                cv_.wait(lock, [&]() { return stop_ || !ready_.empty(); });
+                idle_--;
+                if (stop_) return;
+                h = ready_.front();
+                ready_.pop_front();
+            }
+            h.resume();
+        }
+    }
+
+    // Caller holds timer_m_. An absolute deadline of 0 would DISARM the timerfd.
+    void arm(clock::time_point when) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+        if (ns <= 0) ns = 1;
+        itimerspec its{};
+        its.it_value.tv_sec = ns / 1000000000;
+        its.it_value.tv_nsec = ns % 1000000000;
+        timerfd_settime(timerfd_, TFD_TIMER_ABSTIME, &its, nullptr);
+    }
+
+    void add_timer(clock::time_point when, std::coroutine_handle<> h) {
+        std::lock_guard<std::mutex> lock(timer_m_);
+        bool earliest = timers_.empty() || when < timers_.top().when;
+        timers_.push({when, timer_seq_++, h});
+        if (earliest) arm(when);
+    }
+
+    void fire_timers() {
+        std::vector<std::coroutine_handle<>> due;
+        {
+            std::lock_guard<std::mutex> lock(timer_m_);
+            auto now = clock::now();
+            while (!timers_.empty() && timers_.top().when <= now) {
+                due.push_back(timers_.top().h);
+                timers_.pop();
+            }
+            if (!timers_.empty()) arm(timers_.top().when);
+        }
+        for (auto h : due) schedule(h);
+    }
+
+    void reactor_loop() {
+        epoll_event events[64];
+        for (;;) {
+            int n = epoll_wait(epfd_, events, 64, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            for (int i = 0; i < n; i++) {
+                uint64_t tag = events[i].data.u64;
+                uint64_t drain;
+                if (tag == kWakeTag) {
+                    ssize_t r = read(wakefd_, &drain, sizeof(drain));
+                    (void)r;
+                    if (stopping_.load()) return;
+                } else if (tag == kTimerTag) {
+                    ssize_t r = read(timerfd_, &drain, sizeof(drain));
+                    (void)r;
+                    fire_timers();
+                } else {
+                    schedule(std::coroutine_handle<>::from_address(events[i].data.ptr));
+                }
+            }
+        }
+    }
+
+    void watch(int fd, uint64_t tag) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = tag;
+        epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+public:
+    explicit Runtime(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        epfd_ = epoll_create1(EPOLL_CLOEXEC);
+        wakefd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        timerfd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (epfd_ < 0 || wakefd_ < 0 || timerfd_ < 0) {
+            std::string err = std::string("coro: reactor setup: ") + strerror(errno);
+            for (int fd : {epfd_, wakefd_, timerfd_}) {
+                if (fd >= 0) close(fd);
+            }
+            throw std::runtime_error(err);
+        }
+        watch(wakefd_, kWakeTag);
+        watch(timerfd_, kTimerTag);
+        reactor_ = std::thread([this]() { reactor_loop(); });
+        for (unsigned i = 0; i < threads; i++) workers_.emplace_back([this]() { worker_loop(); });
+    }
+
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
+    ~Runtime() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        stopping_.store(true);
+        uint64_t one = 1;
+        ssize_t w = write(wakefd_, &one, sizeof(one));
+        (void)w;
+        for (std::thread& t : workers_) t.join();
+        reactor_.join();
+        close(timerfd_);
+        close(wakefd_);
+        close(epfd_);
+    }
+
+    unsigned threads() const { return unsigned(workers_.size()); }
+
+    // Make h runnable. Callable from any thread, including non-runtime ones.
+    void schedule(std::coroutine_handle<> h) {
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            ready_.push_back(h);
+            wake = idle_ > 0; // no futex wake when every worker is busy
+        }
+        if (wake) cv_.notify_one();
+    }
+
+    void spawn(task<void> t) { schedule(detail::run_detached(std::move(t)).h); }
+
+    template <typename T>
+    T block_on(task<T> t) {
+        std::promise<T> result;
+        std::future<T> f = result.get_future();
+        spawn(complete(std::move(t), result));
+        return f.get();
+    }
+
+    // ---- awaitables ----
+
+    struct SleepAwaiter {
+        Runtime* rt;
+        clock::time_point when;
+        bool await_ready() const noexcept { return when <= clock::now(); }
+        void await_suspend(std::coroutine_handle<> h) { rt->add_timer(when, h); }
+        void await_resume() const noexcept {}
+    };
+
+    template <typename Rep, typename Period>
+    SleepAwaiter sleep_for(std::chrono::duration<Rep, Period> d) {
+        return {this, clock::now() + std::chrono::duration_cast<clock::duration>(d)};
+    }
+
+    struct FdAwaiter {
+        Runtime* rt;
+        int fd;
+        uint32_t events;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            // Copy to locals: once registered, h may resume (and free us) on another thread.
+            int ep = rt->epfd_, target = fd;
+            epoll_event ev{};
+            ev.events = events | EPOLLONESHOT;
+            ev.data.ptr = h.address();
+            if (epoll_ctl(ep, EPOLL_CTL_MOD, target, &ev) < 0 && errno == ENOENT) {
+                epoll_ctl(ep, EPOLL_CTL_ADD, target, &ev);
+            }
+        }
+        void await_resume() const noexcept {}
+    };
+
+    FdAwaiter readable(int fd) { return {this, fd, EPOLLIN}; }
+    FdAwaiter writable(int fd) { return {this, fd, EPOLLOUT}; }
+
+    struct YieldAwaiter {
+        Runtime* rt;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { rt->schedule(h); }
+        void await_resume() const noexcept {}
+    };
+
+    YieldAwaiter yield() { return {this}; }
+
+private:
+    template <typename T>
+    static task<void> complete(task<T> t, std::promise<T>& result) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await t;
+                result.set_value();
+            } else {
+                result.set_value(co_await t);
+            }
+        } catch (...) {
+            result.set_exception(std::current_exception());
+        }
+    }
+};
+
+// ============================================================================
+// Synchronization primitives (wake = rt.schedule, never inline resume)
+// ============================================================================
+
+class Mutex {
+    Runtime& rt_;
+    std::mutex m_;
+    bool locked_ = false;
+    std::deque<std::coroutine_handle<>> waiters_;
+
+public:
+    explicit Mutex(Runtime& rt) : rt_(rt) {}
+
+    struct LockAwaiter {
+        Mutex& mu;
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(mu.m_);
+            if (!mu.locked_) {
+                mu.locked_ = true;
+                return false; // got it, keep running
+            }
+            mu.waiters_.push_back(h);
+            return true;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    class Guard {
+        Mutex* mu_;
+
+    public:
+        explicit Guard(Mutex& mu) : mu_(&mu) {}
+        Guard(Guard&& o) noexcept : mu_(std::exchange(o.mu_, nullptr)) {}
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+        ~Guard() {
+            if (mu_) mu_->unlock();
+        }
+    };
+
+    struct ScopedAwaiter : LockAwaiter {
+        Guard await_resume() const noexcept { return Guard(mu); }
+    };
+
+    LockAwaiter lock() { return {*this}; }
+    ScopedAwaiter scoped_lock() { return {{*this}}; }
+
+    // FIFO hand-off: the next waiter OWNS the mutex when it resumes, so a
+    // running coroutine cannot barge in between unlock and the wake-up.
+    void unlock() {
+        Runtime& rt = rt_;
+        std::coroutine_handle<> h;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            if (waiters_.empty()) {
+                locked_ = false;
+                return;
+            }
+            h = waiters_.front();
+            waiters_.pop_front();
+        }
+        rt.schedule(h);
+    }
+};
+
+class Semaphore {
+    Runtime& rt_;
+    std::mutex m_;
+    long count_;
+    std::deque<std::coroutine_handle<>> waiters_;
+
+public:
+    Semaphore(Runtime& rt, long initial) : rt_(rt), count_(initial) {}
+
+    struct AcquireAwaiter {
+        Semaphore& s;
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(s.m_);
+            if (s.count_ > 0) {
+                s.count_--;
+                return false;
+            }
+            s.waiters_.push_back(h);
+            return true;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    AcquireAwaiter acquire() { return {*this}; }
+
+    void release(long n = 1) {
+        Runtime& rt = rt_;
+        std::vector<std::coroutine_handle<>> wake;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            for (; n > 0; n--) {
+                if (waiters_.empty()) {
+                    count_++;
+                    continue;
+                }
+                wake.push_back(waiters_.front()); // permit passes straight to the waiter
+                waiters_.pop_front();
+            }
+        }
+        for (auto h : wake) rt.schedule(h);
+    }
+};
+
+class Latch {
+    Runtime& rt_;
+    std::mutex m_;
+    size_t count_;
+    std::vector<std::coroutine_handle<>> waiters_;
+
+public:
+    Latch(Runtime& rt, size_t count) : rt_(rt), count_(count) {}
+
+    // Wakes after unlocking and only through locals: a woken waiter may
+    // destroy the Latch (typical: it lives in the waiting coroutine's frame).
+    void count_down(size_t n = 1) {
+        Runtime& rt = rt_;
+        std::vector<std::coroutine_handle<>> wake;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            count_ = n >= count_ ? 0 : count_ - n;
+            if (count_ == 0) wake.swap(waiters_);
+        }
+        for (auto h : wake) rt.schedule(h);
+    }
+
+    struct WaitAwaiter {
+        Latch& l;
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(l.m_);
+            if (l.count_ == 0) return false;
+            l.waiters_.push_back(h);
+            return true;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    WaitAwaiter wait() { return {*this}; }
+};
+
+template <typename T>
+class Channel {
+    Runtime& rt_;
+    std::mutex m_;
+    size_t capacity_;
+    std::deque<T> buffer_;
+    bool closed_ = false;
+
+public:
+    class SendAwaiter;
+    class RecvAwaiter;
+
+private:
+    std::deque<SendAwaiter*> senders_;   // blocked: buffer full
+    std::deque<RecvAwaiter*> receivers_; // blocked: buffer empty
+
+public:
+    // capacity 0 = rendezvous: every send waits for a matching recv.
+    Channel(Runtime& rt, size_t capacity) : rt_(rt), capacity_(capacity) {}
+
+    class SendAwaiter {
+        friend class Channel;
+        Channel& ch_;
+        T value_;
+        bool ok_ = true;
+        std::coroutine_handle<> h_;
+
+    public:
+        SendAwaiter(Channel& ch, T value) : ch_(ch), value_(std::move(value)) {}
+        bool await_ready() const noexcept { return false; }
+        // A woken peer may destroy the Channel, so it is scheduled after
+        // unlocking and only through locals (same rule as Latch::count_down).
+        bool await_suspend(std::coroutine_handle<> h) {
+            Runtime& rt = ch_.rt_;
+            std::coroutine_handle<> wake;
+            {
+                std::lock_guard<std::mutex> lock(ch_.m_);
+                if (ch_.closed_) {
+                    ok_ = false;
+                    return false;
+                }
+                if (!ch_.receivers_.empty()) { // hand over directly, skip the buffer
+                    RecvAwaiter* r = ch_.receivers_.front();
+                    ch_.receivers_.pop_front();
+                    r->value_.emplace(std::move(value_));
+                    wake = r->h_;
+                } else if (ch_.buffer_.size() < ch_.capacity_) {
+                    ch_.buffer_.push_back(std::move(value_));
+                } else {
+                    h_ = h;
+                    ch_.senders_.push_back(this);
+                    return true;
+                }
+            }
+            if (wake) rt.schedule(wake);
+            return false;
+        }
+        bool await_resume() const noexcept { return ok_; } // false: channel was closed
+    };
+
+    class RecvAwaiter {
+        friend class Channel;
+        Channel& ch_;
+        std::optional<T> value_;
+        std::coroutine_handle<> h_;
+
+    public:
+        explicit RecvAwaiter(Channel& ch) : ch_(ch) {}
+        bool await_ready() const noexcept { return false; }
+        // Same wake-after-unlock rule as SendAwaiter::await_suspend.
+        bool await_suspend(std::coroutine_handle<> h) {
+            Runtime& rt = ch_.rt_;
+            std::coroutine_handle<> wake;
+            {
+                std::lock_guard<std::mutex> lock(ch_.m_);
+                if (!ch_.buffer_.empty()) {
+                    value_.emplace(std::move(ch_.buffer_.front()));
+                    ch_.buffer_.pop_front();
+                    if (!ch_.senders_.empty()) { // a slot opened: admit one blocked sender
+                        SendAwaiter* s = ch_.senders_.front();
+                        ch_.senders_.pop_front();
+                        ch_.buffer_.push_back(std::move(s->value_));
+                        wake = s->h_;
+                    }
+                } else if (!ch_.senders_.empty()) { // rendezvous channel
+                    SendAwaiter* s = ch_.senders_.front();
+                    ch_.senders_.pop_front();
+                    value_.emplace(std::move(s->value_));
+                    wake = s->h_;
+                } else if (!ch_.closed_) {
+                    h_ = h;
+                    ch_.receivers_.push_back(this);
+                    return true;
+                } // else empty + closed: nullopt
+            }
+            if (wake) rt.schedule(wake);
+            return false;
+        }
+        std::optional<T> await_resume() { return std::move(value_); } // nullopt: closed and drained
+    };
+
+    SendAwaiter send(T value) { return SendAwaiter(*this, std::move(value)); }
+    RecvAwaiter recv() { return RecvAwaiter(*this); }
+
+    // Wakes every waiter: receivers get nullopt once the buffer is drained,
+    // blocked senders get false. Wakes after unlocking and only through
+    // locals: a woken receiver may destroy the Channel.
+    void close() {
+        Runtime& rt = rt_;
+        std::vector<std::coroutine_handle<>> wake;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            closed_ = true;
+            for (RecvAwaiter* r : receivers_) wake.push_back(r->h_);
+            for (SendAwaiter* s : senders_) {
+                s->ok_ = false;
+                wake.push_back(s->h_);
+            }
+            receivers_.clear();
+            senders_.clear();
+        }
+        for (auto h : wake) rt.schedule(h);
+    }
+};
+
+// ============================================================================
+// when_all: fan out on the runtime, resume the caller when every task is done
+// ============================================================================
+
+namespace detail {
+inline task<void> count_down_after(task<void> t, Latch& done) {
+    co_await t;
+    done.count_down();
+}
+} // namespace detail
+
+inline task<void> when_all(Runtime& rt, std::vector<task<void>> tasks) {
+    Latch done(rt, tasks.size());
+    for (task<void>& t : tasks) rt.spawn(detail::count_down_after(std::move(t), done));
+    co_await done.wait();
+}
+
+} // namespace coro
+
+#endif // CORO_RUNTIME_H
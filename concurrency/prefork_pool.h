@@ -0,0 +1,427 @@
+/**
+ * prefork_pool.h - Prefork worker-process pool with a shared-memory task queue
+ *
+ * WHAT IT IS:
+ * ===========
+ * Run CPU-heavy, crash-prone work in ISOLATED processes without paying a
+ * fork() per task. N workers are forked once ("prefork") and then fed tasks
+ * through shared memory; a worker that segfaults only loses its current task.
+ *
+ * MEMORY LAYOUT (one MAP_SHARED|MAP_ANONYMOUS region, created before fork):
+ * ========================================================================
+ *
+ *   ┌─ Shared ───────────────────────────────────────────────────┐
+ *   │ done_seq, supervisor_waiting        (futex: "a task finished") │
+ *   ├─ Lane 0 (worker 0) ────────────────────────────────────────┤
+ *   │ doorbell, sleeping, stop            (futex: "task queued")     │
+ *   │ Slot[kDepth]: state | ticket | task_id | in[] | out[]          │
+ *   ├─ Lane 1 ... Lane N-1 ──────────────────────────────────────┤
+ *   └────────────────────────────────────────────────────────────┘
+ *
+ * SLOT STATE MACHINE (each transition has exactly one writer):
+ * =============================================================
+ *
+ *   Free --supervisor--> Queued --worker--> Running --worker--> Done
+ *     ^                                                          |
+ *     +------------------------supervisor------------------------+
+ *
+ * Each worker owns one lane of kDepth slots (one running + one queued
+ * keeps it busy while the supervisor refills). The supervisor keeps
+ * everything else in a local pending deque and tops lanes up as results
+ * come back, so load balances itself like a shared queue, but the
+ * supervisor always knows EXACTLY which tasks a dead worker held.
+ *
+ * SUPERVISION:
+ * ============
+ * - Crash (signal or non-zero exit): the Running task is reported as
+ *   Crashed (never retried: a poison task would kill every worker), Queued
+ *   tasks go back to the front of the pending deque, a new worker is forked
+ *   into the same lane.
+ * - Recycling: a worker exits(0) after `recycle_after` tasks, which bounds
+ *   leaks/fragmentation in long-lived workers; it is replaced the same way.
+ * - Pinning: worker i is pinned to the i-th CPU of the supervisor's
+ *   affinity mask (mod count), and a respawned worker keeps its CPU.
+ * - Workers die with the supervisor (PR_SET_PDEATHSIG).
+ *
+ * The supervisor API is single-threaded: call submit()/next_result() from
+ * one thread. fork() copies only the calling thread, so do not create the
+ * pool while other threads hold locks the handler needs.
+ */
+
+#ifndef PREFORK_POOL_H
+#define PREFORK_POOL_H
+
+#include "shm_ring.h" // shm::futex_wait / shm::futex_wake
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace prefork {
+
+constexpr uint32_t kMaxPayload = 4096; // bytes per task and per result
+constexpr int kDepth = 2;              // slots per worker lane
+
+enum class TaskStatus { Ok, Crashed, TooLarge };
+
+inline const char* to_string(TaskStatus s) {
+    switch (s) {
+        case TaskStatus::Ok: return "ok";
+        case TaskStatus::Crashed: return "crashed";
+        case TaskStatus::TooLarge: return "too-large";
+    }
+    return "?";
+}
+
+struct TaskResult {
+    uint64_t id = 0;
+    TaskStatus status = TaskStatus::Ok;
+    int signal = 0;      // for Crashed: terminating signal (0 = non-zero exit)
+    std::string payload; // handler output (empty unless Ok)
+};
+
+struct PoolOptions {
+    int workers = 0;            // 0 = one per CPU in the affinity mask
+    uint64_t recycle_after = 0; // 0 = never recycle
+    bool pin_cpus = true;
+};
+
+struct PoolStats {
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t crashed = 0;  // tasks lost to a crashing worker
+    uint64_t spawned = 0;  // fork()s, including the initial N
+    uint64_t recycled = 0; // clean exits after recycle_after tasks
+};
+
+// Task handler, runs inside the worker process. Returning a string larger
+// than kMaxPayload yields TaskStatus::TooLarge.
+using Handler = std::function<std::string(std::string_view task)>;
+
+class WorkerPool {
+    enum SlotState : uint32_t { Free, Queued, Running, Done, Oversized };
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> state;
+        uint32_t in_len;
+        uint32_t out_len;
+        uint64_t ticket;  // dispatch order within the lane
+        uint64_t task_id;
+        char in[kMaxPayload];
+        char out[kMaxPayload];
+    };
+
+    struct alignas(64) Lane {
+        std::atomic<uint32_t> doorbell; // futex word: bumped on every dispatch
+        std::atomic<uint32_t> sleeping;
+        std::atomic<uint32_t> stop;
+        Slot slots[kDepth];
+    };
+
+    struct Shared {
+        alignas(64) std::atomic<uint32_t> done_seq; // futex word: bumped per result
+        std::atomic<uint32_t> supervisor_waiting;
+    };
+
+    struct Worker {
+        pid_t pid = -1;
+        int cpu = -1;
+    };
+
+    struct Pending {
+        uint64_t id;
+        std::string payload;
+    };
+
+    Handler handler_;
+    PoolOptions opt_;
+    size_t map_size_ = 0;
+    Shared* shared_ = nullptr;
+    Lane* lanes_ = nullptr;
+    std::vector<Worker> workers_;
+    std::deque<Pending> pending_;
+    std::deque<TaskResult> ready_;
+    uint64_t next_id_ = 1;
+    uint64_t next_ticket_ = 1;
+    size_t in_flight_ = 0; // Queued + Running + Done-not-collected
+    size_t rr_ = 0;        // round-robin start for dispatch
+    PoolStats stats_;
+
+    // ---- worker side (runs in the child after fork) ----
+
+    [[noreturn]] void worker_main(int index) {
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        if (opt_.pin_cpus && workers_[index].cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(workers_[index].cpu, &set);
+            sched_setaffinity(0, sizeof(set), &set);
+        }
+
+        Lane& lane = lanes_[index];
+        uint64_t done = 0;
+        while (!lane.stop.load(std::memory_order_acquire)) {
+            Slot* next = nullptr;
+            for (Slot& s : lane.slots) {
+                if (s.state.load(std::memory_order_acquire) == Queued &&
+                    (!next || s.ticket < next->ticket)) {
+                    next = &s;
+                }
+            }
+
+            if (!next) { // announce, re-check, sleep (same order as ShmRing)
+                uint32_t seq = lane.doorbell.load(std::memory_order_seq_cst);
+                lane.sleeping.store(1, std::memory_order_seq_cst);
+                bool queued = false;
+                for (Slot& s : lane.slots) queued |= s.state.load() == Queued;
+                if (!queued && !lane.stop.load()) shm::futex_wait(&lane.doorbell, seq, 1000);
+                lane.sleeping.store(0, std::memory_order_relaxed);
+                continue;
+            }
+
+            next->state.store(Running, std::memory_order_release);
+            std::string out = handler_(std::string_view(next->in, next->in_len));
+            uint32_t state = Done;
+            if (out.size() > kMaxPayload) {
+                state = Oversized;
+                next->out_len = 0;
+            } else {
+                memcpy(next->out, out.data(), out.size());
+                next->out_len = uint32_t(out.size());
+            }
+            next->state.store(state, std::memory_order_release);
+
+            shared_->done_seq.fetch_add(1, std::memory_order_seq_cst);
+            if (shared_->supervisor_waiting.load(std::memory_order_seq_cst)) {
+                shm::futex_wake(&shared_->done_seq, 1);
+            }
+            if (opt_.recycle_after && ++done >= opt_.recycle_after) break;
+        }
+        _exit(0);
+    }
+
+    // ---- supervisor side ----
+
+    void spawn(int index) {
+        Lane& lane = lanes_[index];
+        for (Slot& s : lane.slots) {
+            uint32_t st = s.state.load();
+            if (st == Queued || st == Running) s.state.store(Free);
+        }
+        lane.sleeping.store(0);
+        std::cout.flush(); // do not duplicate buffered output into the child
+        pid_t pid = fork();
+        if (pid < 0) throw std::runtime_error("prefork: fork failed");
+        if (pid == 0) worker_main(index);
+        workers_[index].pid = pid;
+        stats_.spawned++;
+    }
+
+    // Reap exited workers, account for their tasks, fork replacements.
+    // waitpid() on each worker pid, never -1: other children of the host
+    // program keep their exit status for whoever forked them.
+    void supervise() {
+        for (size_t i = 0; i < workers_.size(); i++) {
+            if (workers_[i].pid <= 0) continue;
+            int status;
+            if (waitpid(workers_[i].pid, &status, WNOHANG) != workers_[i].pid) continue;
+            const int index = int(i);
+
+            bool clean = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            int sig = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+            if (clean) stats_.recycled++;
+
+            collect_lane(lanes_[index]); // results finished before it exited
+            std::vector<Slot*> requeue;
+            for (Slot& s : lanes_[index].slots) {
+                uint32_t st = s.state.load();
+                if (st == Running) {
+                    ready_.push_back({s.task_id, TaskStatus::Crashed, sig, {}});
+                    stats_.crashed++;
+                    in_flight_--;
+                } else if (st == Queued) {
+                    requeue.push_back(&s);
+                    in_flight_--;
+                }
+            }
+            // Back to the FRONT, oldest ticket first, so ordering is kept.
+            std::sort(requeue.begin(), requeue.end(),
+                      [](Slot* a, Slot* b) { return a->ticket > b->ticket; });
+            for (Slot* s : requeue) pending_.push_front({s->task_id, std::string(s->in, s->in_len)});
+
+            workers_[index].pid = -1;
+            if (!lanes_[index].stop.load()) spawn(index);
+        }
+    }
+
+    void collect_lane(Lane& lane) {
+        for (Slot& s : lane.slots) {
+            uint32_t st = s.state.load(std::memory_order_acquire);
+            if (st != Done && st != Oversized) continue;
+            TaskResult r;
+            r.id = s.task_id;
+            if (st == Done) {
+                r.payload.assign(s.out, s.out_len);
+            } else {
+                r.status = TaskStatus::TooLarge;
+            }
+            s.state.store(Free, std::memory_order_release);
+            ready_.push_back(std::move(r));
+            stats_.completed++;
+            in_flight_--;
+        }
+    }
+
+    void collect() {
+        for (size_t i = 0; i < workers_.size(); i++) collect_lane(lanes_[i]);
+    }
+
+    // Move pending tasks into free slots, rotating the starting lane.
+    void dispatch() {
+        const size_t n = workers_.size();
+        for (size_t k = 0; k < n && !pending_.empty(); k++) {
+            const size_t i = (rr_ + k) % n;
+            Lane& lane = lanes_[i];
+            if (workers_[i].pid < 0) continue;
+            bool rang = false;
+            for (Slot& s : lane.slots) {
+                if (pending_.empty()) break;
+                if (s.state.load(std::memory_order_acquire) != Free) continue;
+                Pending& p = pending_.front();
+                memcpy(s.in, p.payload.data(), p.payload.size());
+                s.in_len = uint32_t(p.payload.size());
+                s.task_id = p.id;
+                s.ticket = next_ticket_++;
+                s.state.store(Queued, std::memory_order_release);
+                pending_.pop_front();
+                in_flight_++;
+                rang = true;
+            }
+            if (rang) {
+                lane.doorbell.fetch_add(1, std::memory_order_seq_cst);
+                if (lane.sleeping.load(std::memory_order_seq_cst)) shm::futex_wake(&lane.doorbell, 1);
+            }
+        }
+        rr_ = (rr_ + 1) % n;
+    }
+
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int c = 0; c < CPU_SETSIZE; c++) {
+                if (CPU_ISSET(c, &set)) cpus.push_back(c);
+            }
+        }
+        return cpus;
+    }
+
+public:
+    WorkerPool(Handler handler, PoolOptions opt = {}) : handler_(std::move(handler)), opt_(opt) {
+        std::vector<int> cpus = allowed_cpus();
+        if (opt_.workers <= 0) opt_.workers = cpus.empty() ? 1 : int(cpus.size());
+
+        map_size_ = sizeof(Shared) + sizeof(Lane) * opt_.workers + alignof(Lane);
+        void* base = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) throw std::runtime_error("prefork: mmap failed");
+        shared_ = new (base) Shared{};
+        char* after = static_cast<char*>(base) + sizeof(Shared);
+        after += (alignof(Lane) - reinterpret_cast<uintptr_t>(after) % alignof(Lane)) % alignof(Lane);
+        lanes_ = reinterpret_cast<Lane*>(after);
+        for (int i = 0; i < opt_.workers; i++) new (&lanes_[i]) Lane{};
+
+        workers_.resize(opt_.workers);
+        for (int i = 0; i < opt_.workers; i++) {
+            workers_[i].cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+            spawn(i);
+        }
+    }
+
+    ~WorkerPool() {
+        shutdown();
+        munmap(shared_, map_size_);
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Queues a task (copied) and returns its id. Never blocks: the backlog
+    // lives in the supervisor; only kDepth tasks per worker are in shared memory.
+    uint64_t submit(std::string_view task) {
+        if (task.size() > kMaxPayload) throw std::length_error("prefork: task larger than kMaxPayload");
+        uint64_t id = next_id_++;
+        pending_.push_back({id, std::string(task)});
+        stats_.submitted++;
+        dispatch();
+        return id;
+    }
+
+    // Next finished task, in completion order. Returns false if nothing is
+    // outstanding or timeout_ms expires (-1 = wait forever).
+    bool next_result(TaskResult& out, int timeout_ms = -1) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        for (;;) {
+            if (ready_.empty()) {
+                collect();
+                supervise();
+                dispatch();
+            }
+            if (!ready_.empty()) {
+                out = std::move(ready_.front());
+                ready_.pop_front();
+                return true;
+            }
+            if (in_flight_ == 0 && pending_.empty()) return false;
+            if (timeout_ms >= 0 && std::chrono::steady_clock::now() >= deadline) return false;
+
+            // Announce, re-check, sleep. The timeout doubles as the crash probe:
+            // a dead worker never bumps done_seq.
+            const int slice = shm::ShmRing::kProbeIntervalMs;
+            uint32_t seq = shared_->done_seq.load(std::memory_order_seq_cst);
+            shared_->supervisor_waiting.store(1, std::memory_order_seq_cst);
+            collect();
+            if (ready_.empty()) shm::futex_wait(&shared_->done_seq, seq, slice);
+            shared_->supervisor_waiting.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Stops every worker after its current task; unfinished tasks are dropped.
+    void shutdown() {
+        bool any = false;
+        for (size_t i = 0; i < workers_.size(); i++) {
+            lanes_[i].stop.store(1, std::memory_order_seq_cst);
+            lanes_[i].doorbell.fetch_add(1, std::memory_order_seq_cst);
+            shm::futex_wake(&lanes_[i].doorbell, 1);
+            any |= workers_[i].pid > 0;
+        }
+        if (!any) return;
+        for (Worker& w : workers_) {
+            if (w.pid > 0) waitpid(w.pid, nullptr, 0);
+            w.pid = -1;
+        }
+    }
+
+    const PoolStats& stats() const { return stats_; }
+    int workers() const { return opt_.workers; }
+};
+
+} // namespace prefork
+
+#endif // PREFORK_POOL_H
@@ -0,0 +1,451 @@
+/**
+ * shm_ring.h - Cross-process message ring in shared memory
+ *
+ * WHAT IT IS:
+ * ===========
+ * A bounded ring of variable-length records living in a memfd mapping that
+ * several processes map at the same time. Producers and the consumer move
+ * data with plain loads/stores; the kernel is only entered to SLEEP/WAKE
+ * (futex) when the ring is empty or full.
+ *
+ * MEMORY LAYOUT (one memfd, mapped MAP_SHARED in every process):
+ * ==============================================================
+ *
+ *   ┌──────────────── header (own cache lines) ────────────────┐
+ *   │ reserve  : next free byte (producers CAS / bump)          │ line 1
+ *   │ commit   : bytes fully written, visible to consumer       │ line 2
+ *   │ tail     : bytes consumed                                 │ line 3
+ *   │ futex words + waiter flags, peer pids, closed flag        │ line 4+
+ *   ├──────────────── data[capacity] ──────────────────────────┤
+ *   │ [len|type|payload...pad8][len|type|payload...]  ...       │
+ *   └───────────────────────────────────────────────────────────┘
+ *
+ *   0 <= tail <= commit <= reserve, reserve - tail <= capacity
+ *   Positions are 64-bit and never wrap; (pos & mask) is the byte offset.
+ *
+ * PROTOCOL:
+ * =========
+ * Producer: reserve space (CAS on `reserve` in MPSC mode, a plain store in
+ *           SPSC mode), copy header + payload, wait until `commit` reaches its
+ *           start (in-order publication), store commit = end (release), and
+ *           FUTEX_WAKE the consumer only if it announced it is sleeping.
+ * Consumer: read records in [tail, commit), then store tail (release) and wake
+ *           producers only if one is waiting for space.
+ * A record never straddles the end of the buffer: the producer writes a PAD
+ * record to fill the gap and reserves both in one step.
+ *
+ * Sleeping uses the classic "announce, re-check, sleep" order with seq_cst
+ * on both sides, so a wake can never be lost between the check and the sleep.
+ *
+ * CRASHED PEERS:
+ * ==============
+ * Every participant registers its pid. Waits use a futex TIMEOUT; when it
+ * fires we probe registered peers (kill(pid, 0) + zombie check in /proc).
+ * A producer that died between reserve and commit would stall the ring
+ * forever: in MPSC mode every later producer waits for its commit. So each
+ * registered producer records the reservation it holds, and whoever waits on
+ * a stalled commit (consumer or producer) checks that reservation's owner.
+ * If it is dead the ring is POISONED: every send/consume from then on returns
+ * PeerDead. The reserved bytes can never be published, so the ring can't be
+ * repaired; tear it down and create a new one.
+ * Producers must call register_producer() for this to work. An unregistered
+ * producer that dies is only detected when some registered producer is
+ * dead too, and only after the commit has stalled for a whole probe interval.
+ *
+ * COSTS:
+ * ======
+ * - Steady state: one cache-line transfer per index, zero syscalls
+ * - Futex syscall only on empty/full transitions
+ * - Uses NON-private futex ops: the futex key is the shared physical page
+ */
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <linux/futex.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace shm {
+
+inline long futex_wait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    timespec ts{timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected,
+                   timeout_ms < 0 ? nullptr : &ts, nullptr, 0);
+}
+
+inline void futex_wake(std::atomic<uint32_t>* word, int count) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+// kill(pid, 0) still succeeds for a zombie (crashed child not yet reaped by
+// its parent), so also look at the state letter in /proc/<pid>/stat.
+inline bool pid_alive(int32_t pid) {
+    if (pid <= 0) return true; // slot not registered
+    if (kill(pid, 0) != 0 && errno == ESRCH) return false;
+    char path[64], buf[256];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE* f = fopen(path, "r");
+    if (!f) return true; // no procfs: trust kill()
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    const char* paren = strrchr(buf, ')');
+    return !(paren && paren[1] == ' ' && (paren[2] == 'Z' || paren[2] == 'X'));
+}
+
+enum class Status { Ok, Timeout, PeerDead, TooLarge, Closed };
+
+inline const char* to_string(Status s) {
+    switch (s) {
+        case Status::Ok:       return "Ok";
+        case Status::Timeout:  return "Timeout";
+        case Status::PeerDead: return "PeerDead";
+        case Status::TooLarge: return "TooLarge";
+        case Status::Closed:   return "Closed";
+    }
+    return "?";
+}
+
+class ShmRing {
+public:
+    static constexpr int kMaxProducers = 16;
+    static constexpr int kProbeIntervalMs = 50; // how often waiters check peers
+
+private:
+    static constexpr uint32_t kMagic = 0x52494e47; // "RING"
+    static constexpr uint32_t kPad = 1;             // record type: filler to end of buffer
+
+    struct RecordHeader {
+        uint32_t length; // payload bytes
+        uint32_t type;   // 0 = message, kPad = skip to buffer start
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t multi_producer;
+        uint64_t capacity;
+        alignas(64) std::atomic<uint64_t> reserve;
+        alignas(64) std::atomic<uint64_t> commit;
+        alignas(64) std::atomic<uint64_t> tail;
+        alignas(64) std::atomic<uint32_t> data_seq;      // futex: "commit moved"
+        std::atomic<uint32_t> consumer_waiting;
+        std::atomic<uint32_t> space_seq;                 // futex: "tail moved"
+        std::atomic<uint32_t> producers_waiting;
+        std::atomic<uint32_t> closed;
+        std::atomic<uint32_t> poisoned;                  // a reservation can never commit
+        std::atomic<int32_t> consumer_pid;
+        std::atomic<int32_t> producer_pids[kMaxProducers];
+        std::atomic<uint64_t> producer_pending[kMaxProducers]; // reservation start + 1, 0 = none
+    };
+
+    int fd_ = -1;
+    size_t map_size_ = 0;
+    Header* hdr_ = nullptr;
+    char* data_ = nullptr;
+    uint64_t mask_ = 0;
+    int my_slot_ = -1; // this process's producer slot
+
+    static uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+    ShmRing(int fd, size_t map_size, void* base) : fd_(fd), map_size_(map_size) {
+        hdr_ = static_cast<Header*>(base);
+        data_ = static_cast<char*>(base) + sizeof(Header);
+        mask_ = hdr_->capacity - 1;
+    }
+
+    bool any_producer_dead() const {
+        for (auto& p : hdr_->producer_pids) {
+            if (!pid_alive(p.load())) return true;
+        }
+        return false;
+    }
+
+    bool any_producer_registered_alive() const {
+        for (auto& p : hdr_->producer_pids) {
+            int32_t pid = p.load();
+            if (pid > 0 && pid_alive(pid)) return true;
+        }
+        return false;
+    }
+
+    // Is the reservation starting at `pos` (the one `commit` waits for) held
+    // by a dead process? `unchanged` = commit has not moved for a whole probe
+    // interval, which is required before blaming an unknown owner.
+    bool reservation_owner_dead(uint64_t pos, bool unchanged) const {
+        for (int i = 0; i < kMaxProducers; i++) {
+            if (hdr_->producer_pending[i].load() == pos + 1) {
+                return !pid_alive(hdr_->producer_pids[i].load());
+            }
+        }
+        // Owner unregistered, or it died between its CAS and recording it
+        return unchanged && hdr_->reserve.load() != pos && any_producer_dead();
+    }
+
+    void poison() {
+        hdr_->poisoned.store(1, std::memory_order_seq_cst);
+        hdr_->data_seq.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(&hdr_->data_seq, INT_MAX);
+        hdr_->space_seq.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(&hdr_->space_seq, INT_MAX);
+    }
+
+    // Returns remaining ms (or -1 for infinite); 0 means deadline passed.
+    static int remaining_ms(const timespec& start, int timeout_ms) {
+        if (timeout_ms < 0) return -1;
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long elapsed = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+        return elapsed >= timeout_ms ? 0 : int(timeout_ms - elapsed);
+    }
+
+    Status publish(uint64_t start, uint64_t end) {
+        if (hdr_->multi_producer) {
+            // In-order publication: wait for earlier reservations to commit.
+            // An earlier producer is usually just descheduled; every probe
+            // interval, check it is still alive.
+            int spins = 0;
+            timespec last_probe;
+            clock_gettime(CLOCK_MONOTONIC, &last_probe);
+            uint64_t seen = hdr_->commit.load(std::memory_order_acquire);
+            while (seen != start) {
+                if (++spins > 64) sched_yield();
+                if (spins % 1024 == 0) {
+                    if (hdr_->poisoned.load()) return Status::PeerDead;
+                    if (remaining_ms(last_probe, kProbeIntervalMs) == 0) {
+                        uint64_t now = hdr_->commit.load(std::memory_order_acquire);
+                        if (reservation_owner_dead(now, now == seen)) {
+                            poison();
+                            return Status::PeerDead;
+                        }
+                        clock_gettime(CLOCK_MONOTONIC, &last_probe);
+                    }
+                }
+                uint64_t now = hdr_->commit.load(std::memory_order_acquire);
+                if (now != seen) {
+                    seen = now;
+                    clock_gettime(CLOCK_MONOTONIC, &last_probe); // progress: restart the interval
+                }
+            }
+        }
+        hdr_->commit.store(end, std::memory_order_seq_cst);
+        if (my_slot_ >= 0) hdr_->producer_pending[my_slot_].store(0);
+        if (hdr_->consumer_waiting.load(std::memory_order_seq_cst)) {
+            hdr_->data_seq.fetch_add(1, std::memory_order_seq_cst);
+            futex_wake(&hdr_->data_seq, 1);
+        }
+        return Status::Ok;
+    }
+
+public:
+    // capacity_bytes is rounded up to a power of two.
+    static ShmRing create(size_t capacity_bytes, bool multi_producer) {
+        uint64_t cap = 4096;
+        while (cap < capacity_bytes) cap <<= 1;
+        int fd = memfd_create("shm_ring", MFD_CLOEXEC);
+        if (fd < 0) throw std::runtime_error(std::string("memfd_create: ") + strerror(errno));
+        size_t size = sizeof(Header) + cap;
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            throw std::runtime_error(std::string("ftruncate: ") + strerror(errno));
+        }
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error(std::string("mmap: ") + strerror(errno));
+        }
+        auto* hdr = new (base) Header(); // zeroed page; placement-new sets up atomics
+        hdr->magic = kMagic;
+        hdr->multi_producer = multi_producer;
+        hdr->capacity = cap;
+        return ShmRing(fd, size, base);
+    }
+
+    // Map an existing ring from an fd received via fork or SCM_RIGHTS.
+    static ShmRing attach(int fd) {
+        struct { uint32_t magic, multi_producer; uint64_t capacity; } probe{};
+        if (pread(fd, &probe, sizeof(probe), 0) != ssize_t(sizeof(probe)) || probe.magic != kMagic) {
+            throw std::runtime_error("shm ring: bad fd or magic");
+        }
+        size_t size = sizeof(Header) + probe.capacity;
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) throw std::runtime_error(std::string("mmap: ") + strerror(errno));
+        return ShmRing(dup(fd), size, base);
+    }
+
+    ShmRing(ShmRing&& other) noexcept
+        : fd_(other.fd_), map_size_(other.map_size_), hdr_(other.hdr_), data_(other.data_), mask_(other.mask_),
+          my_slot_(other.my_slot_) {
+        other.fd_ = -1;
+        other.hdr_ = nullptr;
+    }
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+    ShmRing& operator=(ShmRing&&) = delete;
+
+    ~ShmRing() {
+        if (hdr_) munmap(hdr_, map_size_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    int fd() const { return fd_; }
+    uint64_t capacity() const { return hdr_->capacity; }
+    uint32_t max_message() const { return uint32_t(hdr_->capacity / 2 - sizeof(RecordHeader)); }
+
+    // Call once in the process that will produce / consume (after fork).
+    void register_producer() {
+        int32_t me = getpid();
+        for (int i = 0; i < kMaxProducers; i++) {
+            auto& slot = hdr_->producer_pids[i];
+            int32_t expected = 0;
+            if (slot.load() == me || slot.compare_exchange_strong(expected, me)) {
+                my_slot_ = i;
+                return;
+            }
+        }
+        throw std::runtime_error("shm ring: too many producers");
+    }
+
+    void register_consumer() { hdr_->consumer_pid.store(getpid()); }
+
+    // Producer side: no more messages. Consumer drains, then gets Closed.
+    void close_writer() {
+        hdr_->closed.store(1, std::memory_order_seq_cst);
+        hdr_->data_seq.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(&hdr_->data_seq, INT_MAX);
+    }
+
+    Status send(const void* payload, uint32_t length, int timeout_ms = -1) {
+        if (length > max_message()) return Status::TooLarge;
+        if (hdr_->poisoned.load()) return Status::PeerDead;
+        const uint64_t need = align8(sizeof(RecordHeader) + length);
+        timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        uint64_t pos, total, end;
+        for (;;) {
+            pos = hdr_->reserve.load(std::memory_order_relaxed);
+            const uint64_t offset = pos & mask_;
+            const uint64_t to_end = hdr_->capacity - offset;
+            total = need <= to_end ? need : to_end + need; // pad the tail if needed
+            end = pos + total;
+
+            if (end - hdr_->tail.load(std::memory_order_acquire) <= hdr_->capacity) {
+                if (!hdr_->multi_producer) {
+                    hdr_->reserve.store(end, std::memory_order_relaxed);
+                    break;
+                }
+                if (hdr_->reserve.compare_exchange_weak(pos, end, std::memory_order_acq_rel)) {
+                    if (my_slot_ >= 0) hdr_->producer_pending[my_slot_].store(pos + 1);
+                    break;
+                }
+                continue; // another producer won the race
+            }
+
+            // Full: announce, re-check, sleep on space_seq
+            const uint32_t seq = hdr_->space_seq.load(std::memory_order_seq_cst);
+            hdr_->producers_waiting.fetch_add(1, std::memory_order_seq_cst);
+            if (end - hdr_->tail.load(std::memory_order_seq_cst) > hdr_->capacity) {
+                int left = remaining_ms(start, timeout_ms);
+                int slice = left < 0 || left > kProbeIntervalMs ? kProbeIntervalMs : left;
+                if (left != 0) futex_wait(&hdr_->space_seq, seq, slice);
+            }
+            hdr_->producers_waiting.fetch_sub(1, std::memory_order_seq_cst);
+            if (hdr_->poisoned.load() || !pid_alive(hdr_->consumer_pid.load())) return Status::PeerDead;
+            if (remaining_ms(start, timeout_ms) == 0) return Status::Timeout;
+        }
+
+        uint64_t offset = pos & mask_;
+        if (total != need) { // write the PAD record, payload starts at buffer offset 0
+            RecordHeader pad{uint32_t(total - need - sizeof(RecordHeader)), kPad};
+            memcpy(data_ + offset, &pad, sizeof(pad));
+            offset = 0;
+        }
+        RecordHeader rec{length, 0};
+        memcpy(data_ + offset, &rec, sizeof(rec));
+        memcpy(data_ + offset + sizeof(rec), payload, length);
+        return publish(pos, end);
+    }
+
+    // Zero-copy receive: fn(const char* data, uint32_t length) runs on the
+    // record while it is still inside the ring.
+    template <typename Fn>
+    Status consume(Fn&& fn, int timeout_ms = -1) {
+        timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        const uint64_t tail = hdr_->tail.load(std::memory_order_relaxed);
+
+        int spins = 0;
+        while (hdr_->commit.load(std::memory_order_acquire) == tail) {
+            if (++spins < 100) continue; // brief spin: cheap if the producer is mid-write
+            if (hdr_->poisoned.load()) return Status::PeerDead;
+            if (hdr_->closed.load()) return Status::Closed;
+
+            const uint32_t seq = hdr_->data_seq.load(std::memory_order_seq_cst);
+            hdr_->consumer_waiting.store(1, std::memory_order_seq_cst);
+            if (hdr_->commit.load(std::memory_order_seq_cst) == tail && !hdr_->closed.load()) {
+                int left = remaining_ms(start, timeout_ms);
+                int slice = left < 0 || left > kProbeIntervalMs ? kProbeIntervalMs : left;
+                long rc = left == 0 ? -1 : futex_wait(&hdr_->data_seq, seq, slice);
+                if (rc != 0 && errno == ETIMEDOUT) {
+                    // Stalled reservation by a dead producer, or nobody left to write.
+                    // commit == tail for the whole slice, so it did not move.
+                    if (hdr_->reserve.load() != tail && reservation_owner_dead(tail, true)) {
+                        hdr_->consumer_waiting.store(0);
+                        poison();
+                        return Status::PeerDead;
+                    }
+                    if (hdr_->commit.load() == tail && !any_producer_registered_alive() &&
+                        any_producer_dead()) {
+                        hdr_->consumer_waiting.store(0);
+                        return Status::PeerDead;
+                    }
+                }
+            }
+            hdr_->consumer_waiting.store(0, std::memory_order_relaxed);
+            if (remaining_ms(start, timeout_ms) == 0 &&
+                hdr_->commit.load(std::memory_order_acquire) == tail) {
+                return Status::Timeout;
+            }
+        }
+
+        uint64_t pos = tail;
+        RecordHeader rec;
+        memcpy(&rec, data_ + (pos & mask_), sizeof(rec));
+        if (rec.type == kPad) {
+            pos += sizeof(RecordHeader) + rec.length; // jump to buffer start
+            memcpy(&rec, data_ + (pos & mask_), sizeof(rec));
+        }
+        fn(data_ + (pos & mask_) + sizeof(RecordHeader), rec.length);
+        pos += align8(sizeof(RecordHeader) + rec.length);
+
+        hdr_->tail.store(pos, std::memory_order_seq_cst);
+        if (hdr_->producers_waiting.load(std::memory_order_seq_cst)) {
+            hdr_->space_seq.fetch_add(1, std::memory_order_seq_cst);
+            futex_wake(&hdr_->space_seq, INT_MAX);
+        }
+        return Status::Ok;
+    }
+
+    Status receive(std::string& out, int timeout_ms = -1) {
+        return consume([&](const char* p, uint32_t n) { out.assign(p, n); }, timeout_ms);
+    }
+};
+
+} // namespace shm
+
+#endif // SHM_RING_H
@@ -0,0 +1,405 @@
+/**
+ * tcache_allocator.h - Thread-local caching small-object allocator
+ *
+ * WHAT IT IS:
+ * ===========
+ * The thread_local demo in 04_thread_memory_layout.cpp shows that per-thread
+ * data needs no locking. This allocator applies that idea to the heap: each
+ * thread allocates and frees small objects from its OWN free lists, and only
+ * touches shared state in batches.
+ *
+ * LAYERS (fast path first):
+ * =========================
+ *
+ *   allocate(n)                                   deallocate(p, n)
+ *       │                                              │
+ *       ▼                                              ▼
+ *   ┌───────────────────────────┐   owner == me?  ┌──────────────────────┐
+ *   │ ThreadCache (thread_local)│◄────── yes ─────┤ span header of p     │
+ *   │ local[class] free lists   │                 │ (64KB-aligned span)  │
+ *   └──────┬────────────────────┘                 └──────┬───────────────┘
+ *          │ empty                                       │ no: remote free
+ *          ▼                                             ▼
+ *   1. reclaim remote[class]  ◄──── CAS push (batched) ── pending batch
+ *      (one exchange takes the whole chain)
+ *   2. Depot: take a batch (mutex per size class)   ◄── local list too long:
+ *   3. carve a new 64KB span (bump pointer)               return one batch
+ *
+ * - Size classes 16..1024 bytes; larger requests go to ::operator new.
+ * - Every span starts with a header {owner heap, size class}; a pointer's
+ *   span is found by masking the low 16 bits - no per-object header.
+ * - Remote frees (object freed by a thread that did not carve it) are
+ *   collected into per-class chains and pushed onto the owner's lock-free
+ *   remote[class] stack with ONE CAS. The owner pops the whole stack with ONE
+ *   exchange when its local list runs dry: in a producer/consumer pipeline the
+ *   objects flow straight back to the producer.
+ * - Thread exit: local lists go to the depot, the heap is parked and adopted
+ *   by the next new thread (with any remote frees that arrived meanwhile).
+ * - Spans are never returned to the OS (keeps the example small).
+ *
+ * Counters are written only by the owning thread (relaxed load + store, no
+ * lock prefix) and summed on demand by stats().
+ */
+
+#ifndef TCACHE_ALLOCATOR_H
+#define TCACHE_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace tcache {
+
+constexpr size_t kSpanSize = 64 * 1024;
+constexpr size_t kMaxSmall = 1024;
+constexpr int kNumClasses = 12;
+constexpr size_t kClassSize[kNumClasses] = {16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024};
+
+// (n + 15) / 16 -> size class, built at compile time.
+struct ClassTable {
+    uint8_t cls[kMaxSmall / 16 + 1] = {};
+    constexpr ClassTable() {
+        int c = 0;
+        for (size_t i = 0; i <= kMaxSmall / 16; i++) {
+            while (kClassSize[c] < i * 16) c++;
+            cls[i] = uint8_t(c);
+        }
+    }
+};
+constexpr ClassTable kClassTable{};
+
+inline int class_of(size_t n) { return kClassTable.cls[(n + 15) / 16]; }
+
+// Objects moved per depot/remote transfer: ~8KB, between 8 and 64 objects.
+inline uint32_t batch_of(int c) {
+    size_t b = 8192 / kClassSize[c];
+    return uint32_t(b < 8 ? 8 : b > 64 ? 64 : b);
+}
+
+struct FreeNode {
+    FreeNode* next;
+};
+
+struct Stats {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;            // small frees, local + remote
+    uint64_t remote_frees = 0;     // freed by a thread that does not own the span
+    uint64_t remote_pushes = 0;    // CAS pushes (each carries a batch)
+    uint64_t remote_reclaimed = 0; // objects taken back from remote stacks
+    uint64_t depot_refills = 0;
+    uint64_t depot_returns = 0;
+    uint64_t spans = 0;            // 64KB spans carved
+    uint64_t large = 0;            // > kMaxSmall, forwarded to ::operator new
+    uint64_t heaps = 0;            // heaps ever created (threads are recycled onto them)
+};
+
+class Heap;
+
+struct alignas(64) SpanHeader {
+    Heap* owner;
+    uint32_t size_class;
+};
+
+inline SpanHeader* span_of(void* p) {
+    return reinterpret_cast<SpanHeader*>(reinterpret_cast<uintptr_t>(p) & ~(kSpanSize - 1));
+}
+
+// Owner-only counter: plain load/store (no RMW) keeps the fast path lock-free.
+struct Counter {
+    std::atomic<uint64_t> v{0};
+    void add(uint64_t n = 1) { v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    uint64_t get() const { return v.load(std::memory_order_relaxed); }
+};
+
+class Heap {
+public:
+    FreeNode* local[kNumClasses] = {};
+    uint32_t count[kNumClasses] = {};
+    char* bump[kNumClasses] = {};
+    char* bump_end[kNumClasses] = {};
+    alignas(64) std::atomic<FreeNode*> remote[kNumClasses] = {};
+
+    Counter allocs, frees, remote_frees, remote_pushes, remote_reclaimed;
+    Counter depot_refills, depot_returns, spans, large;
+};
+
+// Global per-class stacks of batches. Touched once per batch, never per object.
+class Depot {
+    struct Batch {
+        FreeNode* head;
+        uint32_t count;
+    };
+    struct alignas(64) Bin {
+        std::mutex m;
+        std::vector<Batch> batches;
+    };
+    Bin bins_[kNumClasses];
+
+public:
+    static Depot& instance() {
+        static Depot* depot = new Depot; // never destroyed: threads may exit after main
+        return *depot;
+    }
+
+    bool take(int c, FreeNode*& head, uint32_t& count) {
+        std::lock_guard<std::mutex> lock(bins_[c].m);
+        if (bins_[c].batches.empty()) return false;
+        head = bins_[c].batches.back().head;
+        count = bins_[c].batches.back().count;
+        bins_[c].batches.pop_back();
+        return true;
+    }
+
+    void put(int c, FreeNode* head, uint32_t count) {
+        std::lock_guard<std::mutex> lock(bins_[c].m);
+        bins_[c].batches.push_back({head, count});
+    }
+};
+
+// All heaps ever created; parked ones are reused by new threads.
+class Registry {
+    std::mutex m_;
+    std::vector<Heap*> all_;
+    std::vector<Heap*> parked_;
+
+public:
+    static Registry& instance() {
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    Heap* adopt() {
+        std::lock_guard<std::mutex> lock(m_);
+        if (!parked_.empty()) {
+            Heap* h = parked_.back();
+            parked_.pop_back();
+            return h;
+        }
+        all_.push_back(new Heap);
+        return all_.back();
+    }
+
+    void park(Heap* h) {
+        std::lock_guard<std::mutex> lock(m_);
+        parked_.push_back(h);
+    }
+
+    Stats stats() {
+        std::lock_guard<std::mutex> lock(m_);
+        Stats s;
+        for (Heap* h : all_) {
+            s.allocs += h->allocs.get();
+            s.frees += h->frees.get();
+            s.remote_frees += h->remote_frees.get();
+            s.remote_pushes += h->remote_pushes.get();
+            s.remote_reclaimed += h->remote_reclaimed.get();
+            s.depot_refills += h->depot_refills.get();
+            s.depot_returns += h->depot_returns.get();
+            s.spans += h->spans.get();
+            s.large += h->large.get();
+        }
+        s.heaps = all_.size();
+        return s;
+    }
+};
+
+class ThreadCache {
+    Heap* heap_;
+
+    // Remote frees waiting to be pushed, per class, all for ONE owner heap
+    // (the common case: a consumer frees what a single producer allocated).
+    Heap* pend_owner_ = nullptr;
+    FreeNode* pend_head_[kNumClasses] = {};
+    FreeNode* pend_tail_[kNumClasses] = {};
+    uint32_t pend_count_[kNumClasses] = {};
+
+    FreeNode* carve(int c) {
+        const size_t size = kClassSize[c];
+        if (heap_->bump[c] + size > heap_->bump_end[c]) {
+            void* mem = std::aligned_alloc(kSpanSize, kSpanSize);
+            if (!mem) throw std::bad_alloc();
+            SpanHeader* span = new (mem) SpanHeader{heap_, uint32_t(c)};
+            heap_->bump[c] = reinterpret_cast<char*>(span) + sizeof(SpanHeader);
+            heap_->bump_end[c] = reinterpret_cast<char*>(span) + kSpanSize;
+            heap_->spans.add();
+        }
+        // Carve one batch; the rest of the span stays behind the bump pointer.
+        FreeNode* head = nullptr;
+        uint32_t n = 0;
+        while (n < batch_of(c) && heap_->bump[c] + size <= heap_->bump_end[c]) {
+            FreeNode* node = reinterpret_cast<FreeNode*>(heap_->bump[c]);
+            heap_->bump[c] += size;
+            node->next = head;
+            head = node;
+            n++;
+        }
+        heap_->count[c] = n;
+        return head;
+    }
+
+public:
+    ThreadCache() : heap_(Registry::instance().adopt()) {}
+
+    ~ThreadCache() {
+        flush_remote();
+        for (int c = 0; c < kNumClasses; c++) {
+            while (heap_->local[c]) return_batch(c);
+        }
+        Registry::instance().park(heap_);
+    }
+
+    Heap* heap() const { return heap_; }
+
+    FreeNode* refill(int c) {
+        // 1. Objects other threads freed back to us: take the whole chain.
+        FreeNode* head = heap_->remote[c].exchange(nullptr, std::memory_order_acquire);
+        if (head) {
+            uint32_t n = 0;
+            for (FreeNode* p = head; p; p = p->next) n++;
+            heap_->count[c] = n;
+            heap_->remote_reclaimed.add(n);
+            return head;
+        }
+        // 2. A batch somebody returned to the depot.
+        uint32_t n;
+        if (Depot::instance().take(c, head, n)) {
+            heap_->count[c] = n;
+            heap_->depot_refills.add();
+            return head;
+        }
+        // 3. Fresh memory.
+        return carve(c);
+    }
+
+    // Moves one batch from the local list to the depot.
+    void return_batch(int c) {
+        FreeNode* head = heap_->local[c];
+        FreeNode* tail = head;
+        uint32_t n = 1;
+        while (n < batch_of(c) && tail->next) {
+            tail = tail->next;
+            n++;
+        }
+        heap_->local[c] = tail->next;
+        heap_->count[c] -= n;
+        tail->next = nullptr;
+        Depot::instance().put(c, head, n);
+        heap_->depot_returns.add();
+    }
+
+    void remote_free(Heap* owner, int c, FreeNode* node) {
+        if (owner != pend_owner_) {
+            flush_remote();
+            pend_owner_ = owner;
+        }
+        node->next = pend_head_[c];
+        pend_head_[c] = node;
+        if (!pend_tail_[c]) pend_tail_[c] = node;
+        heap_->remote_frees.add();
+        if (++pend_count_[c] >= batch_of(c)) push_remote(c);
+    }
+
+    // One CAS publishes a whole pending chain on the owner's remote stack.
+    void push_remote(int c) {
+        std::atomic<FreeNode*>& top = pend_owner_->remote[c];
+        FreeNode* old = top.load(std::memory_order_relaxed);
+        do {
+            pend_tail_[c]->next = old;
+        } while (!top.compare_exchange_weak(old, pend_head_[c], std::memory_order_release,
+                                            std::memory_order_relaxed));
+        heap_->remote_pushes.add();
+        pend_head_[c] = pend_tail_[c] = nullptr;
+        pend_count_[c] = 0;
+    }
+
+    void flush_remote() {
+        for (int c = 0; c < kNumClasses; c++) {
+            if (pend_head_[c]) push_remote(c);
+        }
+    }
+};
+
+inline ThreadCache& thread_cache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+inline void* allocate(size_t n) {
+    ThreadCache& tc = thread_cache();
+    Heap& h = *tc.heap();
+    if (n > kMaxSmall) {
+        h.large.add();
+        return ::operator new(n);
+    }
+    const int c = class_of(n ? n : 1);
+    FreeNode* node = h.local[c];
+    if (!node) node = tc.refill(c);
+    h.local[c] = node->next;
+    h.count[c]--;
+    h.allocs.add();
+    return node;
+}
+
+// Sized free, like std::allocator::deallocate: `n` must match allocate(n).
+inline void deallocate(void* p, size_t n) {
+    if (!p) return;
+    if (n > kMaxSmall) {
+        ::operator delete(p);
+        return;
+    }
+    ThreadCache& tc = thread_cache();
+    Heap& h = *tc.heap();
+    SpanHeader* span = span_of(p);
+    const int c = int(span->size_class);
+    FreeNode* node = static_cast<FreeNode*>(p);
+    h.frees.add();
+
+    if (span->owner != &h) {
+        tc.remote_free(span->owner, c, node);
+        return;
+    }
+    node->next = h.local[c];
+    h.local[c] = node;
+    if (++h.count[c] > 2 * batch_of(c)) tc.return_batch(c);
+}
+
+// Pushes this thread's pending remote frees now (otherwise: at batch size or exit).
+inline void flush() { thread_cache().flush_remote(); }
+
+inline Stats stats() { return Registry::instance().stats(); }
+
+template <typename T, typename... Args>
+T* make(Args&&... args) {
+    return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void destroy(T* p) {
+    if (!p) return;
+    p->~T();
+    deallocate(p, sizeof(T));
+}
+
+// std::allocator-compatible adaptor (node containers: list, map, ...).
+template <typename T>
+struct Allocator {
+    using value_type = T;
+    Allocator() = default;
+    template <typename U>
+    Allocator(const Allocator<U>&) {}
+    T* allocate(size_t n) { return static_cast<T*>(tcache::allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { tcache::deallocate(p, n * sizeof(T)); }
+    template <typename U>
+    bool operator==(const Allocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const Allocator<U>&) const { return false; }
+};
+
+} // namespace tcache
+
+#endif // TCACHE_ALLOCATOR_H
@@ -0,0 +1,247 @@
+/**
+ * thread_stack.h - Threads with explicit stack sizes + stack high-water profiler
+ *
+ * WHY:
+ * ====
+ * std::thread always uses the default stack: RLIMIT_STACK (usually 8MB) of
+ * address space per thread, plus a guard page. 10,000 threads reserve ~80GB
+ * of virtual memory and the page tables to map whatever they touch, even if
+ * each thread only ever uses a few KB. To size stacks SAFELY you must know the
+ * real peak usage of each thread function - so measure it.
+ *
+ * WHAT IT PROVIDES:
+ * =================
+ *   tstack::Thread t(fn, opts);   pthread with opts.size bytes of stack
+ *   t.join();                     records peak usage when opts.paint is set
+ *   tstack::profiler().print()    peak per thread function + recommendation
+ *
+ * STACK SOURCES:
+ * ==============
+ *   opts.paint / opts.huge_pages == false:
+ *       pthread_attr_setstacksize + pthread_attr_setguardsize; glibc mmaps
+ *       (and caches) the stack.
+ *   opts.paint or opts.huge_pages:
+ *       we mmap the stack ourselves and pass it with pthread_attr_setstack:
+ *
+ *       low addr                                          high addr
+ *       ┌──────────┬──────────────────────────────────────────────┐
+ *       │ guard    │ A5 A5 A5 A5 ... A5 │ used ◄─ grows down ── TLS│
+ *       │ PROT_NONE│  (untouched paint)  │   (high-water mark)      │
+ *       └──────────┴──────────────────────────────────────────────┘
+ *
+ *       - guard: PROT_NONE pages, overflow = SIGSEGV instead of silent
+ *         corruption of the neighbouring mapping
+ *       - huge_pages: 2MB-aligned + MADV_HUGEPAGE (one TLB entry per 2MB)
+ *       - paint: fill with 0xA5 before start; after join, the first byte
+ *         (from the bottom) that is not 0xA5 is the deepest point reached.
+ *         glibc places the thread descriptor and static TLS at the TOP of a
+ *         user-supplied stack, so they are counted too - they are real usage.
+ *
+ * Painting touches every page, so it is a PROFILING mode: use it in a test
+ * run, then ship the recommended size without painting.
+ */
+
+#ifndef THREAD_STACK_H
+#define THREAD_STACK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace tstack {
+
+constexpr unsigned char kPaint = 0xA5;
+constexpr size_t kHugePage = 2 * 1024 * 1024;
+
+struct StackOptions {
+    size_t size = 0;              // 0 = default (RLIMIT_STACK, usually 8MB)
+    size_t guard = 4096;          // PROT_NONE bytes below the stack
+    bool huge_pages = false;      // 2MB-aligned stack with MADV_HUGEPAGE
+    bool paint = false;           // measure the high-water mark (profiling)
+    std::string name = "thread";  // profiler key: usually the thread function
+};
+
+inline size_t page_size() {
+    static const size_t page = size_t(sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+inline size_t round_up(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+inline size_t min_stack() {
+    long m = sysconf(_SC_THREAD_STACK_MIN);
+    return m > 0 ? size_t(m) : 16384;
+}
+
+class StackProfiler {
+    struct Entry {
+        uint64_t runs = 0;
+        size_t peak = 0;
+        size_t stack_size = 0;
+    };
+    std::mutex m_;
+    std::map<std::string, Entry> entries_;
+
+public:
+    void record(const std::string& name, size_t stack_size, size_t used) {
+        std::lock_guard<std::mutex> lock(m_);
+        Entry& e = entries_[name];
+        e.runs++;
+        e.peak = std::max(e.peak, used);
+        e.stack_size = stack_size;
+    }
+
+    size_t peak(const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_);
+        auto it = entries_.find(name);
+        return it == entries_.end() ? 0 : it->second.peak;
+    }
+
+    // Peak x 2 (headroom for paths the profiling run did not take), rounded up
+    // to whole pages, never below PTHREAD_STACK_MIN.
+    size_t recommend(const std::string& name) {
+        return std::max(min_stack(), round_up(peak(name) * 2, page_size()));
+    }
+
+    void print(std::ostream& os) {
+        std::map<std::string, Entry> copy;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            copy = entries_;
+        }
+        os << std::left << std::setw(22) << "thread function" << std::right << std::setw(6) << "runs"
+           << std::setw(14) << "stack (KB)" << std::setw(14) << "peak (KB)" << std::setw(18)
+           << "recommend (KB)" << "\n";
+        for (auto& [name, e] : copy) {
+            os << std::left << std::setw(22) << name << std::right << std::setw(6) << e.runs
+               << std::setw(14) << e.stack_size / 1024 << std::setw(14) << std::fixed
+               << std::setprecision(1) << e.peak / 1024.0 << std::setw(18) << recommend(name) / 1024
+               << std::defaultfloat << "\n";
+        }
+    }
+};
+
+inline StackProfiler& profiler() {
+    static StackProfiler p;
+    return p;
+}
+
+class Thread {
+    pthread_t tid_{};
+    bool joinable_ = false;
+    StackOptions opt_;
+    void* map_ = nullptr; // our own mapping (guard + stack), if any
+    size_t map_size_ = 0;
+    char* stack_ = nullptr;
+    size_t stack_size_ = 0;
+
+    static void* trampoline(void* arg) {
+        std::function<void()>* fn = static_cast<std::function<void()>*>(arg);
+        (*fn)();
+        delete fn;
+        return nullptr;
+    }
+
+    void map_own_stack() {
+        const size_t align = opt_.huge_pages ? kHugePage : page_size();
+        stack_size_ = round_up(stack_size_, align);
+        const size_t guard = round_up(opt_.guard, page_size());
+
+        // Over-allocate so the stack itself can start on a 2MB boundary.
+        map_size_ = guard + stack_size_ + (opt_.huge_pages ? kHugePage : 0);
+        map_ = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+        if (map_ == MAP_FAILED) throw std::runtime_error("tstack: mmap failed");
+
+        uintptr_t lo = reinterpret_cast<uintptr_t>(map_) + guard;
+        stack_ = reinterpret_cast<char*>(round_up(lo, align));
+        if (guard) mprotect(stack_ - guard, guard, PROT_NONE);
+        if (opt_.huge_pages) madvise(stack_, stack_size_, MADV_HUGEPAGE);
+        if (opt_.paint) memset(stack_, kPaint, stack_size_);
+    }
+
+    // Bytes from the top of the stack down to the deepest painted byte overwritten.
+    size_t high_water() const {
+        size_t untouched = 0;
+        const uint64_t pattern = 0xA5A5A5A5A5A5A5A5ull;
+        const uint64_t* w = reinterpret_cast<const uint64_t*>(stack_);
+        while (untouched + 8 <= stack_size_ && *w == pattern) {
+            w++;
+            untouched += 8;
+        }
+        while (untouched < stack_size_ && static_cast<unsigned char>(stack_[untouched]) == kPaint) {
+            untouched++;
+        }
+        return stack_size_ - untouched;
+    }
+
+public:
+    Thread(std::function<void()> fn, StackOptions opt = {}) : opt_(std::move(opt)) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_getstacksize(&attr, &stack_size_); // default, follows RLIMIT_STACK
+        if (opt_.size) stack_size_ = std::max(round_up(opt_.size, page_size()), min_stack());
+
+        if (opt_.paint || opt_.huge_pages) {
+            map_own_stack();
+            pthread_attr_setstack(&attr, stack_, stack_size_);
+        } else {
+            pthread_attr_setstacksize(&attr, stack_size_);
+            pthread_attr_setguardsize(&attr, opt_.guard);
+        }
+
+        auto* arg = new std::function<void()>(std::move(fn));
+        int rc = pthread_create(&tid_, &attr, trampoline, arg);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            delete arg;
+            if (map_) munmap(map_, map_size_);
+            throw std::runtime_error(std::string("tstack: pthread_create: ") + strerror(rc));
+        }
+        joinable_ = true;
+    }
+
+    Thread(Thread&& other) noexcept
+        : tid_(other.tid_), joinable_(other.joinable_), opt_(std::move(other.opt_)),
+          map_(other.map_), map_size_(other.map_size_), stack_(other.stack_),
+          stack_size_(other.stack_size_) {
+        other.joinable_ = false;
+        other.map_ = nullptr;
+    }
+
+    Thread(const Thread&) = delete;
+    Thread& operator=(const Thread&) = delete;
+    Thread& operator=(Thread&&) = delete;
+
+    ~Thread() {
+        if (joinable_) join();
+    }
+
+    void join() {
+        if (!joinable_) return;
+        pthread_join(tid_, nullptr);
+        joinable_ = false;
+        if (opt_.paint) profiler().record(opt_.name, stack_size_, high_water());
+        if (map_) {
+            munmap(map_, map_size_);
+            map_ = nullptr;
+        }
+    }
+
+    size_t stack_size() const { return stack_size_; }
+};
+
+} // namespace tstack
+
+#endif // THREAD_STACK_H
@@ -0,0 +1,215 @@
+/**
+ * topology.h - CPU/NUMA topology discovery and thread placement
+ *
+ * WHY:
+ * ====
+ * hardware_concurrency() says HOW MANY logical CPUs exist, not WHAT they are.
+ * On a 2-socket machine with SMT, "16 CPUs" may be 2 nodes x 4 cores x 2
+ * hyperthreads. Two threads on SMT siblings share one core's ALUs and L1/L2;
+ * a thread on node 1 reading memory that node 0 first touched pays the
+ * interconnect hop on every cache miss.
+ *
+ * WHERE THE KERNEL EXPOSES IT:
+ * ============================
+ *   /sys/devices/system/cpu/online                      "0-15"
+ *   /sys/devices/system/cpu/cpuN/topology/core_id       physical core number
+ *   /sys/devices/system/cpu/cpuN/topology/physical_package_id   socket
+ *   /sys/devices/system/cpu/cpuN/topology/thread_siblings_list  "3,11"
+ *   /sys/devices/system/node/nodeM/cpulist              CPUs of NUMA node M
+ *
+ * PLACEMENT ORDER (Topology::placement_order):
+ * ============================================
+ *   1. first hardware thread of every physical core, nodes interleaved
+ *      (node0 core0, node1 core0, node0 core1, ...) - spreads memory bandwidth
+ *   2. then the SMT siblings, in the same order
+ * Only CPUs in this process's affinity mask are used (taskset/cgroups).
+ *
+ * NODE-LOCAL MEMORY:
+ * ==================
+ * Linux's default policy is FIRST TOUCH: a page lands on the node of the CPU
+ * that first writes it. So a pinned worker that allocates AND initializes its
+ * own data gets local memory without libnuma (alloc_local()).
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+namespace topo {
+
+struct Cpu {
+    int id = 0;
+    int core = 0;      // core_id (unique per package)
+    int package = 0;   // socket
+    int node = 0;      // NUMA node id as sysfs names it (may be sparse: node0, node2)
+    int node_index = 0; // dense 0..nodes()-1: use this to index per-node arrays
+    int smt_index = 0; // 0 = first hardware thread of its core
+};
+
+// Parses the kernel's cpulist format: "0-3,8,10-11".
+inline std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        if (part.empty() || part == "\n") continue;
+        size_t dash = part.find('-');
+        int lo = std::stoi(part.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+        for (int c = lo; c <= hi; c++) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+inline bool read_line(const std::string& path, std::string& out) {
+    std::ifstream in(path);
+    return bool(std::getline(in, out));
+}
+
+inline int read_int(const std::string& path, int fallback) {
+    std::string s;
+    return read_line(path, s) && !s.empty() ? std::stoi(s) : fallback;
+}
+
+class Topology {
+    std::vector<Cpu> cpus_;
+    int nodes_ = 1;
+    int cores_ = 0;
+
+public:
+    static Topology discover() {
+        Topology t;
+        const std::string base = "/sys/devices/system/cpu/";
+
+        std::string online;
+        std::vector<int> ids = read_line(base + "online", online) ? parse_cpu_list(online)
+                                                                  : std::vector<int>{};
+        cpu_set_t mask;
+        bool have_mask = sched_getaffinity(0, sizeof(mask), &mask) == 0;
+        if (ids.empty() && have_mask) {
+            for (int c = 0; c < CPU_SETSIZE; c++) {
+                if (CPU_ISSET(c, &mask)) ids.push_back(c);
+            }
+        }
+
+        // cpu -> node from /sys/devices/system/node/nodeM/cpulist
+        std::map<int, int> node_of;
+        for (int n = 0; n < 64; n++) { // node ids may be sparse
+            std::string list;
+            if (!read_line("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist", list)) continue;
+            for (int c : parse_cpu_list(list)) node_of[c] = n;
+        }
+
+        std::set<std::pair<int, int>> cores; // (package, core)
+        std::set<int> nodes;
+        for (int id : ids) {
+            if (have_mask && !CPU_ISSET(id, &mask)) continue; // not ours to use
+            const std::string dir = base + "cpu" + std::to_string(id) + "/topology/";
+            Cpu c;
+            c.id = id;
+            c.core = read_int(dir + "core_id", id);
+            c.package = read_int(dir + "physical_package_id", 0);
+            c.node = node_of.count(id) ? node_of[id] : 0;
+
+            std::string siblings;
+            if (read_line(dir + "thread_siblings_list", siblings)) {
+                std::vector<int> sib = parse_cpu_list(siblings);
+                c.smt_index = int(std::find(sib.begin(), sib.end(), id) - sib.begin());
+            }
+            cores.insert({c.package, c.core});
+            nodes.insert(c.node);
+            t.cpus_.push_back(c);
+        }
+        if (t.cpus_.empty()) t.cpus_.push_back(Cpu{}); // no sysfs: pretend one CPU
+        for (Cpu& c : t.cpus_) { // rank of c.node among the nodes we use
+            c.node_index = int(std::distance(nodes.begin(), nodes.find(c.node)));
+        }
+        t.cores_ = std::max<int>(1, int(cores.size()));
+        t.nodes_ = std::max<int>(1, int(nodes.size()));
+        return t;
+    }
+
+    const std::vector<Cpu>& cpus() const { return cpus_; }
+    int nodes() const { return nodes_; }
+    int cores() const { return cores_; }
+
+    const Cpu& cpu(int id) const {
+        for (const Cpu& c : cpus_) {
+            if (c.id == id) return c;
+        }
+        return cpus_.front();
+    }
+
+    // Physical cores first (interleaving nodes), then SMT siblings.
+    std::vector<int> placement_order() const {
+        std::vector<Cpu> sorted = cpus_;
+        // Key: (smt_index, rank of the core within its node, node) -> cpu id
+        std::vector<std::pair<std::tuple<int, int, int>, int>> keyed;
+        std::map<std::pair<int, int>, int> counter; // (smt_index, node) -> cores seen
+        std::sort(sorted.begin(), sorted.end(), [](const Cpu& a, const Cpu& b) {
+            return std::tie(a.node, a.package, a.core, a.id) < std::tie(b.node, b.package, b.core, b.id);
+        });
+        for (const Cpu& c : sorted) {
+            int rank = counter[{c.smt_index, c.node}]++;
+            keyed.push_back({{c.smt_index, rank, c.node}, c.id});
+        }
+        std::sort(keyed.begin(), keyed.end());
+        std::vector<int> order;
+        for (auto& k : keyed) order.push_back(k.second);
+        return order;
+    }
+
+    void print(std::ostream& os) const {
+        os << "Topology: " << cpus_.size() << " usable CPU(s), " << cores_ << " physical core(s), "
+           << nodes_ << " NUMA node(s)\n";
+        for (const Cpu& c : cpus_) {
+            os << "  cpu" << c.id << ": node " << c.node << ", package " << c.package << ", core "
+               << c.core << (c.smt_index ? " (SMT sibling)" : "") << "\n";
+        }
+    }
+};
+
+inline bool pin_current_thread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// Maps n objects and touches every page from the CALLING thread, so under
+// the first-touch policy they live on that thread's node. Free with free_local.
+// The memory is zero-filled, not constructed: only for trivial types.
+template <typename T>
+T* alloc_local(size_t n) {
+    static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                  "alloc_local returns zeroed memory without running constructors");
+    void* p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    memset(p, 0, n * sizeof(T));
+    return static_cast<T*>(p);
+}
+
+template <typename T>
+void free_local(T* p, size_t n) {
+    if (p) munmap(p, n * sizeof(T));
+}
+
+} // namespace topo
+
+#endif // TOPOLOGY_H
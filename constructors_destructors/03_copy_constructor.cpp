@@ -1,8 +1,12 @@
 #include <iostream>
 #include <string>
 #include <cstring>
+#include <vector>
+#include "copy_profiler.h"
 using namespace std;
 
+COPY_PROFILER_HOOK_NEW  // count every heap allocation (see copy_profiler.h)
+
 /*
  * COPY CONSTRUCTOR
  * ================
@@ -15,6 +19,9 @@ using namespace std;
  * ANSWER: A copy constructor is a constructor that initializes an object using
  * another object of the same class. It takes a reference to an object of the
  * same class as a parameter.
+ *
+ * EXAMPLE 4 measures what copies cost: copy_profiler.h counts copies, moves
+ * and allocations per type and per call path.
  */
 
 // ============================================================================
@@ -117,12 +124,14 @@ public:
     }
 };
 
-class DeepCopyExample {
+class DeepCopyExample : public profile::Profiled<DeepCopyExample> {
 private:
     int *ptr;
     int size;
 
 public:
+    static constexpr const char* profile_name = "DeepCopyExample";
+
     DeepCopyExample(int s) {
         size = s;
         ptr = new int[size];
@@ -133,7 +142,8 @@ public:
     }
 
     // Deep Copy Constructor - Creates NEW memory
-    DeepCopyExample(const DeepCopyExample &obj) {
+    // (Profiled(obj): a hand-written copy must call the base copy to be counted)
+    DeepCopyExample(const DeepCopyExample &obj) : Profiled(obj) {
         size = obj.size;
         ptr = new int[size];  // Allocate NEW memory
         for(int i = 0; i < size; i++) {
@@ -194,6 +204,85 @@ Demo functionReturningObject() {
     return temp;  // Copy constructor may be called (or optimized away)
 }
 
+// ============================================================================
+// EXAMPLE 4: PROFILING COPIES ON REAL CALL PATHS
+// ============================================================================
+// The Array of 08_special_cases.cpp, instrumented. Every path below does the
+// same job (read 1000 ints); the profiler shows which ones pay for a deep copy.
+
+class Array : public profile::Profiled<Array> {
+private:
+    vector<int> data;
+
+public:
+    static constexpr const char* profile_name = "Array";
+
+    explicit Array(int n) : data(n, 1) {}
+    // Copy/move are the defaults: they copy/move `data` AND the Profiled base
+    long sum() const {
+        long total = 0;
+        for (int v : data) total += v;
+        return total;
+    }
+};
+
+long processArray(Array a) {             // by value: a copy from every lvalue
+    return a.sum();
+}
+
+long processArrayRef(const Array& a) {   // read-only: no copy at all
+    return a.sum();
+}
+
+Array makeArray(int n) {
+    Array local(n);
+    return local;                        // NRVO: built in the caller's object
+}
+
+void profile_call_paths() {
+    profile::reset();
+    Array arr(1000);
+    long total = 0;
+    {
+        profile::Scope path("processArray(arr)");
+        total += processArray(arr);
+    }
+    {
+        profile::Scope path("processArray(std::move(tmp))");
+        Array tmp(1000);
+        total += processArray(std::move(tmp));
+    }
+    {
+        profile::Scope path("processArrayRef(arr)");
+        total += processArrayRef(arr);
+    }
+    {
+        profile::Scope path("makeArray(1000)");
+        Array made = makeArray(1000);
+        total += made.sum();
+    }
+    vector<Array> arrays;
+    {
+        profile::Scope path("vector push_back(arr) x16");
+        for (int i = 0; i < 16; i++) arrays.push_back(arr);  // copies + growth moves
+    }
+    {
+        profile::Scope path("for (auto a : arrays)");
+        for (auto a : arrays) total += a.sum();               // copies every element!
+    }
+    {
+        profile::Scope path("for (const auto& a : arrays)");
+        for (const auto& a : arrays) total += a.sum();
+    }
+    {
+        profile::Scope path("DeepCopyExample copy");
+        DeepCopyExample original(1000);
+        DeepCopyExample copy = original;
+    }
+    cout << "(sum " << total << ")" << endl;
+    profile::report(cout);
+}
+
 // ============================================================================
 // MAIN FUNCTION
 // ============================================================================
@@ -264,6 +353,9 @@ int main() {
     cout << "\n3. Object returned from function:" << endl;
     Demo d4 = functionReturningObject();  // May be optimized (RVO)
     
+    cout << "\n=== EXAMPLE 4: COPIES AND ALLOCATIONS PER CALL PATH ===" << endl;
+    profile_call_paths();
+
     cout << "\n=== KEY TAKEAWAYS ===" << endl;
     cout << "1. Copy constructor creates object from existing object" << endl;
     cout << "2. Syntax: ClassName(const ClassName &obj)" << endl;
@@ -274,6 +366,8 @@ int main() {
     cout << "   - Object initialization with another object" << endl;
     cout << "   - Pass by value to function" << endl;
     cout << "   - Return by value from function" << endl;
+    cout << "7. Deep copies allocate: take read-only arguments by const&," << endl;
+    cout << "   and std::move a source you will not use again" << endl;
     
     return 0;
 }
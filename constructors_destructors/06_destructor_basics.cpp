@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <cstring>
+#include "dynamic_array.h"
 using namespace std;
 
 /*
@@ -45,34 +46,42 @@ public:
 // EXAMPLE 2: DESTRUCTOR WITH DYNAMIC MEMORY (MUST HAVE!)
 // ============================================================================
 
-class DynamicArray {
+// The fixed `new int[size]` version grew into ::DynamicArray<T, N> in
+// dynamic_array.h (geometric growth, small-buffer storage, noexcept-aware
+// relocation). This wrapper only adds logging so the destructor is visible.
+class LoggedArray {
 private:
-    int* arr;
-    int size;
+    ::DynamicArray<int, 4> arr; // up to 4 ints live inside the object
 
 public:
-    // Constructor - Allocates memory
-    DynamicArray(int s) : size(s) {
-        arr = new int[size];
-        cout << "Constructor: Allocated memory for " << size << " integers at " << arr << endl;
-        
-        // Initialize array
-        for(int i = 0; i < size; i++) {
+    // Constructor - allocates only if the elements do not fit inline
+    LoggedArray(int s) : arr(s) {
+        for (int i = 0; i < s; i++) {
             arr[i] = i * 10;
         }
+        cout << "Constructor: " << s << " integers " << (arr.is_inline() ? "inline" : "on the heap")
+             << " at " << arr.data() << endl;
+    }
+
+    void push(int value) {
+        size_t old_capacity = arr.capacity();
+        arr.push_back(value);
+        if (arr.capacity() != old_capacity) {
+            cout << "  grew: capacity " << old_capacity << " -> " << arr.capacity()
+                 << ", buffer now at " << arr.data() << endl;
+        }
     }
 
-    // Destructor - MUST deallocate memory
-    ~DynamicArray() {
-        cout << "Destructor: Deallocating memory at " << arr << endl;
-        delete[] arr;  // CRITICAL: Free the allocated memory
-        arr = nullptr; // Good practice
+    // Destructor - nothing to free by hand: the member's destructor destroys
+    // the elements and frees its heap buffer (Rule of Zero for LoggedArray)
+    ~LoggedArray() {
+        cout << "Destructor: releasing " << arr.size() << " integers at " << arr.data() << endl;
     }
 
     void display() {
         cout << "Array: ";
-        for(int i = 0; i < size; i++) {
-            cout << arr[i] << " ";
+        for (int v : arr) {
+            cout << v << " ";
         }
         cout << endl;
     }
@@ -274,7 +283,11 @@ int main() {
 
     cout << "\n=== EXAMPLE 2: DYNAMIC MEMORY ===" << endl;
     {
-        DynamicArray arr(5);
+        LoggedArray arr(3);
+        arr.display();
+        for (int v = 30; v < 100; v += 10) {
+            arr.push(v); // capacity doubles: 4 (inline) -> 8 -> 16
+        }
         arr.display();
         cout << "End of scope" << endl;
         // Destructor frees memory automatically
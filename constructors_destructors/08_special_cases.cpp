@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include "dynamic_array.h"
 using namespace std;
 
 /*
@@ -266,44 +267,42 @@ public:
 
 class Array {
 private:
-    int* arr;
-    int size;
+    DynamicArray<int, 8> arr; // small arrays need no heap allocation
 
 public:
     // Conversion constructor (int -> Array)
-    explicit Array(int s) : size(s) {
-        arr = new int[size];
-        for (int i = 0; i < size; i++) {
-            arr[i] = 0;
-        }
-        cout << "Array created with size: " << size << endl;
+    explicit Array(int s) : arr(s, 0) {
+        cout << "Array created with size: " << s << endl;
     }
 
-    // Copy constructor
-    Array(const Array& other) : size(other.size) {
-        arr = new int[size];
-        for (int i = 0; i < size; i++) {
-            arr[i] = other.arr[i];
-        }
+    // Copy constructor: one allocation + memcpy (int is trivially copyable)
+    Array(const Array& other) : arr(other.arr) {
         cout << "Array copied" << endl;
     }
 
+    // Move constructor: steals the heap buffer; noexcept so containers of
+    // Array move instead of copy when they grow
+    Array(Array&& other) noexcept : arr(std::move(other.arr)) {
+        cout << "Array moved" << endl;
+    }
+
     ~Array() {
-        delete[] arr;
         cout << "Array destroyed" << endl;
     }
 
     void set(int index, int value) {
-        if (index >= 0 && index < size) {
+        if (index >= 0 && index < int(arr.size())) {
             arr[index] = value;
         }
     }
 
+    void push(int value) { arr.push_back(value); }
+
     void display() {
         cout << "Array: [";
-        for (int i = 0; i < size; i++) {
+        for (size_t i = 0; i < arr.size(); i++) {
             cout << arr[i];
-            if (i < size - 1) cout << ", ";
+            if (i + 1 < arr.size()) cout << ", ";
         }
         cout << "]" << endl;
     }
@@ -455,6 +454,7 @@ int main() {
     // Cannot implicitly convert int to Array
     // processArray(10);  // ERROR! Explicit constructor
     processArray(Array(3));  // OK: explicit conversion
+    processArray(std::move(arr1));  // moved, not copied
     
     cout << "\n=== EXAMPLE 7: REAL-WORLD LOGGER ===" << endl;
     
@@ -0,0 +1,181 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "dynamic_array.h"
+using namespace std;
+
+/*
+ * DYNAMIC ARRAY GROWTH: push_back and reallocation cost
+ * =====================================================
+ * dynamic_array.h is the grown-up DynamicArray/Array of 06 and 08. This file
+ * measures what its constructor rules buy, against std::vector:
+ *
+ * 1. Which constructor runs during reallocation?
+ *    - noexcept move constructor  -> elements are MOVED
+ *    - move that may throw        -> elements are COPIED (strong guarantee)
+ *    - trivially relocatable type -> neither: one memcpy
+ * 2. push_back throughput for trivial (int, 64-byte POD) and non-trivial
+ *    (std::string, unique_ptr) elements
+ * 3. Small-buffer optimization: many tiny arrays, no malloc while size <= N
+ *
+ * INTERVIEW QUESTION: What does `noexcept` on a move constructor change?
+ * ANSWER: Nothing in the class itself - but vector-like containers check
+ * std::is_nothrow_move_constructible and fall back to copying without it.
+ */
+
+// ============================================================================
+// Counting constructor calls during growth
+// ============================================================================
+
+struct Counts {
+    long copies = 0;
+    long moves = 0;
+};
+Counts counts;
+
+template <bool NoexceptMove>
+class Tracked {
+private:
+    string payload;
+
+public:
+    Tracked(int i) : payload("item-" + to_string(i) + "-with-a-heap-sized-payload") {}
+    Tracked(const Tracked& other) : payload(other.payload) { counts.copies++; }
+    Tracked(Tracked&& other) noexcept(NoexceptMove) : payload(std::move(other.payload)) { counts.moves++; }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) = default;
+};
+
+template <typename Container>
+Counts count_growth(int n) {
+    counts = Counts{};
+    Container c;
+    for (int i = 0; i < n; i++) {
+        c.emplace_back(i); // constructed in place: only reallocation copies/moves
+    }
+    return counts;
+}
+
+void show_relocation_policy() {
+    const int n = 100000;
+    cout << "\n=== RELOCATION: constructor calls while growing to " << n << " elements ===" << endl;
+    cout << left << setw(36) << "container / element" << right << setw(12) << "copies" << setw(12) << "moves" << endl;
+    auto row = [](const string& name, Counts c) {
+        cout << left << setw(36) << name << right << setw(12) << c.copies << setw(12) << c.moves << endl;
+    };
+    row("std::vector  / noexcept move", count_growth<vector<Tracked<true>>>(n));
+    row("DynamicArray / noexcept move", count_growth<DynamicArray<Tracked<true>>>(n));
+    row("std::vector  / throwing move", count_growth<vector<Tracked<false>>>(n));
+    row("DynamicArray / throwing move", count_growth<DynamicArray<Tracked<false>>>(n));
+    cout << "Doubling capacity means ~n relocations in total (n + n/2 + n/4 ...), not n^2/2." << endl;
+}
+
+// ============================================================================
+// push_back throughput
+// ============================================================================
+
+struct Pod64 {
+    long v[8]; // trivially copyable: relocated with memcpy
+};
+
+template <typename T>
+T make_value(int i) {
+    if constexpr (is_same_v<T, int>) {
+        return i;
+    } else if constexpr (is_same_v<T, Pod64>) {
+        return Pod64{{i, i, i, i, i, i, i, i}};
+    } else if constexpr (is_same_v<T, string>) {
+        return "string number " + to_string(i) + " (longer than SSO)";
+    } else {
+        return make_unique<int>(i);
+    }
+}
+
+template <typename Container>
+double push_ns(int n, int rounds) {
+    using T = typename Container::value_type;
+    double best = 1e18;
+    for (int r = 0; r < rounds; r++) {
+        auto start = chrono::steady_clock::now();
+        Container c;
+        for (int i = 0; i < n; i++) {
+            c.push_back(make_value<T>(i));
+        }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        best = min(best, ns / n);
+    }
+    return best;
+}
+
+template <typename T>
+void push_row(const string& name, int n, int rounds) {
+    cout << left << setw(22) << name << right << fixed << setprecision(2) << setw(16)
+         << push_ns<vector<T>>(n, rounds) << setw(16) << push_ns<DynamicArray<T>>(n, rounds)
+         << defaultfloat << endl;
+}
+
+void benchmark_push_back() {
+    const int n = 1000000;
+    cout << "\n=== push_back " << n << " elements, ns per element (best of 5) ===" << endl;
+    cout << left << setw(22) << "element" << right << setw(16) << "std::vector" << setw(16) << "DynamicArray" << endl;
+    push_row<int>("int", n, 5);
+    push_row<Pod64>("64-byte POD", n, 5);
+    push_row<string>("std::string", n / 4, 5);
+    push_row<unique_ptr<int>>("unique_ptr<int>", n / 4, 5);
+    cout << "(unique_ptr is move-only, not trivially copyable: moved one by one;\n"
+         << " specialize is_trivially_relocatable to let it memcpy)" << endl;
+}
+
+// ============================================================================
+// Small-buffer optimization
+// ============================================================================
+
+template <typename Container>
+double small_arrays_ns(int arrays, int elements) {
+    auto start = chrono::steady_clock::now();
+    long sum = 0;
+    for (int a = 0; a < arrays; a++) {
+        Container c;
+        for (int i = 0; i < elements; i++) {
+            c.push_back(a + i);
+        }
+        sum += c[elements - 1];
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    return sum ? ns / arrays : 0;
+}
+
+void benchmark_small_buffer() {
+    const int arrays = 1000000;
+    cout << "\n=== SMALL ARRAYS: " << arrays << " short-lived arrays, ns per array ===" << endl;
+    cout << left << setw(12) << "elements" << right << setw(16) << "std::vector" << setw(18)
+         << "DynamicArray<8>" << endl;
+    for (int elements : {2, 8, 9, 32}) {
+        cout << left << setw(12) << elements << right << fixed << setprecision(1) << setw(16)
+             << small_arrays_ns<vector<int>>(arrays, elements) << setw(18)
+             << small_arrays_ns<DynamicArray<int, 8>>(arrays, elements) << defaultfloat << endl;
+    }
+    cout << "Up to 8 elements DynamicArray<int, 8> never calls malloc; at 9 it spills to the heap." << endl;
+}
+
+int main() {
+    cout << "=== DYNAMIC ARRAY: GROWTH, RELOCATION, SMALL BUFFER ===" << endl;
+
+    DynamicArray<string, 2> names;
+    names.push_back("alpha");
+    names.push_back("beta");
+    cout << "2 names inline: " << boolalpha << names.is_inline();
+    names.push_back("gamma");
+    cout << ", after a 3rd: " << names.is_inline() << " (capacity " << names.capacity() << ")" << endl;
+    names.push_back("delta");  // full again: size 4, capacity 4
+    names.push_back(names[0]); // argument lives in the buffer being replaced: built before relocating
+    cout << "self push_back: " << names.back() << ", reallocations so far: " << names.reallocations() << endl;
+
+    show_relocation_policy();
+    benchmark_push_back();
+    benchmark_small_buffer();
+    return 0;
+}
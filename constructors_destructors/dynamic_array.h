@@ -0,0 +1,297 @@
+#ifndef DYNAMIC_ARRAY_H
+#define DYNAMIC_ARRAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+ * DYNAMIC ARRAY: what std::vector does under the hood
+ * ====================================================
+ * The DynamicArray of 06_destructor_basics.cpp is a fixed `new int[size]`.
+ * This one grows, and every constructor/destructor rule shows up in it:
+ *
+ *   DynamicArray<T, N>      N = elements stored INSIDE the object (small-buffer
+ *                           optimization): no heap allocation until size > N
+ *
+ * GROWTH: capacity doubles when full -> amortized O(1) push_back.
+ *         (growing by +1 would copy every element on every push: O(n^2))
+ *
+ * RELOCATION (moving elements to the new buffer), cheapest first:
+ *   1. trivially relocatable T (int, POD structs): one memcpy
+ *   2. T with a noexcept move constructor (std::string): move each element
+ *   3. otherwise COPY each element - if a copy throws, the new buffer is
+ *      destroyed and the old one is untouched (strong guarantee, like
+ *      std::vector). A move that may throw would leave the old buffer
+ *      half-moved-from, so it is never used here (std::move_if_noexcept);
+ *      a move-only T must therefore have a noexcept move constructor.
+ *
+ * INTERVIEW QUESTION: Why should move constructors be noexcept?
+ * ANSWER: Containers only move elements during reallocation if the move
+ * cannot throw; otherwise they copy, to keep the strong guarantee.
+ */
+
+// Opt-in trait: a type whose objects can be moved with memcpy (no self
+// pointers, no registration elsewhere). Specialize to true for such types.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T, size_t InlineCapacity = 0>
+class DynamicArray {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    DynamicArray() noexcept : data_(inline_data()), capacity_(InlineCapacity) {}
+
+    explicit DynamicArray(size_t n, const T& value = T()) : DynamicArray() {
+        reserve(n);
+        std::uninitialized_fill_n(data_, n, value);
+        size_ = n;
+    }
+
+    DynamicArray(std::initializer_list<T> items) : DynamicArray() {
+        reserve(items.size());
+        std::uninitialized_copy(items.begin(), items.end(), data_);
+        size_ = items.size();
+    }
+
+    // Copy constructor: one allocation of exactly other.size(), then a
+    // memcpy for trivial types (not an element-by-element loop)
+    DynamicArray(const DynamicArray& other) : DynamicArray() {
+        reserve(other.size_);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (other.size_) std::memcpy(static_cast<void*>(data_), other.data_, other.size_ * sizeof(T));
+        } else {
+            std::uninitialized_copy(other.data_, other.data_ + other.size_, data_);
+        }
+        size_ = other.size_;
+    }
+
+    // Move constructor: steal a heap buffer (O(1)); inline elements have to
+    // be relocated one by one because they live inside `other`
+    DynamicArray(DynamicArray&& other) noexcept(std::is_nothrow_move_constructible_v<T> ||
+                                                InlineCapacity == 0)
+        : DynamicArray() {
+        if (!other.is_inline()) {
+            data_ = std::exchange(other.data_, other.inline_data());
+            capacity_ = std::exchange(other.capacity_, InlineCapacity);
+            size_ = std::exchange(other.size_, 0);
+        } else {
+            relocate(other.data_, other.size_, data_);
+            size_ = std::exchange(other.size_, 0);
+        }
+    }
+
+    // Copy-and-swap for copies, move-and-swap for moves. When inline
+    // elements would have to be copied during the swap (T's move may throw),
+    // the copy goes to a heap buffer instead, so only the copy itself can
+    // throw and *this is untouched if it does.
+    DynamicArray& operator=(const DynamicArray& other) {
+        if (this != &other) {
+            if constexpr (std::is_nothrow_move_constructible_v<T> || InlineCapacity == 0) {
+                DynamicArray tmp(other);
+                swap(tmp);
+            } else {
+                assign_via_heap(other);
+            }
+        }
+        return *this;
+    }
+
+    DynamicArray& operator=(DynamicArray&& other) noexcept(std::is_nothrow_move_constructible_v<T> ||
+                                                          InlineCapacity == 0) {
+        if (this != &other) {
+            DynamicArray tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Destructor: destroy elements in reverse order, then free the buffer
+    // (only if it is on the heap - the inline buffer is part of *this)
+    ~DynamicArray() {
+        clear();
+        release();
+    }
+
+    // Only a basic guarantee when an inline buffer is involved and T's move
+    // may throw: its elements are copied across one side at a time.
+    void swap(DynamicArray& other) noexcept(std::is_nothrow_move_constructible_v<T> ||
+                                            InlineCapacity == 0) {
+        if (!is_inline() && !other.is_inline()) {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+            return;
+        }
+        DynamicArray tmp;
+        tmp.steal_from(*this);
+        steal_from(other);
+        other.steal_from(tmp);
+    }
+
+    // ---- element access ----
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T& at(size_t i) {
+        if (i >= size_) throw std::out_of_range("DynamicArray::at");
+        return data_[i];
+    }
+    T& back() { return data_[size_ - 1]; }
+    T* data() noexcept { return data_; }
+    iterator begin() noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return capacity_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool is_inline() const noexcept { return data_ == inline_data(); }
+
+    // ---- modifiers ----
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ < capacity_) {
+            ::new (static_cast<void*>(data_ + size_)) T(std::forward<Args>(args)...);
+        } else {
+            // Build the new element in the NEW buffer before relocating: args
+            // may refer to an element of the old buffer (a.push_back(a[0])).
+            size_t new_cap = next_capacity(size_ + 1);
+            T* fresh = allocate(new_cap);
+            try {
+                ::new (static_cast<void*>(fresh + size_)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(fresh, new_cap);
+                throw;
+            }
+            try {
+                relocate(data_, size_, fresh);
+            } catch (...) {
+                fresh[size_].~T();
+                deallocate(fresh, new_cap);
+                throw;
+            }
+            adopt(fresh, new_cap);
+        }
+        return data_[size_++];
+    }
+
+    void pop_back() noexcept { data_[--size_].~T(); }
+
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            while (size_) data_[--size_].~T();
+        }
+        size_ = 0;
+    }
+
+    void reserve(size_t n) {
+        if (n <= capacity_) return;
+        T* fresh = allocate(n);
+        try {
+            relocate(data_, size_, fresh);
+        } catch (...) {
+            deallocate(fresh, n);
+            throw;
+        }
+        adopt(fresh, n);
+    }
+
+    // Number of times the buffer moved (for the growth benchmark)
+    size_t reallocations() const noexcept { return reallocations_; }
+
+private:
+    T* data_;
+    size_t size_ = 0;
+    size_t capacity_;
+    size_t reallocations_ = 0;
+    alignas(T) unsigned char inline_[InlineCapacity ? InlineCapacity * sizeof(T) : 1];
+
+    T* inline_data() noexcept { return reinterpret_cast<T*>(inline_); }
+    const T* inline_data() const noexcept { return reinterpret_cast<const T*>(inline_); }
+
+    size_t next_capacity(size_t needed) const {
+        return std::max<size_t>({needed, capacity_ * 2, 4}); // geometric: x2
+    }
+
+    static T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
+    static void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    void release() noexcept {
+        if (!is_inline()) deallocate(data_, capacity_);
+        data_ = inline_data();
+        capacity_ = InlineCapacity;
+    }
+
+    // The old elements are already relocated (moved + destroyed) into fresh
+    void adopt(T* fresh, size_t cap) noexcept {
+        release();
+        data_ = fresh;
+        capacity_ = cap;
+        reallocations_++;
+    }
+
+    // Copy other into a fresh heap buffer, then drop our elements and take
+    // the buffer: nothing after the copy can throw.
+    void assign_via_heap(const DynamicArray& other) {
+        size_t cap = std::max<size_t>(other.size_, 1);
+        T* fresh = allocate(cap);
+        try {
+            std::uninitialized_copy(other.data_, other.data_ + other.size_, fresh);
+        } catch (...) {
+            deallocate(fresh, cap);
+            throw;
+        }
+        clear();
+        release();
+        data_ = fresh;
+        capacity_ = cap;
+        size_ = other.size_;
+    }
+
+    // Move n elements from `from` into raw memory at `to`; the sources are
+    // destroyed on success and untouched if a copy throws.
+    static void relocate(T* from, size_t n, T* to) {
+        static_assert(std::is_nothrow_move_constructible_v<T> || std::is_copy_constructible_v<T>,
+                      "DynamicArray: a move-only T needs a noexcept move constructor");
+        if (n == 0) return;
+        if constexpr (is_trivially_relocatable<T>::value) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+        } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+            for (size_t i = 0; i < n; i++) {
+                ::new (static_cast<void*>(to + i)) T(std::move(from[i]));
+                from[i].~T();
+            }
+        } else {
+            std::uninitialized_copy(from, from + n, to); // rolls back itself on throw
+            for (size_t i = 0; i < n; i++) from[i].~T();
+        }
+    }
+
+    // Take other's elements (other must not share a heap buffer with us)
+    void steal_from(DynamicArray& other) {
+        clear();
+        release();
+        if (!other.is_inline()) {
+            data_ = std::exchange(other.data_, other.inline_data());
+            capacity_ = std::exchange(other.capacity_, InlineCapacity);
+        } else {
+            relocate(other.data_, other.size_, data_);
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+};
+
+#endif // DYNAMIC_ARRAY_H
@@ -15,9 +15,19 @@
  * - DIP: Depend on abstractions (target interface), not concretions
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 // ============================================================================
 // EXAMPLE 1: Payment Gateway Integration
@@ -242,12 +252,503 @@ public:
     }
 };
 
+// ============================================================================
+// EXAMPLE 3: High-Throughput Logger Adapter (ring-buffer staging)
+// ============================================================================
+
+// PROBLEM: The adapter runs the adaptee on the caller's thread - What's wrong?
+// ---
+// LoggerAdapter forwards every logInfo()/logError() straight into
+// ThirdPartyLogger::writeLog(). Whatever the third-party library costs
+// (formatting, a mutex, a write() syscall) is paid by the hot request thread:
+//
+//   request thread: handle() -> logInfo() -> writeLog() -> write(2) ... back
+//                                            ^^^^^^^^^^^^^^^^^^^^^^^^
+//                                            caller-side latency spike
+//
+// Under a burst every request thread queues up behind the same library.
+//
+// SOLUTION: Keep the ILogger target interface, change WHERE translation runs
+// ---
+// AsyncLoggerAdapter is still "just an adapter" to the client, but:
+// 1. Each producer thread owns a single-producer ring (SPSC: 1 writer, 1 reader)
+//    -> no lock, no CAS, one release store per record on the hot path
+// 2. One drainer thread sweeps all rings, pops records in batches and
+//    translates them into writeLog(level, msg) calls
+// 3. An OverflowPolicy decides what the caller does when its ring is full
+//      Block  : wait for space (never loses data, caller absorbs the delay)
+//      Drop   : discard the record (bounded latency, lossy)
+//      Sample : under pressure keep 1 in N records, drop the rest
+// 4. Counters expose enqueued/drained/dropped/delayed so loss is visible
+//
+// Memory layout notes:
+// - head_ (producer-owned) and tail_ (drainer-owned) sit on separate cache
+//   lines; otherwise both cores ping-pong one line on every record (false sharing)
+// - Records are fixed-size PODs stored inline in the ring: no heap allocation
+//   per log call (long messages are truncated to kMaxMessage bytes)
+// - The drainer reuses one std::string for translation, so steady state does
+//   not allocate either
+
+enum class LogLevel : std::uint8_t
+{
+    Info = 1, // same mapping LoggerAdapter uses
+    Error = 3
+};
+
+enum class OverflowPolicy
+{
+    Block,
+    Drop,
+    Sample
+};
+
+struct LogRecord
+{
+    static constexpr std::size_t kMaxMessage = 110;
+
+    LogLevel level;
+    std::uint8_t length;
+    char text[kMaxMessage];
+};
+
+// Bounded single-producer / single-consumer ring. Capacity must be a power of 2
+// so index wrap is a mask instead of a modulo.
+template <typename T, std::size_t Capacity>
+class SpscRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+private:
+    alignas(64) std::atomic<std::size_t> head_{0}; // next slot to write (producer)
+    alignas(64) std::atomic<std::size_t> tail_{0}; // next slot to read (consumer)
+    alignas(64) T slots_[Capacity];
+
+public:
+    bool tryPush(const T &item)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity)
+        {
+            return false; // full
+        }
+        slots_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release); // publish the slot
+        return true;
+    }
+
+    // Hands up to maxItems records to consume(); returns how many were popped.
+    template <typename Fn>
+    std::size_t popBatch(std::size_t maxItems, Fn &&consume)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t avail = head_.load(std::memory_order_acquire) - tail;
+        const std::size_t n = avail < maxItems ? avail : maxItems;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            consume(slots_[(tail + i) & (Capacity - 1)]);
+        }
+        tail_.store(tail + n, std::memory_order_release); // free the slots in one store
+        return n;
+    }
+};
+
+struct AsyncLoggerStats
+{
+    std::uint64_t enqueued = 0;
+    std::uint64_t drained = 0;
+    std::uint64_t dropped = 0; // lost to Drop/Sample policy
+    std::uint64_t delayed = 0; // caller had to wait for space (Block/Sample)
+    std::uint64_t batches = 0;
+};
+
+// ThirdParty only needs writeLog(int, const std::string&); the default is the
+// same library LoggerAdapter wraps, the benchmark plugs in a silent stand-in.
+template <typename ThirdParty = ThirdPartyLogger>
+class AsyncLoggerAdapter : public ILogger
+{
+public:
+    static constexpr std::size_t kRingCapacity = 1024;
+    static constexpr std::size_t kBatchSize = 64;
+
+private:
+    using Ring = SpscRing<LogRecord, kRingCapacity>;
+
+    struct ProducerSlot
+    {
+        std::thread::id owner;
+        std::unique_ptr<Ring> ring;
+    };
+
+    // Per-thread cache of "my ring in adapter #id", one entry per adapter the
+    // thread logs to (up to kCacheWays; beyond that the oldest entry is
+    // replaced). The id (not the address) guards against a new adapter reusing
+    // a destroyed adapter's address; a dead adapter's entry is never hit again
+    // and ages out.
+    static constexpr std::size_t kCacheWays = 8;
+
+    struct ThreadCache
+    {
+        struct Entry
+        {
+            std::uint64_t adapterId = 0;
+            Ring *ring = nullptr;
+        };
+        Entry entries[kCacheWays];
+        std::size_t nextVictim = 0;
+    };
+
+    static std::uint64_t nextId()
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+    ThirdParty thirdParty_;
+    const OverflowPolicy policy_;
+    const std::uint32_t sampleEvery_;
+    const std::uint64_t id_ = nextId();
+
+    std::mutex registryMutex_; // taken once per (thread, adapter) cache miss, never per record
+    std::vector<ProducerSlot> producers_;
+    std::atomic<std::size_t> producerCount_{0};
+
+    std::atomic<bool> stop_{false};
+    std::thread drainer_;
+
+    std::atomic<std::uint64_t> enqueued_{0};
+    std::atomic<std::uint64_t> drained_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> delayed_{0};
+    std::atomic<std::uint64_t> batches_{0};
+    std::atomic<std::uint32_t> overflowSeq_{0};
+
+    Ring &ringForThisThread()
+    {
+        thread_local ThreadCache cache;
+        for (const auto &entry : cache.entries)
+        {
+            if (entry.adapterId == id_)
+            {
+                return *entry.ring; // fast path: no lock, no registry scan
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        const std::thread::id me = std::this_thread::get_id();
+        Ring *ring = nullptr;
+        for (auto &slot : producers_)
+        {
+            if (slot.owner == me)
+            {
+                ring = slot.ring.get();
+            }
+        }
+        if (ring == nullptr)
+        {
+            producers_.push_back({me, std::make_unique<Ring>()});
+            ring = producers_.back().ring.get();
+            producerCount_.store(producers_.size(), std::memory_order_release);
+        }
+        cache.entries[cache.nextVictim] = {id_, ring};
+        cache.nextVictim = (cache.nextVictim + 1) % kCacheWays;
+        return *ring;
+    }
+
+    void enqueue(LogLevel level, const std::string &message)
+    {
+        LogRecord record;
+        record.level = level;
+        record.length = static_cast<std::uint8_t>(
+            std::min(message.size(), LogRecord::kMaxMessage));
+        std::memcpy(record.text, message.data(), record.length);
+
+        Ring &ring = ringForThisThread();
+        if (ring.tryPush(record))
+        {
+            enqueued_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Ring full: apply the overflow policy
+        bool wait = policy_ == OverflowPolicy::Block;
+        if (policy_ == OverflowPolicy::Sample)
+        {
+            wait = overflowSeq_.fetch_add(1, std::memory_order_relaxed) % sampleEvery_ == 0;
+        }
+        if (!wait)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        delayed_.fetch_add(1, std::memory_order_relaxed);
+        while (!ring.tryPush(record))
+        {
+            std::this_thread::yield(); // let the drainer run (matters on 1 core)
+        }
+        enqueued_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::size_t drainOnce(std::string &scratch)
+    {
+        std::size_t total = 0;
+        const std::size_t count = producerCount_.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Ring *ring;
+            {
+                // producers_ may reallocate while a new thread registers
+                std::lock_guard<std::mutex> lock(registryMutex_);
+                ring = producers_[i].ring.get();
+            }
+            const std::size_t n = ring->popBatch(kBatchSize, [&](const LogRecord &r) {
+                scratch.assign(r.text, r.length); // reuses capacity, no allocation
+                thirdParty_.writeLog(static_cast<int>(r.level), scratch);
+            });
+            if (n > 0)
+            {
+                batches_.fetch_add(1, std::memory_order_relaxed);
+                total += n;
+            }
+        }
+        drained_.fetch_add(total, std::memory_order_relaxed);
+        return total;
+    }
+
+    void drainLoop()
+    {
+        std::string scratch;
+        scratch.reserve(LogRecord::kMaxMessage);
+        while (!stop_.load(std::memory_order_acquire))
+        {
+            if (drainOnce(scratch) == 0)
+            {
+                // Idle: back off instead of burning the core the producers need
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        while (drainOnce(scratch) > 0)
+        {
+            // flush whatever producers left behind before shutdown
+        }
+    }
+
+public:
+    explicit AsyncLoggerAdapter(OverflowPolicy policy = OverflowPolicy::Block,
+                                std::uint32_t sampleEvery = 8)
+        : policy_(policy), sampleEvery_(sampleEvery == 0 ? 1 : sampleEvery)
+    {
+        drainer_ = std::thread(&AsyncLoggerAdapter::drainLoop, this);
+    }
+
+    // Joins the drainer after flushing; producers must have stopped logging.
+    ~AsyncLoggerAdapter() override
+    {
+        stop_.store(true, std::memory_order_release);
+        drainer_.join();
+    }
+
+    AsyncLoggerAdapter(const AsyncLoggerAdapter &) = delete;
+    AsyncLoggerAdapter &operator=(const AsyncLoggerAdapter &) = delete;
+
+    void logInfo(const std::string &message) override
+    {
+        enqueue(LogLevel::Info, message);
+    }
+
+    void logError(const std::string &message) override
+    {
+        enqueue(LogLevel::Error, message);
+    }
+
+    // Waits until the drainer has handed every accepted record to ThirdParty.
+    void flush()
+    {
+        while (drained_.load(std::memory_order_acquire) <
+               enqueued_.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    AsyncLoggerStats stats() const
+    {
+        AsyncLoggerStats s;
+        s.enqueued = enqueued_.load(std::memory_order_relaxed);
+        s.drained = drained_.load(std::memory_order_relaxed);
+        s.dropped = dropped_.load(std::memory_order_relaxed);
+        s.delayed = delayed_.load(std::memory_order_relaxed);
+        s.batches = batches_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    ThirdParty &thirdParty() { return thirdParty_; }
+};
+
+// ----------------------------------------------------------------------------
+// Benchmark: caller-side latency under bursty load
+// ----------------------------------------------------------------------------
+
+// Stand-in for a "real" logging library: ~1 microsecond of work per record
+// (formatting + locked append), no console output so we time the adapter only.
+class SlowThirdPartyLogger
+{
+private:
+    std::mutex mutex_;
+    std::uint64_t bytes_ = 0;
+    int lastLevel_ = 0;
+
+public:
+    void writeLog(int level, const std::string &msg)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(1);
+        while (std::chrono::steady_clock::now() < until)
+        {
+        }
+        bytes_ += msg.size();
+        lastLevel_ = level;
+    }
+};
+
+class SyncSlowLoggerAdapter : public ILogger
+{
+private:
+    SlowThirdPartyLogger thirdParty_;
+
+public:
+    void logInfo(const std::string &message) override { thirdParty_.writeLog(1, message); }
+    void logError(const std::string &message) override { thirdParty_.writeLog(3, message); }
+};
+
+struct LatencyReport
+{
+    std::uint32_t p50Ns;
+    std::uint32_t p99Ns;
+    std::uint32_t maxNs;
+    double wallMs;
+};
+
+// kThreads producers each emit kBursts bursts of kBurstSize records with a
+// quiet gap between bursts - the traffic shape of request spikes.
+LatencyReport runBurstyLoad(ILogger &logger)
+{
+    constexpr int kThreads = 4;
+    constexpr int kBursts = 20;
+    constexpr int kBurstSize = 2000;
+
+    std::vector<std::vector<std::uint32_t>> samples(kThreads);
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        producers.emplace_back([&, t]() {
+            auto &mine = samples[t];
+            mine.reserve(kBursts * kBurstSize);
+            const std::string msg = "request handled by worker " + std::to_string(t);
+            for (int b = 0; b < kBursts; ++b)
+            {
+                for (int i = 0; i < kBurstSize; ++i)
+                {
+                    const auto t0 = std::chrono::steady_clock::now();
+                    if (i % 100 == 0)
+                    {
+                        logger.logError(msg);
+                    }
+                    else
+                    {
+                        logger.logInfo(msg);
+                    }
+                    const auto t1 = std::chrono::steady_clock::now();
+                    mine.push_back(static_cast<std::uint32_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2)); // quiet gap
+            }
+        });
+    }
+    for (auto &p : producers)
+    {
+        p.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    std::vector<std::uint32_t> all;
+    for (auto &s : samples)
+    {
+        all.insert(all.end(), s.begin(), s.end());
+    }
+    std::sort(all.begin(), all.end());
+    LatencyReport r;
+    r.p50Ns = all[all.size() / 2];
+    r.p99Ns = all[all.size() * 99 / 100];
+    r.maxNs = all.back();
+    r.wallMs = std::chrono::duration<double, std::milli>(end - start).count();
+    return r;
+}
+
+void printLatencyRow(const char *name, const LatencyReport &r)
+{
+    std::cout << "  " << std::left << std::setw(16) << name << std::right
+              << " p50=" << std::setw(7) << r.p50Ns << " ns"
+              << "  p99=" << std::setw(8) << r.p99Ns << " ns"
+              << "  max=" << std::setw(10) << r.maxNs << " ns"
+              << "  wall=" << static_cast<long>(r.wallMs) << " ms\n";
+}
+
+void printStatsRow(const AsyncLoggerStats &s)
+{
+    std::cout << "  " << std::setw(16) << "" << " enqueued=" << s.enqueued
+              << " drained=" << s.drained << " dropped=" << s.dropped
+              << " delayed=" << s.delayed << " batches=" << s.batches << "\n";
+}
+
+void benchmarkLoggerAdapters()
+{
+    std::cout << "\n--- Logger Adapter: caller-side latency (4 threads x 20 bursts x 2000) ---\n";
+
+    {
+        SyncSlowLoggerAdapter sync;
+        printLatencyRow("sync adapter", runBurstyLoad(sync));
+    }
+
+    const std::pair<const char *, OverflowPolicy> policies[] = {
+        {"async/block", OverflowPolicy::Block},
+        {"async/drop", OverflowPolicy::Drop},
+        {"async/sample", OverflowPolicy::Sample},
+    };
+    for (const auto &[name, policy] : policies)
+    {
+        AsyncLoggerAdapter<SlowThirdPartyLogger> async(policy);
+        const LatencyReport report = runBurstyLoad(async);
+        async.flush();
+        printLatencyRow(name, report);
+        printStatsRow(async.stats());
+    }
+}
+
 // ============================================================================
 // Demonstration
 // ============================================================================
 
-int main()
+int main(int argc, char *argv[])
 {
+    bool bench = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--bench")
+        {
+            bench = true;
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--bench]\n";
+            return 2;
+        }
+    }
+
     std::cout << "=== ADAPTER PATTERN DEMO ===\n";
 
     // Using Object Adapter
@@ -274,12 +775,33 @@ int main()
         logger.logError("Connection failed");
     }
 
+    // Same ILogger interface, translation moved off the caller's thread
+    std::cout << "\n--- Async Logger Adapter (ring-buffer staging) ---\n";
+    {
+        AsyncLoggerAdapter<> logger(OverflowPolicy::Block);
+        logger.logInfo("Application started");
+        logger.logError("Connection failed");
+        logger.flush();
+    }
+
+    if (bench)
+    {
+        benchmarkLoggerAdapters();
+    }
+
     std::cout << "\n=== KEY POINTS ===\n";
     std::cout << "1. Object Adapter uses composition (preferred for flexibility)\n";
     std::cout << "2. Class Adapter uses inheritance (tighter coupling)\n";
     std::cout << "3. Clients work with target interface, unaware of adaptation\n";
     std::cout << "4. Enables OCP - extend without modifying existing code\n";
     std::cout << "5. Common in legacy system integration\n";
+    std::cout << "6. An adapter may also change WHERE work runs (async staging) without\n"
+                 "   changing the interface clients see\n";
+
+    if (!bench)
+    {
+        std::cout << "\n(run with --bench for the logger adapter latency benchmark)\n";
+    }
 
     return 0;
 }
@@ -15,9 +15,23 @@
  * - Reduces coupling between client and subsystem
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // ============================================================================
@@ -262,49 +276,361 @@ public:
 // ============================================================================
 // EXAMPLE 3: Order processing facade
 // ============================================================================
+//
+// The facade stays a thin coordinator; the subsystems behind it are real
+// in-memory services sized for ~100k orders/sec:
+//
+//   placeOrder() --> Inventory (sharded, lock-free reserve/release per SKU)
+//                --> Payment
+//                --> Shipping  (per-zone priority queue -> best-fit route batches)
+//                --> Notification
+//
+// Subsystems print only when verbose, so the same classes serve the demo
+// and the load generator.
 
+// Sharded stock table. A shard's shared_mutex only protects the map shape
+// (adding SKUs); stock changes are CAS loops on the SKU's atomic counter, so
+// concurrent orders for different SKUs never contend, and orders for the
+// same SKU never oversell.
 class Inventory
 {
+private:
+    static constexpr std::size_t kShards = 64;
+
+    struct StockItem
+    {
+        std::atomic<int> available{0};
+        double weightKg = 1.0;
+    };
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<StockItem>> items;
+    };
+
+    std::array<Shard, kShards> shards_;
+    bool verbose_;
+
+    Shard &shardFor(const std::string &productId)
+    {
+        return shards_[std::hash<std::string>{}(productId) % kShards];
+    }
+
+    StockItem *find(const std::string &productId)
+    {
+        Shard &shard = shardFor(productId);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.items.find(productId);
+        // unique_ptr keeps the item address stable across rehashes
+        return it == shard.items.end() ? nullptr : it->second.get();
+    }
+
 public:
-    bool checkAvailability(const std::string &productId)
+    explicit Inventory(bool verbose = true) : verbose_(verbose) {}
+
+    void addStock(const std::string &productId, int quantity, double weightKg = 1.0)
+    {
+        Shard &shard = shardFor(productId);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto &item = shard.items[productId];
+        if (!item)
+        {
+            item = std::make_unique<StockItem>();
+        }
+        item->weightKg = weightKg;
+        item->available.fetch_add(quantity, std::memory_order_relaxed);
+    }
+
+    // Advisory only: stock can change right after this returns.
+    // reserve() is the authoritative check.
+    bool checkAvailability(const std::string &productId, int quantity = 1)
     {
-        std::cout << "[Inventory] Checking availability for " << productId << "\n";
-        return true; // Simplified
+        if (verbose_)
+        {
+            std::cout << "[Inventory] Checking availability for " << productId << "\n";
+        }
+        StockItem *item = find(productId);
+        return item && item->available.load(std::memory_order_relaxed) >= quantity;
     }
 
-    void reserve(const std::string &productId)
+    // Atomically takes `quantity` units; false if that would oversell.
+    bool reserve(const std::string &productId, int quantity = 1)
     {
-        std::cout << "[Inventory] Reserving " << productId << "\n";
+        if (verbose_)
+        {
+            std::cout << "[Inventory] Reserving " << productId << "\n";
+        }
+        StockItem *item = find(productId);
+        if (!item)
+        {
+            return false;
+        }
+        int current = item->available.load(std::memory_order_relaxed);
+        while (current >= quantity)
+        {
+            if (item->available.compare_exchange_weak(current, current - quantity,
+                                                      std::memory_order_acq_rel))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Compensation when a later step (payment) fails.
+    void release(const std::string &productId, int quantity = 1)
+    {
+        if (verbose_)
+        {
+            std::cout << "[Inventory] Releasing " << productId << "\n";
+        }
+        if (StockItem *item = find(productId))
+        {
+            item->available.fetch_add(quantity, std::memory_order_acq_rel);
+        }
+    }
+
+    double weightOf(const std::string &productId)
+    {
+        StockItem *item = find(productId);
+        return item ? item->weightKg : 1.0;
+    }
+
+    long totalAvailable()
+    {
+        long total = 0;
+        for (auto &shard : shards_)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (auto &entry : shard.items)
+            {
+                total += entry.second->available.load(std::memory_order_relaxed);
+            }
+        }
+        return total;
     }
 };
 
 class Payment
 {
+private:
+    bool verbose_;
+
 public:
+    explicit Payment(bool verbose = true) : verbose_(verbose) {}
+
     bool processPayment(const std::string &cardNumber, double amount)
     {
-        std::cout << "[Payment] Processing $" << amount
-                  << " on card ending " << cardNumber.substr(cardNumber.length() - 4) << "\n";
+        if (verbose_)
+        {
+            std::cout << "[Payment] Processing $" << amount
+                      << " on card ending " << cardNumber.substr(cardNumber.length() - 4) << "\n";
+        }
         return true;
     }
 };
 
+enum class DeliveryPriority
+{
+    Standard,
+    Express
+};
+
+struct RouteBatch
+{
+    std::size_t zone;
+    double loadKg = 0;
+    std::vector<std::uint64_t> orders;
+};
+
+struct ShippingStats
+{
+    std::uint64_t deliveries = 0;
+    std::uint64_t routes = 0;
+    double avgFill = 0; // loadKg / capacity over sealed routes
+};
+
+// Delivery scheduler. scheduleDelivery() only enqueues into the zone's
+// priority queue (express first, then oldest first). planWave() drains each
+// zone and bin-packs deliveries into truck-sized route batches with best-fit:
+// the open route whose remaining capacity is the smallest that still fits.
+// Sealed routes are handed back to the caller for dispatch; Shipping keeps
+// only the running totals, so a long-running facade does not grow.
 class Shipping
 {
 public:
-    void scheduleDelivery(const std::string &address)
+    static constexpr std::size_t kZones = 32;
+    static constexpr double kTruckCapacityKg = 500.0;
+
+private:
+    struct Delivery
+    {
+        std::uint64_t orderId;
+        std::uint64_t sequence; // FIFO tie-break inside a priority class
+        double weightKg;
+        DeliveryPriority priority;
+
+        bool operator<(const Delivery &other) const // std::priority_queue is a max-heap
+        {
+            if (priority != other.priority)
+            {
+                return priority < other.priority;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    struct Zone
+    {
+        std::mutex mutex;
+        std::priority_queue<Delivery> pending;
+        std::vector<RouteBatch> openRoutes;
+        std::multimap<double, std::size_t> byRemaining; // remaining kg -> openRoutes index
+    };
+
+    std::array<Zone, kZones> zones_;
+    std::atomic<std::uint64_t> sequence_{0};
+    bool verbose_;
+
+    std::mutex statsMutex_;
+    ShippingStats stats_;
+    double fillSum_ = 0;
+
+    void seal(const std::vector<RouteBatch> &routes)
     {
-        std::cout << "[Shipping] Scheduling delivery to " << address << "\n";
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        for (const auto &route : routes)
+        {
+            ++stats_.routes;
+            stats_.deliveries += route.orders.size();
+            fillSum_ += route.loadKg / kTruckCapacityKg;
+        }
+    }
+
+public:
+    explicit Shipping(bool verbose = true) : verbose_(verbose) {}
+
+    static std::size_t zoneOf(const std::string &address)
+    {
+        return std::hash<std::string>{}(address) % kZones;
+    }
+
+    // A parcel heavier than one truck can never be routed.
+    static bool canCarry(double weightKg)
+    {
+        return weightKg > 0 && weightKg <= kTruckCapacityKg;
+    }
+
+    bool scheduleDelivery(const std::string &address, std::uint64_t orderId = 0,
+                          double weightKg = 1.0,
+                          DeliveryPriority priority = DeliveryPriority::Standard)
+    {
+        if (!canCarry(weightKg))
+        {
+            if (verbose_)
+            {
+                std::cout << "[Shipping] Rejecting " << weightKg << " kg parcel to "
+                          << address << " (truck capacity " << kTruckCapacityKg << " kg)\n";
+            }
+            return false;
+        }
+        if (verbose_)
+        {
+            std::cout << "[Shipping] Scheduling delivery to " << address << "\n";
+        }
+        Zone &zone = zones_[zoneOf(address)];
+        const std::uint64_t seq = sequence_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(zone.mutex);
+        zone.pending.push({orderId, seq, weightKg, priority});
+        return true;
+    }
+
+    // Packs everything queued so far and returns the routes sealed by this
+    // wave. Routes that cannot take even a light parcel are sealed
+    // immediately; with finalWave, all open routes are.
+    std::vector<RouteBatch> planWave(bool finalWave = false)
+    {
+        std::vector<RouteBatch> sealed;
+        for (std::size_t z = 0; z < kZones; ++z)
+        {
+            Zone &zone = zones_[z];
+            std::vector<RouteBatch> full;
+            {
+                std::lock_guard<std::mutex> lock(zone.mutex);
+                while (!zone.pending.empty())
+                {
+                    const Delivery d = zone.pending.top();
+                    zone.pending.pop();
+
+                    auto fit = zone.byRemaining.lower_bound(d.weightKg);
+                    std::size_t idx;
+                    if (fit == zone.byRemaining.end())
+                    {
+                        idx = zone.openRoutes.size();
+                        zone.openRoutes.push_back({z, 0, {}});
+                    }
+                    else
+                    {
+                        idx = fit->second;
+                        zone.byRemaining.erase(fit);
+                    }
+                    RouteBatch &route = zone.openRoutes[idx];
+                    route.loadKg += d.weightKg;
+                    route.orders.push_back(d.orderId);
+                    zone.byRemaining.emplace(kTruckCapacityKg - route.loadKg, idx);
+                }
+
+                // Seal routes that are (nearly) full, or everything on the final wave
+                std::vector<RouteBatch> keep;
+                for (auto &route : zone.openRoutes)
+                {
+                    if (finalWave || kTruckCapacityKg - route.loadKg < 1.0)
+                    {
+                        full.push_back(std::move(route));
+                    }
+                    else
+                    {
+                        keep.push_back(std::move(route));
+                    }
+                }
+                zone.openRoutes = std::move(keep);
+                zone.byRemaining.clear();
+                for (std::size_t i = 0; i < zone.openRoutes.size(); ++i)
+                {
+                    zone.byRemaining.emplace(kTruckCapacityKg - zone.openRoutes[i].loadKg, i);
+                }
+            }
+            seal(full);
+            std::move(full.begin(), full.end(), std::back_inserter(sealed));
+        }
+        return sealed;
+    }
+
+    ShippingStats stats()
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        ShippingStats s = stats_;
+        s.avgFill = s.routes ? fillSum_ / s.routes : 0;
+        return s;
     }
 };
 
 class Notification
 {
+private:
+    bool verbose_;
+
 public:
+    explicit Notification(bool verbose = true) : verbose_(verbose) {}
+
     void sendConfirmation(const std::string &email, const std::string &orderId)
     {
-        std::cout << "[Notification] Sending confirmation email to " << email
-                  << " for order " << orderId << "\n";
+        if (verbose_)
+        {
+            std::cout << "[Notification] Sending confirmation email to " << email
+                      << " for order " << orderId << "\n";
+        }
     }
 };
 
@@ -315,35 +641,140 @@ private:
     Payment payment_;
     Shipping shipping_;
     Notification notification_;
+    std::atomic<std::uint64_t> nextOrderId_{123456};
+    bool verbose_;
 
 public:
+    explicit OrderFacade(bool verbose = true)
+        : inventory_(verbose), payment_(verbose), shipping_(verbose),
+          notification_(verbose), verbose_(verbose) {}
+
+    // Direct subsystem access stays available (facade does not hide it)
+    Inventory &inventory() { return inventory_; }
+    Shipping &shipping() { return shipping_; }
+
     bool placeOrder(const std::string &productId, const std::string &cardNumber,
-                    const std::string &address, const std::string &email)
+                    const std::string &address, const std::string &email,
+                    DeliveryPriority priority = DeliveryPriority::Standard)
     {
-        std::cout << "\n=== Processing order ===\n";
+        if (verbose_)
+        {
+            std::cout << "\n=== Processing order ===\n";
+        }
 
-        if (!inventory_.checkAvailability(productId))
+        const double weightKg = inventory_.weightOf(productId);
+        if (!Shipping::canCarry(weightKg))
         {
-            std::cout << "Order failed: Product not available\n";
+            if (verbose_)
+            {
+                std::cout << "Order failed: " << weightKg << " kg exceeds truck capacity\n";
+            }
             return false;
         }
 
-        inventory_.reserve(productId);
+        if (!inventory_.checkAvailability(productId) || !inventory_.reserve(productId))
+        {
+            if (verbose_)
+            {
+                std::cout << "Order failed: Product not available\n";
+            }
+            return false;
+        }
 
         if (!payment_.processPayment(cardNumber, 99.99))
         {
-            std::cout << "Order failed: Payment declined\n";
+            inventory_.release(productId); // don't leak the reservation
+            if (verbose_)
+            {
+                std::cout << "Order failed: Payment declined\n";
+            }
             return false;
         }
 
-        shipping_.scheduleDelivery(address);
-        notification_.sendConfirmation(email, "ORD123456");
+        const std::uint64_t orderId = nextOrderId_.fetch_add(1, std::memory_order_relaxed);
+        shipping_.scheduleDelivery(address, orderId, weightKg, priority);
+        notification_.sendConfirmation(email, "ORD" + std::to_string(orderId));
 
-        std::cout << "=== Order completed successfully! ===\n\n";
+        if (verbose_)
+        {
+            std::cout << "=== Order completed successfully! ===\n\n";
+        }
         return true;
     }
 };
 
+// Load generator: client threads hammer placeOrder() while a planner thread
+// runs a shipping wave every few milliseconds (like a dispatch cron).
+void benchmarkOrderFacade()
+{
+    constexpr int kClients = 4;
+    constexpr int kOrdersPerClient = 100000;
+    constexpr int kProducts = 10000;
+    constexpr int kStockPerProduct = 35; // ~12% of orders hit out-of-stock
+
+    std::cout << "\n--- Order Facade load test (" << kClients << " clients x "
+              << kOrdersPerClient << " orders) ---\n";
+
+    OrderFacade facade(false);
+    for (int p = 0; p < kProducts; ++p)
+    {
+        facade.inventory().addStock("SKU-" + std::to_string(p), kStockPerProduct, 0.5 + (p % 40));
+    }
+    const long stockBefore = facade.inventory().totalAvailable();
+
+    std::atomic<bool> clientsDone{false};
+    std::size_t dispatched = 0; // planner thread only, read after join
+    std::thread planner([&]() {
+        while (!clientsDone.load())
+        {
+            dispatched += facade.shipping().planWave().size(); // hand routes to trucks
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    std::atomic<long> accepted{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (int c = 0; c < kClients; ++c)
+    {
+        clients.emplace_back([&, c]() {
+            std::mt19937 rng(c + 1);
+            std::uniform_int_distribution<int> product(0, kProducts - 1);
+            std::uniform_int_distribution<int> percent(0, 99);
+            long ok = 0;
+            for (int i = 0; i < kOrdersPerClient; ++i)
+            {
+                const int p = product(rng);
+                ok += facade.placeOrder("SKU-" + std::to_string(p), "4111111111111111",
+                                        std::to_string(p * 7 + c) + " Main St", "user@example.com",
+                                        percent(rng) < 20 ? DeliveryPriority::Express
+                                                          : DeliveryPriority::Standard);
+            }
+            accepted += ok;
+        });
+    }
+    for (auto &client : clients)
+    {
+        client.join();
+    }
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    clientsDone = true;
+    planner.join();
+    dispatched += facade.shipping().planWave(true).size();
+
+    const long total = static_cast<long>(kClients) * kOrdersPerClient;
+    const long reserved = stockBefore - facade.inventory().totalAvailable();
+    const ShippingStats ship = facade.shipping().stats();
+    std::cout << "  " << static_cast<long>(total / seconds) << " orders/sec through OrderFacade\n"
+              << "  accepted " << accepted << ", rejected (out of stock) " << total - accepted
+              << ", units reserved " << reserved
+              << (reserved == accepted ? " (no oversell)" : " (MISMATCH!)") << "\n"
+              << "  " << ship.deliveries << " deliveries packed into " << ship.routes
+              << " routes (" << dispatched << " dispatched), avg truck fill "
+              << static_cast<int>(ship.avgFill * 100) << "%\n";
+}
+
 // ============================================================================
 // EXAMPLE 4: API client facade
 // ============================================================================
@@ -434,8 +865,23 @@ public:
 // Demonstration
 // ============================================================================
 
-int main()
+int main(int argc, char *argv[])
 {
+    bool bench = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--bench")
+        {
+            bench = true;
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--bench]\n";
+            return 2;
+        }
+    }
+
     std::cout << "=== FACADE PATTERN DEMO ===\n";
 
     // Home theater
@@ -458,8 +904,21 @@ int main()
     std::cout << "\n--- Order Processing Facade ---\n";
     {
         OrderFacade orderSystem;
+        orderSystem.inventory().addStock("PROD-001", 1);
         orderSystem.placeOrder("PROD-001", "4111111111111111",
                                "123 Main St", "user@example.com");
+        // Second order for the last unit fails: reserve() is authoritative
+        orderSystem.placeOrder("PROD-001", "4111111111111111",
+                               "456 Oak Ave", "other@example.com");
+        // A parcel no truck can carry is rejected before payment is taken
+        orderSystem.inventory().addStock("PIANO", 1, 900.0);
+        orderSystem.placeOrder("PIANO", "4111111111111111",
+                               "789 Pine Rd", "music@example.com");
+    }
+
+    if (bench)
+    {
+        benchmarkOrderFacade();
     }
 
     // API client
@@ -477,6 +936,11 @@ int main()
     std::cout << "4. Promotes weak coupling and subsystem independence\n";
     std::cout << "5. Easy to use API for common use cases\n";
 
+    if (!bench)
+    {
+        std::cout << "\n(run with --bench for the order facade load test)\n";
+    }
+
     return 0;
 }
 
@@ -1,3 +1,6 @@
+#include <chrono>
+#include <initializer_list>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -7,6 +10,11 @@
  * Goal: Demonstrate two levels of exception safety guarantees:
  * 1. Basic guarantee: If exception occurs, object is in a valid but possibly modified state
  * 2. Strong guarantee: If exception occurs, object state is completely unchanged (rollback)
+ *
+ * Two ways to get the strong guarantee:
+ * - copy-and-swap: modify a full copy, swap on success -> O(n) per add
+ * - undo log: modify in place, record how to reverse each step, roll back
+ *   on failure -> O(1) per add, and several steps can form ONE transaction
  */
 
 // Simulate an operation that can throw - used to test exception paths
@@ -26,6 +34,46 @@ struct StringBag
 {
     std::vector<std::string> data;
 
+    // Undo log: one entry per mutation made inside an open Transaction
+    struct UndoEntry
+    {
+        enum Kind
+        {
+            Appended, // undo: pop_back()
+            Assigned  // undo: data[index] = old
+        } kind;
+        size_t index;
+        std::string old;
+    };
+    std::vector<UndoEntry> log;
+
+    // RAII transaction: rolls back everything after its mark unless committed.
+    // Transactions nest: an inner commit keeps its entries for the outer one.
+    class Transaction
+    {
+        StringBag &bag;
+        size_t mark;
+        bool committed = false;
+
+    public:
+        explicit Transaction(StringBag &b) : bag(b), mark(b.log.size()) {}
+        Transaction(const Transaction &) = delete;
+        Transaction &operator=(const Transaction &) = delete;
+
+        void commit() noexcept
+        {
+            committed = true;
+            if (mark == 0)
+                bag.log.clear(); // outermost: nothing can be undone any more
+        }
+
+        ~Transaction()
+        {
+            if (!committed)
+                bag.rollback_to(mark);
+        }
+    };
+
     // BASIC GUARANTEE: Object remains valid, but state may be partially modified
     // - If exception occurs, the string was already added to data
     // - State is consistent but different from before the call
@@ -37,19 +85,127 @@ struct StringBag
         // continue work...
     }
 
-    // STRONG GUARANTEE: All-or-nothing (transactional/atomic behavior)
+    // STRONG GUARANTEE via copy-and-swap: All-or-nothing (transactional/atomic behavior)
     // - If exception occurs, object state is completely unchanged
     // - If no exception, changes are committed
-    // - Pattern: copy-modify-swap (or copy-and-swap idiom)
-    void add_strong(const std::string &s, const MaybeThrow &op)
+    // - Cost: copies EVERY string on every add - O(n)
+    void add_copy_swap(const std::string &s, const MaybeThrow &op)
     {
         auto snapshot = data;  // 1. Create copy of current state
         snapshot.push_back(s); // 2. Modify the copy only
         op();                  // 3. Risky operation - may throw; original data still intact!
         data.swap(snapshot);   // 4. Commit: swap only if we got here (no throw)
     }
+
+    // STRONG GUARANTEE via undo log: same all-or-nothing result, O(1)
+    // - Mutate in place, the Transaction undoes it if op() throws
+    void add_strong(const std::string &s, const MaybeThrow &op)
+    {
+        Transaction tx(*this);
+        append(s);
+        op(); // may throw: ~Transaction pops the string again
+        tx.commit();
+    }
+
+    // Several mutations, one transaction: all of them stay or none do
+    void add_many_strong(std::initializer_list<std::string> items, const MaybeThrow &op)
+    {
+        Transaction tx(*this);
+        for (const std::string &s : items)
+            append(s);
+        op();
+        tx.commit();
+    }
+
+    void replace_strong(size_t index, const std::string &s, const MaybeThrow &op)
+    {
+        Transaction tx(*this);
+        assign(index, s);
+        op();
+        tx.commit();
+    }
+
+private:
+    // Room for one more undo entry. Grows geometrically: reserve(size() + 1)
+    // would reallocate on every call and make a large batch O(n^2).
+    void reserve_log_slot()
+    {
+        if (log.size() == log.capacity())
+            log.reserve(2 * log.size() + 1);
+    }
+
+    // Each logged mutation is itself strong: everything that can throw
+    // (log growth, vector growth, string copy) happens before the first change.
+    void append(const std::string &s)
+    {
+        reserve_log_slot(); // may throw: nothing changed yet
+        data.push_back(s);           // strong by itself
+        log.push_back({UndoEntry::Appended, data.size() - 1, {}}); // capacity reserved: no throw
+    }
+
+    void assign(size_t index, const std::string &s)
+    {
+        std::string fresh = s; // may throw: nothing changed yet
+        reserve_log_slot();
+        log.push_back({UndoEntry::Assigned, index, std::move(data.at(index))});
+        data[index] = std::move(fresh);
+    }
+
+    // noexcept: pop_back and string move-assignment cannot throw
+    void rollback_to(size_t mark) noexcept
+    {
+        while (log.size() > mark)
+        {
+            UndoEntry &e = log.back();
+            if (e.kind == UndoEntry::Appended)
+                data.pop_back();
+            else
+                data[e.index] = std::move(e.old);
+            log.pop_back();
+        }
+    }
 };
 
+// Benchmark: throughput of `batch` adds into a bag that already holds n strings
+// (every 100th add fails and must roll back). Copy-and-swap degrades with n.
+template <typename Add>
+double adds_per_sec(size_t n, size_t batch, Add add)
+{
+    StringBag bag;
+    for (size_t i = 0; i < n; ++i)
+        bag.data.push_back("existing item #" + std::to_string(i));
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < batch; ++i)
+    {
+        try
+        {
+            add(bag, "new item #" + std::to_string(i), MaybeThrow(i % 100 == 99));
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (bag.data.size() != n + batch - batch / 100)
+        std::cout << "  (rollback mismatch!)\n";
+    return batch / secs;
+}
+
+void benchmark_strong_adds()
+{
+    std::cout << "\n-- Strong-guarantee add throughput (adds/sec) --\n";
+    std::cout << std::setw(10) << "n" << std::setw(16) << "copy-and-swap" << std::setw(14) << "undo log" << "\n";
+    for (size_t n : {1000, 10000, 100000})
+    {
+        size_t batch = n >= 100000 ? 200 : 2000;
+        double copy = adds_per_sec(n, batch, [](StringBag &b, const std::string &s, const MaybeThrow &op)
+                                   { b.add_copy_swap(s, op); });
+        double undo = adds_per_sec(n, 20000, [](StringBag &b, const std::string &s, const MaybeThrow &op)
+                                   { b.add_strong(s, op); });
+        std::cout << std::setw(10) << n << std::setw(16) << long(copy) << std::setw(14) << long(undo) << "\n";
+    }
+}
+
 int main()
 {
     std::cout << "-- Exception safety: basic vs strong --\n";
@@ -79,6 +235,26 @@ int main()
     // Result: operation rolled back completely, size still = 1 (state unchanged)
     std::cout << "Size after add_strong failure: " << bag.data.size() << " (unchanged)\n";
 
+    // TEST 2b: a multi-step transaction rolls back every step, including a replace
+    try
+    {
+        bag.add_many_strong({"x", "y", "z"}, MaybeThrow(true));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "add_many_strong failed: " << e.what() << "\n";
+    }
+    try
+    {
+        bag.replace_strong(0, "ALPHA", MaybeThrow(true));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "replace_strong failed: " << e.what() << "\n";
+    }
+    std::cout << "After failed transactions: size " << bag.data.size() << ", data[0] = " << bag.data[0]
+              << " (unchanged)\n";
+
     // TEST 3: Success path - no exception thrown
     bag.add_strong("gamma", MaybeThrow(false)); // won't throw, commits successfully
     std::cout << "Final contents:";
@@ -86,5 +262,8 @@ int main()
         std::cout << ' ' << s; // Should show: alpha gamma (beta was never added)
     std::cout << "\n";
 
+    benchmark_strong_adds();
+
     // Summary: Basic guarantee leaves partial modifications, Strong guarantee ensures atomicity
+    // An undo log gives the strong guarantee without paying for a full copy
 }
@@ -1,7 +1,13 @@
+#include <chrono>
 #include <future>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include "future_chain.h"
 
 /*
  * Goal: Demonstrate exception handling with async tasks and type-erased exception pointers
@@ -11,6 +17,11 @@
  * 2. std::async - automatically captures and propagates exceptions from background threads
  * 3. std::current_exception() - capture active exception without knowing its type
  * 4. std::rethrow_exception() - throw a stored exception
+ * 5. Continuations (future_chain.h) - fut::async(...).then(...).recover(...):
+ *    the exception_ptr travels down the chain instead of being rethrown at
+ *    every get(), and every step runs on one shared thread pool
+ *
+ * Benchmark at the end: cost per continuation and tasks/sec vs std::async.
  */
 
 // Background task that will throw an exception
@@ -36,6 +47,183 @@ void capture_exception(std::exception_ptr &eptr)
     }
 }
 
+// ---------------------------------------------------------------------------
+// Continuation pipelines (future_chain.h)
+// ---------------------------------------------------------------------------
+
+int parse_port(const std::string &text)
+{
+    int port = std::stoi(text); // throws std::invalid_argument on "abc"
+    if (port <= 0 || port > 65535)
+        throw std::out_of_range("port out of range: " + text);
+    return port;
+}
+
+// load -> parse -> validate, with a fallback when any step threw
+int load_port(const std::string &config_value)
+{
+    return fut::async([config_value]
+                      { return config_value; })
+        .then(parse_port)
+        .then([](int port)
+              { return port < 1024 ? port + 8000 : port; }) // skipped if parse threw
+        .recover([](std::exception_ptr e)
+                 {
+                     try
+                     {
+                         std::rethrow_exception(e); // only here do we need the type
+                     }
+                     catch (const std::exception &ex)
+                     {
+                         std::cerr << "  recover(): " << ex.what() << " -> default 8080\n";
+                     }
+                     return 8080; })
+        .get();
+}
+
+void demonstrate_continuations()
+{
+    std::cout << "\n-- Continuations: exception_ptr flows down the chain --\n";
+    for (const char *value : {"443", "abc", "99999"})
+    {
+        int port = load_port(value); // may print from recover() first
+        std::cout << "  \"" << value << "\" -> port " << port << "\n";
+    }
+
+    // when_all: every value, or the first error (by index)
+    std::vector<fut::Future<int>> parts;
+    for (int i = 1; i <= 4; ++i)
+        parts.push_back(fut::async([i]
+                                   { return i * i; }));
+    std::vector<int> squares = fut::when_all(std::move(parts)).get();
+    std::cout << "  when_all squares: " << squares[0] << " " << squares[1] << " " << squares[2] << " "
+              << squares[3] << "\n";
+
+    std::vector<fut::Future<int>> failing;
+    failing.push_back(fut::async([]
+                                 { return 1; }));
+    failing.push_back(fut::async([]() -> int
+                                 { throw std::runtime_error("replica 1 down"); }));
+    try
+    {
+        fut::when_all(std::move(failing)).get();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "  when_all caught: " << e.what() << "\n";
+    }
+
+    // when_any: first SUCCESS wins, a failing replica does not
+    std::vector<fut::Future<std::string>> replicas;
+    replicas.push_back(fut::async([]() -> std::string
+                                  { throw std::runtime_error("replica A timeout"); }));
+    replicas.push_back(fut::async([]
+                                  {
+                                      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                                      return std::string("replica B answer"); }));
+    auto winner = fut::when_any(std::move(replicas)).get();
+    std::cout << "  when_any: #" << winner.first << " \"" << winner.second << "\"\n";
+
+    // Cancellation: links not yet started see the token and fail with cancelled_error
+    fut::CancellationSource source;
+    fut::Promise<int> gate;
+    auto chain = gate.get_future()
+                     .then([](int v)
+                           { return v + 1; }, source.token())
+                     .then([](int v)
+                           {
+                               std::cout << "  never printed\n";
+                               return v * 2; }, source.token());
+    source.cancel(); // before the input arrives
+    gate.set_value(1);
+    try
+    {
+        chain.get();
+    }
+    catch (const fut::cancelled_error &e)
+    {
+        std::cerr << "  cancelled chain: " << e.what() << "\n";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark: per-continuation overhead, tasks/sec
+// ---------------------------------------------------------------------------
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// std::async cannot chain: link i blocks a thread in get() on link i-1.
+double std_async_chain_us(int links)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::future<int> f = std::async(std::launch::async, []
+                                    { return 0; });
+    for (int i = 0; i < links; ++i)
+        f = std::async(std::launch::async, [prev = std::move(f)]() mutable
+                       { return prev.get() + 1; });
+    int result = f.get();
+    double us = seconds_since(start) * 1e6 / links;
+    return result == links ? us : -1;
+}
+
+double then_chain_us(int links)
+{
+    auto start = std::chrono::steady_clock::now();
+    fut::Promise<int> head;
+    fut::Future<int> f = head.get_future();
+    for (int i = 0; i < links; ++i)
+        f = f.then([](int v)
+                   { return v + 1; });
+    head.set_value(0);
+    int result = f.get();
+    double us = seconds_since(start) * 1e6 / links;
+    return result == links ? us : -1;
+}
+
+double std_async_tasks_per_sec(int tasks)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<int>> all;
+    all.reserve(tasks);
+    for (int i = 0; i < tasks; ++i)
+        all.push_back(std::async(std::launch::async, [i]
+                                 { return i; }));
+    long sum = 0;
+    for (auto &f : all)
+        sum += f.get();
+    return sum >= 0 ? tasks / seconds_since(start) : 0;
+}
+
+double fut_async_tasks_per_sec(int tasks)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<fut::Future<int>> all;
+    all.reserve(tasks);
+    for (int i = 0; i < tasks; ++i)
+        all.push_back(fut::async([i]
+                                 { return i; }));
+    long sum = 0;
+    for (int v : fut::when_all(std::move(all)).get())
+        sum += v;
+    return sum >= 0 ? tasks / seconds_since(start) : 0;
+}
+
+void benchmark_futures()
+{
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n-- Benchmark (shared executor: " << fut::Executor::shared().size() << " threads) --\n";
+    const int links = 2000, tasks = 20000;
+    std::cout << "  chain of " << links << " links, us per link:  std::async " << std_async_chain_us(links)
+              << "   then() " << then_chain_us(links) << "\n";
+    std::cout << "  chain of 200000 then() links, us per link: " << then_chain_us(200000) << "\n";
+    std::cout << "  " << tasks << " tasks, tasks/sec:          std::async " << long(std_async_tasks_per_sec(tasks))
+              << "   fut::async " << long(fut_async_tasks_per_sec(tasks)) << "\n";
+    std::cout << "  (std::async: one thread per task, the chain keeps " << links << " threads blocked in get())\n";
+}
+
 int main()
 {
     std::cout << "-- Exceptions with std::async and exception_ptr --\n";
@@ -71,8 +259,13 @@ int main()
         std::cerr << "rethrow_exception caught: " << e.what() << "\n";
     }
 
+    // TEST 3: the same propagation without blocking at every step
+    demonstrate_continuations();
+    benchmark_futures();
+
     // Summary:
     // - std::async transparently handles exceptions (stores in future)
     // - std::exception_ptr allows type-erased exception storage
     // - Useful for inter-thread exception propagation
+    // - Continuations forward the exception_ptr link to link; one get() at the end
 }
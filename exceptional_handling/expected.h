@@ -0,0 +1,201 @@
+#ifndef EXPECTED_H
+#define EXPECTED_H
+
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/*
+ * expected.h - a C++17 expected<T, E>: the value OR the reason it is missing
+ *
+ * Why a third error channel?
+ * - exceptions: free while nothing throws, but a throw costs an allocation plus
+ *   table-driven unwinding through every frame (microseconds) - bad when
+ *   failures are frequent (parsing untrusted input, cache misses, timeouts)
+ * - std::error_code out-parameter: cheap, but the value and the error travel
+ *   separately and nothing forces the caller to look at ec
+ * - expected<T, E>: one return value that is either T or E; the error is part
+ *   of the type, and failures cost a branch per frame, like error_code
+ *
+ * API (subset of C++23 std::expected):
+ *   ex::expected<int, std::error_code> r = 42;          // value
+ *   ex::expected<int, std::error_code> r = ex::unexpected(ec);  // error
+ *   if (r) use(*r); else log(r.error());
+ *   r.value()                 throws ex::bad_expected_access<E> if it holds an error
+ *   r.value_or(0)
+ *   r.and_then(f)             f(T) -> expected<U, E>; skipped on error
+ *   r.transform(f)            f(T) -> U, wrapped;      skipped on error
+ *   r.transform_error(f)      f(E) -> G, wrapped;      skipped on value
+ *   r.or_else(f)              f(E) -> expected<T, G>;  skipped on value
+ *
+ * Propagation without a monadic chain (the "?" / TRY idiom):
+ *   EXPECTED_TRY(size, file_size(p));  // declares `size`, or returns the error
+ *   EXPECTED_CHECK(remove(p));         // same, value discarded
+ */
+
+namespace ex
+{
+
+template <typename E>
+class unexpected
+{
+public:
+    explicit unexpected(E e) : error_(std::move(e)) {}
+    const E &error() const & { return error_; }
+    E &&error() && { return std::move(error_); }
+
+private:
+    E error_;
+};
+
+template <typename E>
+class bad_expected_access : public std::exception
+{
+public:
+    explicit bad_expected_access(E e) : error_(std::move(e)) {}
+    const char *what() const noexcept override { return "bad expected access: holds an error"; }
+    const E &error() const { return error_; }
+
+private:
+    E error_;
+};
+
+template <typename T, typename E>
+class expected
+{
+    static_assert(!std::is_void_v<T>, "expected<void, E> is not supported here: use a bool or tag type");
+    static_assert(!std::is_same_v<T, E>, "value and error types must differ");
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    expected() : v_(std::in_place_index<0>) {}
+    expected(const T &value) : v_(std::in_place_index<0>, value) {}
+    expected(T &&value) : v_(std::in_place_index<0>, std::move(value)) {}
+    template <typename G>
+    expected(const unexpected<G> &u) : v_(std::in_place_index<1>, u.error()) {}
+    template <typename G>
+    expected(unexpected<G> &&u) : v_(std::in_place_index<1>, std::move(u).error()) {}
+
+    bool has_value() const noexcept { return v_.index() == 0; }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    T &operator*() & { return *std::get_if<0>(&v_); }
+    const T &operator*() const & { return *std::get_if<0>(&v_); }
+    T &&operator*() && { return std::move(*std::get_if<0>(&v_)); }
+    T *operator->() { return std::get_if<0>(&v_); }
+    const T *operator->() const { return std::get_if<0>(&v_); }
+
+    T &value() &
+    {
+        if (!has_value())
+            throw bad_expected_access<E>(error());
+        return **this;
+    }
+    const T &value() const &
+    {
+        if (!has_value())
+            throw bad_expected_access<E>(error());
+        return **this;
+    }
+    T &&value() &&
+    {
+        if (!has_value())
+            throw bad_expected_access<E>(error());
+        return std::move(**this);
+    }
+
+    E &error() & { return *std::get_if<1>(&v_); }
+    const E &error() const & { return *std::get_if<1>(&v_); }
+    E &&error() && { return std::move(*std::get_if<1>(&v_)); }
+
+    template <typename U>
+    T value_or(U &&fallback) const &
+    {
+        return has_value() ? **this : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    // f(T) -> expected<U, E>
+    template <typename F>
+    auto and_then(F &&f) &&
+    {
+        using R = std::invoke_result_t<F, T &&>;
+        static_assert(std::is_same_v<typename R::error_type, E>, "and_then must keep the error type");
+        if (has_value())
+            return std::forward<F>(f)(std::move(**this));
+        return R(unexpected<E>(std::move(error())));
+    }
+    template <typename F>
+    auto and_then(F &&f) const &
+    {
+        using R = std::invoke_result_t<F, const T &>;
+        static_assert(std::is_same_v<typename R::error_type, E>, "and_then must keep the error type");
+        if (has_value())
+            return std::forward<F>(f)(**this);
+        return R(unexpected<E>(error()));
+    }
+
+    // f(T) -> U, result is expected<U, E>
+    template <typename F>
+    auto transform(F &&f) &&
+    {
+        using U = std::invoke_result_t<F, T &&>;
+        if (has_value())
+            return expected<U, E>(std::forward<F>(f)(std::move(**this)));
+        return expected<U, E>(unexpected<E>(std::move(error())));
+    }
+    template <typename F>
+    auto transform(F &&f) const &
+    {
+        using U = std::invoke_result_t<F, const T &>;
+        if (has_value())
+            return expected<U, E>(std::forward<F>(f)(**this));
+        return expected<U, E>(unexpected<E>(error()));
+    }
+
+    // f(E) -> G, result is expected<T, G>: add context, change error domain
+    template <typename F>
+    auto transform_error(F &&f) &&
+    {
+        using G = std::invoke_result_t<F, E &&>;
+        if (has_value())
+            return expected<T, G>(std::move(**this));
+        return expected<T, G>(unexpected<G>(std::forward<F>(f)(std::move(error()))));
+    }
+
+    // f(E) -> expected<T, G>: recover, or replace the error
+    template <typename F>
+    auto or_else(F &&f) &&
+    {
+        using R = std::invoke_result_t<F, E &&>;
+        static_assert(std::is_same_v<typename R::value_type, T>, "or_else must keep the value type");
+        if (has_value())
+            return R(std::move(**this));
+        return std::forward<F>(f)(std::move(error()));
+    }
+
+private:
+    std::variant<T, E> v_;
+};
+
+} // namespace ex
+
+// Binds `var` to the value of `expr`, or returns its error from the enclosing
+// function (which must return some ex::expected<U, E> with the same E).
+#define EXPECTED_TRY(var, expr)                                          \
+    auto var##_expected_ = (expr);                                       \
+    if (!var##_expected_)                                                \
+        return ::ex::unexpected(std::move(var##_expected_).error());     \
+    auto var = std::move(*var##_expected_)
+
+#define EXPECTED_CHECK(expr)                                             \
+    do                                                                   \
+    {                                                                    \
+        auto expected_check_ = (expr);                                   \
+        if (!expected_check_)                                            \
+            return ::ex::unexpected(std::move(expected_check_).error()); \
+    } while (0)
+
+#endif // EXPECTED_H
@@ -0,0 +1,589 @@
+#ifndef FUTURE_CHAIN_H
+#define FUTURE_CHAIN_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * future_chain.h - futures with continuations on a shared executor
+ *
+ * Why not std::future + std::async?
+ * - std::async(std::launch::async, f) starts a NEW THREAD for every task
+ * - the only way to "continue" is to block in get(), usually on yet another thread
+ *
+ * Here a future can be chained instead of waited on:
+ *
+ *   fut::async(load)                      runs on fut::Executor::shared()
+ *       .then(parse)                      runs when load finished, same pool
+ *       .then(validate, token)            skipped (cancelled_error) if token cancelled
+ *       .recover(fallback)                turns an exception_ptr back into a value
+ *       .get();                           the only blocking call
+ *
+ * Exception propagation: every link stores either a value or a std::exception_ptr.
+ * A link whose input holds an exception does NOT run; it forwards the same
+ * exception_ptr (no rethrow, no copy of the exception object) until a recover()
+ * or get() consumes it.
+ *
+ * Combinators: when_all (every value, or the first error by index) and
+ * when_any (the first VALUE to arrive; an error only if all inputs fail).
+ *
+ * Rules:
+ * - Future is move-only and has ONE consumer: then()/recover()/get() use it up
+ * - Never get() on an executor thread for work queued on the same executor:
+ *   with every worker blocked the pool deadlocks; chain with then() instead
+ * - A Promise destroyed without a value completes its future with broken_promise
+ */
+
+namespace fut
+{
+
+// ============================================================================
+// Executor: fixed pool of threads draining one job queue
+// ============================================================================
+
+class Executor
+{
+public:
+    explicit Executor(unsigned threads = 0)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; ++i)
+            workers_.emplace_back([this]
+                                  { run(); });
+    }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    // Finishes every queued job (continuations may queue more), then joins.
+    ~Executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread &t : workers_)
+            t.join();
+    }
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+    unsigned size() const { return unsigned(workers_.size()); }
+
+    static Executor &shared()
+    {
+        static Executor pool;
+        return pool;
+    }
+
+private:
+    void run()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                cv_.wait(lock, [this]
+                         { return stop_ || !jobs_.empty(); });
+                if (jobs_.empty())
+                    return; // stop_ and drained
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job(); // jobs never throw: fulfil() below captures exceptions
+        }
+    }
+
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
+
+// ============================================================================
+// Cancellation: a shared flag, checked before each link starts
+// ============================================================================
+
+struct cancelled_error : std::runtime_error
+{
+    cancelled_error() : std::runtime_error("operation cancelled") {}
+};
+
+class CancellationToken
+{
+public:
+    CancellationToken() = default; // a default token is never cancelled
+
+    bool cancelled() const { return flag_ && flag_->load(std::memory_order_acquire); }
+
+    // For long-running task bodies that want to stop early.
+    void throw_if_cancelled() const
+    {
+        if (cancelled())
+            throw cancelled_error();
+    }
+
+private:
+    friend class CancellationSource;
+    explicit CancellationToken(std::shared_ptr<std::atomic<bool>> flag) : flag_(std::move(flag)) {}
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+class CancellationSource
+{
+public:
+    CancellationSource() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+    CancellationToken token() const { return CancellationToken(flag_); }
+    void cancel() { flag_->store(true, std::memory_order_release); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+// ============================================================================
+// Shared state
+// ============================================================================
+
+template <typename T>
+class Future;
+template <typename T>
+class Promise;
+
+namespace detail
+{
+struct Access; // lets async()/when_all()/when_any() wrap a State in a Future
+
+struct Unit
+{
+};
+
+template <typename T>
+using stored_t = std::conditional_t<std::is_void_v<T>, Unit, T>;
+
+template <typename T>
+struct State
+{
+    std::mutex m;
+    std::condition_variable cv;
+    bool ready = false;
+    std::optional<stored_t<T>> value;
+    std::exception_ptr error;
+    std::function<void()> continuation; // at most one: a Future has one consumer
+
+    void set_value(stored_t<T> v)
+    {
+        finish([&]
+               { value.emplace(std::move(v)); });
+    }
+
+    void set_error(std::exception_ptr e)
+    {
+        finish([&]
+               { error = std::move(e); });
+    }
+
+    // Runs now if already complete, otherwise on the completing thread.
+    void on_ready(std::function<void()> f)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (!ready)
+            {
+                continuation = std::move(f);
+                return;
+            }
+        }
+        f();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [this]
+                { return ready; });
+    }
+
+private:
+    template <typename Fill>
+    void finish(Fill fill)
+    {
+        std::function<void()> next;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (ready)
+                throw std::future_error(std::future_errc::promise_already_satisfied);
+            fill();
+            ready = true;
+            next = std::move(continuation);
+        }
+        cv.notify_all();
+        if (next)
+            next();
+    }
+};
+
+// Runs fn, stores its result or the exception it threw.
+template <typename R, typename Fn>
+void fulfil(State<R> &state, Fn &&fn)
+{
+    std::optional<stored_t<R>> value;
+    std::exception_ptr error;
+    try
+    {
+        if constexpr (std::is_void_v<R>)
+        {
+            fn();
+            value.emplace();
+        }
+        else
+        {
+            value.emplace(fn());
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    if (error)
+        state.set_error(std::move(error));
+    else
+        state.set_value(std::move(*value));
+}
+
+template <typename F, typename T, typename = void>
+struct then_result
+{
+    using type = std::invoke_result_t<F, T>;
+};
+
+template <typename F, typename T>
+struct then_result<F, T, std::enable_if_t<std::is_void_v<T>>>
+{
+    using type = std::invoke_result_t<F>;
+};
+
+} // namespace detail
+
+// ============================================================================
+// Future / Promise
+// ============================================================================
+
+template <typename T>
+class Future
+{
+public:
+    Future() = default;
+    Future(Future &&) noexcept = default;
+    Future &operator=(Future &&) noexcept = default;
+    Future(const Future &) = delete;
+    Future &operator=(const Future &) = delete;
+
+    bool valid() const { return state_ != nullptr; }
+
+    bool ready() const
+    {
+        std::lock_guard<std::mutex> lock(state_->m);
+        return state_->ready;
+    }
+
+    // Blocks, then returns the value or rethrows the stored exception.
+    T get()
+    {
+        std::shared_ptr<detail::State<T>> s = std::move(state_);
+        if (!s)
+            throw std::future_error(std::future_errc::no_state);
+        s->wait();
+        if (s->error)
+            std::rethrow_exception(s->error);
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*s->value);
+    }
+
+    // f(T) -> R (or f() for Future<void>), queued on the executor once this
+    // future is ready. Skipped - exception forwarded - if this future failed;
+    // skipped with cancelled_error if token is cancelled by then.
+    template <typename F>
+    auto then(F f, CancellationToken token = {}) -> Future<typename detail::then_result<F, T>::type>
+    {
+        using R = typename detail::then_result<F, T>::type;
+        auto prev = take();
+        auto next = std::make_shared<detail::State<R>>();
+        Executor *exec = exec_;
+        detail::State<T> *raw = prev.get();
+        raw->on_ready([prev, next, exec, f = std::move(f), token]() mutable
+                      { exec->submit([prev, next, f = std::move(f), token]() mutable
+                                     {
+                                         if (prev->error)
+                                         {
+                                             next->set_error(prev->error); // forward, do not run f
+                                             return;
+                                         }
+                                         detail::fulfil(*next, [&]() -> R
+                                                        {
+                                                            token.throw_if_cancelled();
+                                                            if constexpr (std::is_void_v<T>)
+                                                                return f();
+                                                            else
+                                                                return f(std::move(*prev->value));
+                                                        });
+                                     }); });
+        return Future<R>(std::move(next), exec);
+    }
+
+    // f(std::exception_ptr) -> T runs only if this future failed; a value
+    // passes through untouched. f may rethrow to keep the chain failed.
+    template <typename F>
+    Future<T> recover(F f)
+    {
+        auto prev = take();
+        auto next = std::make_shared<detail::State<T>>();
+        Executor *exec = exec_;
+        detail::State<T> *raw = prev.get();
+        raw->on_ready([prev, next, exec, f = std::move(f)]() mutable
+                      {
+                          if (!prev->error)
+                          {
+                              next->set_value(std::move(*prev->value)); // fast path, no hop
+                              return;
+                          }
+                          exec->submit([prev, next, f = std::move(f)]() mutable
+                                       { detail::fulfil(*next, [&]
+                                                        { return f(prev->error); }); }); });
+        return Future<T>(std::move(next), exec);
+    }
+
+private:
+    template <typename>
+    friend class Future;
+    template <typename>
+    friend class Promise;
+    friend struct detail::Access;
+
+    Future(std::shared_ptr<detail::State<T>> s, Executor *exec) : state_(std::move(s)), exec_(exec) {}
+
+    std::shared_ptr<detail::State<T>> take()
+    {
+        if (!state_)
+            throw std::future_error(std::future_errc::no_state);
+        return std::move(state_);
+    }
+
+    std::shared_ptr<detail::State<T>> state_;
+    Executor *exec_ = nullptr;
+};
+
+template <typename T>
+class Promise
+{
+public:
+    explicit Promise(Executor &exec = Executor::shared())
+        : state_(std::make_shared<detail::State<T>>()), exec_(&exec) {}
+
+    Promise(Promise &&) noexcept = default;
+    Promise &operator=(Promise &&) = delete;
+    Promise(const Promise &) = delete;
+    Promise &operator=(const Promise &) = delete;
+
+    ~Promise()
+    {
+        if (state_ && !satisfied_)
+            state_->set_error(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+    }
+
+    Future<T> get_future() { return Future<T>(state_, exec_); }
+
+    template <typename... Args>
+    void set_value(Args &&...args)
+    {
+        satisfied_ = true;
+        state_->set_value(detail::stored_t<T>(std::forward<Args>(args)...));
+    }
+
+    void set_exception(std::exception_ptr e)
+    {
+        satisfied_ = true;
+        state_->set_error(std::move(e));
+    }
+
+private:
+    std::shared_ptr<detail::State<T>> state_;
+    Executor *exec_;
+    bool satisfied_ = false;
+};
+
+// ============================================================================
+// Entry points and combinators
+// ============================================================================
+
+namespace detail
+{
+struct Access
+{
+    template <typename T>
+    static Future<T> make(std::shared_ptr<State<T>> s, Executor *exec) { return Future<T>(std::move(s), exec); }
+
+    template <typename T>
+    static std::shared_ptr<State<T>> take(Future<T> &f) { return f.take(); }
+
+    template <typename T>
+    static Executor *executor(const Future<T> &f) { return f.exec_; }
+};
+} // namespace detail
+
+// Runs f() on the executor: one queued job, no thread created.
+template <typename F>
+auto async(F f, CancellationToken token = {}, Executor &exec = Executor::shared())
+    -> Future<std::invoke_result_t<F>>
+{
+    using R = std::invoke_result_t<F>;
+    auto state = std::make_shared<detail::State<R>>();
+    exec.submit([state, f = std::move(f), token]() mutable
+                { detail::fulfil(*state, [&]() -> R
+                                 {
+                                     token.throw_if_cancelled();
+                                     return f();
+                                 }); });
+    return detail::Access::make(std::move(state), &exec);
+}
+
+template <typename T>
+Future<T> make_ready_future(T value, Executor &exec = Executor::shared())
+{
+    auto state = std::make_shared<detail::State<T>>();
+    state->set_value(std::move(value));
+    return detail::Access::make(std::move(state), &exec);
+}
+
+// Ready when every input is; holds all values in input order, or the
+// lowest-index error. The bookkeeping runs inline on the completing thread.
+template <typename T>
+Future<std::vector<T>> when_all(std::vector<Future<T>> futures)
+{
+    static_assert(!std::is_void_v<T>, "when_all collects values: use Future<T> with a non-void T");
+    Executor *exec = futures.empty() ? &Executor::shared() : detail::Access::executor(futures.front());
+    auto out = std::make_shared<detail::State<std::vector<T>>>();
+    if (futures.empty())
+    {
+        out->set_value({});
+        return detail::Access::make(std::move(out), exec);
+    }
+
+    struct Gather
+    {
+        std::mutex m;
+        std::vector<std::optional<T>> values;
+        std::exception_ptr error;
+        size_t error_index = 0;
+        size_t remaining;
+    };
+    auto g = std::make_shared<Gather>();
+    g->values.resize(futures.size());
+    g->remaining = futures.size();
+
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        auto in = detail::Access::take(futures[i]);
+        detail::State<T> *raw = in.get();
+        raw->on_ready([g, out, in, i]
+                      {
+                          bool last;
+                          {
+                              std::lock_guard<std::mutex> lock(g->m);
+                              if (in->error && (!g->error || i < g->error_index))
+                              {
+                                  g->error = in->error;
+                                  g->error_index = i;
+                              }
+                              else if (!in->error)
+                              {
+                                  g->values[i] = std::move(*in->value);
+                              }
+                              last = --g->remaining == 0;
+                          }
+                          if (!last)
+                              return;
+                          if (g->error)
+                          {
+                              out->set_error(g->error);
+                              return;
+                          }
+                          std::vector<T> all;
+                          all.reserve(g->values.size());
+                          for (std::optional<T> &v : g->values)
+                              all.push_back(std::move(*v));
+                          out->set_value(std::move(all)); });
+    }
+    return detail::Access::make(std::move(out), exec);
+}
+
+// Ready with {index, value} of the first input to SUCCEED; fails only if
+// every input fails (with the first error to arrive).
+template <typename T>
+Future<std::pair<size_t, T>> when_any(std::vector<Future<T>> futures)
+{
+    static_assert(!std::is_void_v<T>, "when_any returns the winning value: use a non-void T");
+    if (futures.empty())
+        throw std::invalid_argument("when_any: no futures");
+    Executor *exec = detail::Access::executor(futures.front());
+    auto out = std::make_shared<detail::State<std::pair<size_t, T>>>();
+
+    struct Race
+    {
+        std::atomic<bool> won{false};
+        std::atomic<size_t> failed{0};
+        std::mutex m;
+        std::exception_ptr first_error;
+        size_t total;
+    };
+    auto race = std::make_shared<Race>();
+    race->total = futures.size();
+
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        auto in = detail::Access::take(futures[i]);
+        detail::State<T> *raw = in.get();
+        raw->on_ready([race, out, in, i]
+                      {
+                          if (!in->error)
+                          {
+                              if (!race->won.exchange(true))
+                                  out->set_value(std::make_pair(i, std::move(*in->value)));
+                              return;
+                          }
+                          {
+                              std::lock_guard<std::mutex> lock(race->m);
+                              if (!race->first_error)
+                                  race->first_error = in->error;
+                          }
+                          if (race->failed.fetch_add(1) + 1 == race->total && !race->won.exchange(true))
+                              out->set_error(race->first_error); });
+    }
+    return detail::Access::make(std::move(out), exec);
+}
+
+} // namespace fut
+
+#endif // FUTURE_CHAIN_H
@@ -0,0 +1,253 @@
+#ifndef CALLABLE_H
+#define CALLABLE_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+ * ARCHITECTURAL NOTE: three ways to hold "something callable" without std::function
+ *
+ * std::function<R(Args...)> can hold ANY copyable callable. The price:
+ * - a closure larger than its small buffer (16 bytes in libstdc++) goes on the heap
+ * - every call is an indirect call through a manager the optimizer cannot see
+ *
+ * fn::function_ref<R(Args...)>        NON-OWNING: two pointers (object + thunk).
+ *     Never allocates, trivially copyable. For parameters only: the callable
+ *     must outlive the function_ref (like std::string_view for strings).
+ *
+ * fn::inplace_function<R(Args...), N> OWNING, N bytes of inline storage.
+ *     Never allocates: a closure larger than N is a COMPILE error, not a
+ *     silent malloc. Use it to store callbacks (queues, tables, members).
+ *
+ * fn::JumpTable<Enum, Sig, Count>     dense array of function pointers indexed
+ *     by an enum, sized by Enum::count, built and checked at compile time
+ *     (every key exactly once; a missing key does not compile).
+ *     One indexed load + one indirect call; the switch-statement equivalent
+ *     without the switch.
+ *
+ * A template parameter (template <typename F> void run(F f)) is still the
+ * fastest: the compiler sees the lambda and inlines it. Type erasure is for
+ * when the callable must cross a non-template boundary.
+ */
+
+namespace fn {
+
+// ---------------------------------------------------------------------------
+// function_ref
+// ---------------------------------------------------------------------------
+
+template <typename Sig>
+class function_ref;
+
+template <typename R, typename... Args>
+class function_ref<R(Args...)> {
+public:
+    // Any callable object (lambda, functor, std::function...), by reference
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, function_ref> &&
+                                          !std::is_function_v<std::remove_reference_t<F>> &&
+                                          std::is_invocable_r_v<R, F&, Args...>>>
+    function_ref(F&& f) noexcept : call_(&call_object<std::remove_reference_t<F>>) {
+        target_.obj = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+    }
+
+    // Plain functions: store the function pointer itself
+    function_ref(R (*f)(Args...)) noexcept : call_(&call_function) {
+        target_.fn = reinterpret_cast<void (*)()>(f);
+    }
+
+    R operator()(Args... args) const { return call_(target_, std::forward<Args>(args)...); }
+
+private:
+    union Target {
+        void* obj;
+        void (*fn)();  // any function pointer type round-trips through this one
+    };
+
+    template <typename F>
+    static R call_object(Target t, Args... args) {
+        return std::invoke(*static_cast<F*>(t.obj), std::forward<Args>(args)...);
+    }
+
+    static R call_function(Target t, Args... args) {
+        return reinterpret_cast<R (*)(Args...)>(t.fn)(std::forward<Args>(args)...);
+    }
+
+    Target target_;
+    R (*call_)(Target, Args...);
+};
+
+// ---------------------------------------------------------------------------
+// inplace_function
+// ---------------------------------------------------------------------------
+
+template <typename Sig, std::size_t Capacity = 32>
+class inplace_function;
+
+template <typename R, typename... Args, std::size_t Capacity>
+class inplace_function<R(Args...), Capacity> {
+    // One static table per stored type: a hand-made vtable
+    struct Ops {
+        R (*call)(void*, Args...);
+        void (*copy)(void* dst, const void* src);
+        void (*relocate)(void* dst, void* src) noexcept;  // move into dst, destroy src
+        void (*destroy)(void*) noexcept;
+    };
+
+    template <typename F>
+    static R call_impl(void* p, Args... args) {
+        return std::invoke(*static_cast<F*>(p), std::forward<Args>(args)...);
+    }
+    template <typename F>
+    static void copy_impl(void* dst, const void* src) {
+        ::new (dst) F(*static_cast<const F*>(src));
+    }
+    template <typename F>
+    static void relocate_impl(void* dst, void* src) noexcept {
+        ::new (dst) F(std::move(*static_cast<F*>(src)));
+        static_cast<F*>(src)->~F();
+    }
+    template <typename F>
+    static void destroy_impl(void* p) noexcept {
+        static_cast<F*>(p)->~F();
+    }
+
+    template <typename F>
+    static constexpr Ops ops_for{&call_impl<F>, &copy_impl<F>, &relocate_impl<F>, &destroy_impl<F>};
+
+public:
+    inplace_function() noexcept = default;
+    inplace_function(std::nullptr_t) noexcept {}
+
+    template <typename F, typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<D, inplace_function> &&
+                                          std::is_invocable_r_v<R, D&, Args...>>>
+    inplace_function(F&& f) {
+        static_assert(sizeof(D) <= Capacity, "closure does not fit: raise inplace_function's Capacity");
+        static_assert(alignof(D) <= alignof(std::max_align_t), "over-aligned closure");
+        static_assert(std::is_copy_constructible_v<D>, "inplace_function needs a copyable callable");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "the callable's move must not throw");
+        ::new (static_cast<void*>(storage_)) D(std::forward<F>(f));
+        ops_ = &ops_for<D>;
+    }
+
+    inplace_function(const inplace_function& other) {
+        if (other.ops_) {
+            other.ops_->copy(storage_, other.storage_);
+            ops_ = other.ops_;
+        }
+    }
+
+    inplace_function(inplace_function&& other) noexcept {
+        if (other.ops_) {
+            other.ops_->relocate(storage_, other.storage_);
+            ops_ = std::exchange(other.ops_, nullptr);
+        }
+    }
+
+    // Copy-and-swap: `other` is already our copy (or a moved-from original)
+    inplace_function& operator=(inplace_function other) noexcept {
+        reset();
+        if (other.ops_) {
+            other.ops_->relocate(storage_, other.storage_);
+            ops_ = std::exchange(other.ops_, nullptr);
+        }
+        return *this;
+    }
+
+    ~inplace_function() { reset(); }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    R operator()(Args... args) const {
+        if (!ops_) throw std::bad_function_call();
+        return ops_->call(const_cast<unsigned char*>(storage_), std::forward<Args>(args)...);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    const Ops* ops_ = nullptr;
+};
+
+// ---------------------------------------------------------------------------
+// JumpTable: enum -> function, dense, built at compile time
+// ---------------------------------------------------------------------------
+
+template <typename Enum, typename Sig>
+struct Entry {
+    Enum key;
+    Sig* fn;
+};
+
+// Count is the number of keys, taken from the enum's trailing `count`
+// enumerator (or given explicitly). It is NOT deduced from the entries: a
+// table one entry short must not silently shrink and then be indexed past
+// its end by the last key.
+template <typename Enum, typename Sig, std::size_t Count = static_cast<std::size_t>(Enum::count)>
+class JumpTable {
+public:
+    // Exactly Count entries, each key once. In a constexpr context a bad
+    // registry does not compile: the throw is evaluated at compile time and
+    // is not a constant expression.
+    template <std::size_t N>
+    constexpr explicit JumpTable(const Entry<Enum, Sig> (&entries)[N]) : table_{} {
+        static_assert(N == Count, "JumpTable: register every key of the enum exactly once");
+        for (const Entry<Enum, Sig>& e : entries) {
+            std::size_t i = static_cast<std::size_t>(e.key);
+            if (i >= Count) throw std::logic_error("JumpTable: key outside 0..Count-1 (a gap in the enum?)");
+            if (table_[i]) throw std::logic_error("JumpTable: key registered twice");
+            if (!e.fn) throw std::logic_error("JumpTable: null function");
+            table_[i] = e.fn;
+        }
+    }
+
+    template <typename... Args>
+    constexpr decltype(auto) operator()(Enum key, Args&&... args) const {
+        return table_[index(key)](std::forward<Args>(args)...);
+    }
+
+    constexpr Sig* operator[](Enum key) const { return table_[index(key)]; }
+    static constexpr std::size_t size() { return Count; }
+
+private:
+    // Debug builds reject keys that are not enumerators below `count`
+    // (Enum::count itself, or a value cast in from an int); -DNDEBUG drops
+    // the check and leaves the bare indexed load.
+    static constexpr std::size_t index(Enum key) {
+        std::size_t i = static_cast<std::size_t>(key);
+#ifndef NDEBUG
+        if (i >= Count) throw std::out_of_range("JumpTable: key outside 0..Count-1");
+#endif
+        return i;
+    }
+
+    std::array<Sig*, Count> table_;
+};
+
+// constexpr auto ops = fn::make_jump_table<Op, int(int, int)>({{Op::Add, add}, {Op::Sub, sub}});
+// Op must end in `count`; for an enum without one, pass the key count:
+// fn::make_jump_table<Op, int(int, int), 2>(...). N (the entries) is deduced
+// and must equal Count.
+template <typename Enum, typename Sig, std::size_t Count = static_cast<std::size_t>(Enum::count), std::size_t N>
+constexpr JumpTable<Enum, Sig, Count> make_jump_table(const Entry<Enum, Sig> (&entries)[N]) {
+    return JumpTable<Enum, Sig, Count>(entries);
+}
+
+}  // namespace fn
+
+#endif  // CALLABLE_H
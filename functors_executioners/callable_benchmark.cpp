@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../constructors_destructors/copy_profiler.h"
+#include "callable.h"
+
+/*
+ * BENCHMARK: how much does each way of passing a callable cost?
+ *
+ * Same work (sum of f(i) for i in 0..n) through:
+ *   template      template <typename F> loop(F f): the lambda is inlined
+ *   raw pointer   int (*)(void* ctx, int): C-style callback + context pointer
+ *   std::function may heap-allocate the closure, indirect call
+ *   function_ref  two pointers, indirect call, never allocates
+ *   inplace_func  inline storage, indirect call, never allocates
+ *
+ * with a SMALL capture (one int: fits every small buffer) and a LARGE one
+ * (64 bytes: too big for std::function's 16-byte buffer in libstdc++).
+ *
+ * Then enum dispatch: switch vs fn::JumpTable vs an array of std::function.
+ *
+ * Build: g++ -std=c++17 -O2 callable_benchmark.cpp -o program
+ */
+
+// ---- every heap allocation in this program goes through the shared hook;
+// profile::allocations() is the running total ----
+COPY_PROFILER_HOOK_NEW
+
+constexpr int kCalls = 20'000'000;
+
+// Inputs come from memory so the template loop cannot fold into a formula
+std::array<int, 1024> g_inputs;
+inline int input(int i) { return g_inputs[i & 1023]; }
+
+// The loops over type-erased callables are noinline: otherwise the compiler
+// sees which lambda is inside and removes the indirection we want to measure.
+template <typename F>
+long loop_template(const F& f) {
+    long sum = 0;
+    for (int i = 0; i < kCalls; i++) sum += f(input(i));
+    return sum;
+}
+
+__attribute__((noinline)) long loop_pointer(int (*f)(void*, int), void* ctx) {
+    long sum = 0;
+    for (int i = 0; i < kCalls; i++) sum += f(ctx, input(i));
+    return sum;
+}
+
+__attribute__((noinline)) long loop_std_function(const std::function<int(int)>& f) {
+    long sum = 0;
+    for (int i = 0; i < kCalls; i++) sum += f(input(i));
+    return sum;
+}
+
+__attribute__((noinline)) long loop_function_ref(fn::function_ref<int(int)> f) {
+    long sum = 0;
+    for (int i = 0; i < kCalls; i++) sum += f(input(i));
+    return sum;
+}
+
+template <std::size_t N>
+__attribute__((noinline)) long loop_inplace(const fn::inplace_function<int(int), N>& f) {
+    long sum = 0;
+    for (int i = 0; i < kCalls; i++) sum += f(input(i));
+    return sum;
+}
+
+// Best of 3 runs, ns per call
+template <typename F>
+double ns_per_call(F&& run, long& result) {
+    double best = 1e18;
+    for (int round = 0; round < 3; round++) {
+        auto start = std::chrono::steady_clock::now();
+        result = run();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / kCalls);
+    }
+    return best;
+}
+
+// Construct + destroy a wrapper 1M times: ns and heap allocations per object
+template <typename Make>
+std::pair<double, double> construction_cost(Make&& make) {
+    const int n = 1'000'000;
+    std::size_t before = profile::allocations();
+    long sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) sink += make(i)(1);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (sink == 42) std::cout << "";
+    return {ns / n, double(profile::allocations() - before) / n};
+}
+
+void print_row(const std::string& name, double call_ns, std::pair<double, double> build, long result,
+               long expected) {
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << call_ns << std::setw(11) << std::setprecision(0) << 1000.0 / call_ns
+              << std::setprecision(1) << std::setw(12) << build.first << std::setw(10) << build.second
+              << (result == expected ? "" : "   WRONG RESULT") << std::defaultfloat << '\n';
+}
+
+void print_header(const std::string& title) {
+    std::cout << "\n=== " << title << " ===\n";
+    std::cout << std::left << std::setw(16) << "wrapper" << std::right << std::setw(10) << "ns/call"
+              << std::setw(11) << "Mcalls/s" << std::setw(12) << "build ns" << std::setw(10) << "allocs"
+              << '\n';
+}
+
+// ---- small capture: one int ----
+struct SmallCtx {
+    int offset;
+};
+int small_callback(void* ctx, int i) { return i + static_cast<SmallCtx*>(ctx)->offset; }
+
+void benchmark_small() {
+    int offset = 3;
+    auto lambda = [offset](int i) { return i + offset; };
+    SmallCtx ctx{offset};
+    long expected = 0, r = 0;
+
+    print_header("SMALL capture (" + std::to_string(sizeof(lambda)) + " bytes)");
+    double t = ns_per_call([&] { return loop_template(lambda); }, expected);
+    print_row("template", t, construction_cost([&](int i) { return [i](int x) { return x + i; }; }), expected,
+              expected);
+
+    t = ns_per_call([&] { return loop_pointer(small_callback, &ctx); }, r);
+    print_row("raw pointer", t, {0, 0}, r, expected);
+
+    std::function<int(int)> sf = lambda;
+    t = ns_per_call([&] { return loop_std_function(sf); }, r);
+    print_row("std::function", t,
+              construction_cost([](int i) { return std::function<int(int)>([i](int x) { return x + i; }); }), r,
+              expected);
+
+    t = ns_per_call([&] { return loop_function_ref(lambda); }, r);
+    print_row("function_ref", t, {0, 0}, r, expected);
+
+    fn::inplace_function<int(int), 16> inf = lambda;
+    t = ns_per_call([&] { return loop_inplace(inf); }, r);
+    print_row("inplace_func<16>", t,
+              construction_cost([](int i) { return fn::inplace_function<int(int), 16>([i](int x) { return x + i; }); }),
+              r, expected);
+}
+
+// ---- large capture: 8 longs (64 bytes) ----
+struct LargeCtx {
+    std::array<long, 8> weights;
+};
+int large_callback(void* ctx, int i) {
+    const auto& w = static_cast<LargeCtx*>(ctx)->weights;
+    return int(i * w[i & 7] + w[(i >> 3) & 7]);
+}
+
+void benchmark_large() {
+    std::array<long, 8> weights{1, 2, 3, 4, 5, 6, 7, 8};
+    auto lambda = [weights](int i) { return int(i * weights[i & 7] + weights[(i >> 3) & 7]); };
+    LargeCtx ctx{weights};
+    long expected = 0, r = 0;
+
+    print_header("LARGE capture (" + std::to_string(sizeof(lambda)) + " bytes)");
+    auto make_lambda = [&](int i) {
+        std::array<long, 8> w = weights;
+        w[0] = i;
+        return [w](int x) { return int(x * w[x & 7]); };
+    };
+    double t = ns_per_call([&] { return loop_template(lambda); }, expected);
+    print_row("template", t, construction_cost(make_lambda), expected, expected);
+
+    t = ns_per_call([&] { return loop_pointer(large_callback, &ctx); }, r);
+    print_row("raw pointer", t, {0, 0}, r, expected);
+
+    std::function<int(int)> sf = lambda;
+    t = ns_per_call([&] { return loop_std_function(sf); }, r);
+    print_row("std::function", t,
+              construction_cost([&](int i) { return std::function<int(int)>(make_lambda(i)); }), r, expected);
+
+    t = ns_per_call([&] { return loop_function_ref(lambda); }, r);
+    print_row("function_ref", t, {0, 0}, r, expected);
+
+    fn::inplace_function<int(int), 64> inf = lambda;
+    t = ns_per_call([&] { return loop_inplace(inf); }, r);
+    print_row("inplace_func<64>", t,
+              construction_cost([&](int i) { return fn::inplace_function<int(int), 64>(make_lambda(i)); }), r,
+              expected);
+    // fn::inplace_function<int(int), 16> too_small = lambda;  // static_assert: closure does not fit
+    std::cout << "(function_ref and raw pointer build nothing: they point at an existing object)\n";
+}
+
+// ---- enum dispatch ----
+enum class Op { Add, Sub, Mul, Max, count };
+
+constexpr int op_add(int a, int b) { return a + b; }
+constexpr int op_sub(int a, int b) { return a - b; }
+constexpr int op_mul(int a, int b) { return a * b; }
+constexpr int op_max(int a, int b) { return a > b ? a : b; }
+
+// Registered in any order; the table is sized by Op::count and sorted by key
+// at compile time (leaving one out is a compile error)
+constexpr auto kOps = fn::make_jump_table<Op, int(int, int)>({
+    {Op::Mul, op_mul},
+    {Op::Add, op_add},
+    {Op::Max, op_max},
+    {Op::Sub, op_sub},
+});
+static_assert(kOps[Op::Sub] == op_sub);
+static_assert(kOps(Op::Mul, 6, 7) == 42);  // a constant key is resolved at compile time
+
+__attribute__((noinline)) long dispatch_switch(const std::vector<Op>& ops) {
+    long acc = 1;
+    for (std::size_t i = 0; i < ops.size(); i++) {
+        int b = int(i & 15);
+        switch (ops[i]) {
+        case Op::Add: acc = op_add(int(acc), b); break;
+        case Op::Sub: acc = op_sub(int(acc), b); break;
+        case Op::Mul: acc = op_mul(int(acc), b); break;
+        case Op::Max: acc = op_max(int(acc), b); break;
+        case Op::count: break;
+        }
+    }
+    return acc;
+}
+
+__attribute__((noinline)) long dispatch_table(const std::vector<Op>& ops) {
+    long acc = 1;
+    for (std::size_t i = 0; i < ops.size(); i++) acc = kOps(ops[i], int(acc), int(i & 15));
+    return acc;
+}
+
+__attribute__((noinline)) long dispatch_std_function(const std::vector<Op>& ops,
+                                                     const std::array<std::function<int(int, int)>, 4>& fns) {
+    long acc = 1;
+    for (std::size_t i = 0; i < ops.size(); i++) acc = fns[std::size_t(ops[i])](int(acc), int(i & 15));
+    return acc;
+}
+
+void benchmark_dispatch() {
+    std::vector<Op> ops(kCalls);
+    std::mt19937 rng(7);
+    for (Op& op : ops) op = Op(rng() % 4);
+    std::array<std::function<int(int, int)>, 4> fns{op_add, op_sub, op_mul, op_max};
+
+    std::cout << "\n=== Enum dispatch: " << kCalls << " random ops ===\n";
+    std::cout << std::left << std::setw(22) << "dispatch" << std::right << std::setw(10) << "ns/op" << '\n';
+    long expected = 0, r = 0;
+    auto row = [&](const std::string& name, double ns) {
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << ns << (r == expected ? "" : "   WRONG RESULT") << std::defaultfloat << '\n';
+    };
+    double t = ns_per_call([&] { return dispatch_switch(ops); }, expected);
+    r = expected;
+    row("switch", t);
+    t = ns_per_call([&] { return dispatch_table(ops); }, r);
+    row("fn::JumpTable", t);
+    t = ns_per_call([&] { return dispatch_std_function(ops, fns); }, r);
+    row("std::function array", t);
+    std::cout << "(random ops defeat the branch predictor in all three. The switch wins because its\n"
+              << " four tiny bodies are inlined; the table pays an indirect call, but it is data:\n"
+              << " registered in any order, checked for gaps and duplicates at compile time)\n";
+}
+
+int main() {
+    for (int i = 0; i < 1024; i++) g_inputs[i] = (i * 37) % 101;
+    std::cout << "sizeof: std::function " << sizeof(std::function<int(int)>) << ", function_ref "
+              << sizeof(fn::function_ref<int(int)>) << ", inplace_function<16> "
+              << sizeof(fn::inplace_function<int(int), 16>) << ", inplace_function<64> "
+              << sizeof(fn::inplace_function<int(int), 64>) << '\n';
+    benchmark_small();
+    benchmark_large();
+    benchmark_dispatch();
+    return 0;
+}
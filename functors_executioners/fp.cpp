@@ -1,4 +1,5 @@
 #include <iostream>
+#include "callable.h"
 using namespace std;
 
 // =============================
@@ -48,6 +49,22 @@ int compute(int a, int b, funPtr fp = add)
     return fp(a, b);
 }
 
+// 4. Jump table: an enum indexes an array of function pointers.
+// fn::make_jump_table sizes the array by Operation::count, fills it at compile
+// time and refuses to compile if an operation is missing or registered twice
+// (see callable.h).
+enum class Operation
+{
+    Add,
+    Subtract,
+    count
+};
+
+constexpr auto operations = fn::make_jump_table<Operation, int(int, int)>({
+    {Operation::Subtract, subtract},
+    {Operation::Add, add},
+});
+
 int main()
 {
 
@@ -84,5 +101,11 @@ int main()
         ops[i]();
     }
 
+    // --- Jump table indexed by enum ---
+    cout << "\nJump table example:\n";
+    cout << "operations(Add, 55, 20) : " << operations(Operation::Add, 55, 20) << endl;
+    cout << "operations(Subtract, 55, 20) : " << operations(Operation::Subtract, 55, 20) << endl;
+    // Cost of each dispatch style vs std::function: callable_benchmark.cpp
+
     return 0;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <vector>
 #include <algorithm>
 #include <functional> // For std::function
+#include <string>
+#include "callable.h"  // fn::function_ref, fn::inplace_function
 
 /*
  * ARCHITECTURAL NOTE: Lambda Closures and Memory
@@ -111,6 +113,23 @@ void lambda_vs_function_pointer() {
     std::cout << "Result from capturing lambda via std::function: " << capturing_lambda(5, 10) << '\n';
 }
 
+// --- Capturing lambdas without std::function ---
+// Not every type-erased callable needs std::function. For a parameter that is
+// only called during the function, fn::function_ref is two pointers and never
+// allocates. To STORE a capturing lambda, fn::inplace_function<Sig, N> keeps
+// it in N bytes inside the object; a bigger closure fails to compile instead
+// of silently going to the heap. (Timings: callable_benchmark.cpp)
+int apply_twice(fn::function_ref<int(int)> f, int x) { return f(f(x)); }
+
+void lambda_without_std_function() {
+    int offset = 100;
+    std::cout << "function_ref: apply_twice(+offset, 1) = "
+              << apply_twice([offset](int v) { return v + offset; }, 1) << '\n';
+
+    std::string prefix = "stored without heap: ";
+    fn::inplace_function<std::string(int), 48> label = [prefix](int v) { return prefix + std::to_string(v); };
+    std::cout << label(42) << " (sizeof closure " << sizeof(prefix) << " <= 48)\n";
+}
 
 int main() {
     std::cout << "--- Lambda Capture Memory Layout ---" << '\n';
@@ -122,5 +141,8 @@ int main() {
     std::cout << "\n--- Lambda vs. Function Pointer Internals ---" << '\n';
     lambda_vs_function_pointer();
 
+    std::cout << "\n--- Capturing Lambdas without std::function ---" << '\n';
+    lambda_without_std_function();
+
     return 0;
 }
\ No newline at end of file
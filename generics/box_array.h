@@ -0,0 +1,208 @@
+#ifndef BOX_ARRAY_H
+#define BOX_ARRAY_H
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <experimental/simd>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+ * BoxArray<T, N>: Box<T> from genrics_basic.cpp, N at a time (C++20)
+ *
+ * Goal: one generic API, three implementations picked at compile time:
+ *   - constant evaluation (constexpr / static_assert): plain scalar loop
+ *   - arithmetic T (int, float, double): std::experimental::simd, several
+ *     lanes per instruction (SSE: 4 floats, AVX2: 8, AVX-512: 16)
+ *   - any other T with * and + (user types): the same scalar loop
+ *
+ * The choice is an OVERLOAD, not an if: SimdArithmetic<T> is defined as
+ * Multipliable<T> && more, so it SUBSUMES Multipliable and the compiler
+ * picks the more constrained overload when both match. With SFINAE
+ * (concepts_vs_sfinae.cpp) both overloads would be ambiguous unless the
+ * generic one excluded arithmetic types by hand.
+ *
+ * Note: a SIMD sum adds in a different order than the scalar loop, so float
+ * results can differ in the last bits.
+ */
+
+namespace boxes
+{
+namespace stdx = std::experimental;
+
+// Anything a Box can hold: area needs *, a total needs +
+template <typename T>
+concept Multipliable = std::copyable<T> && requires(T a, T b) {
+    { a * b } -> std::convertible_to<T>;
+    { a + b } -> std::convertible_to<T>;
+};
+
+// ...and what stdx::simd can hold in vector registers
+template <typename T>
+concept SimdArithmetic = Multipliable<T> && std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+// ---- scalar kernels: user types, and every constexpr evaluation ----
+
+template <Multipliable T>
+constexpr void areas_scalar(std::span<const T> lengths, std::span<T> out)
+{
+    for (std::size_t i = 0; i < lengths.size(); ++i)
+        out[i] = lengths[i] * lengths[i];
+}
+
+template <Multipliable T>
+constexpr T total_area_scalar(std::span<const T> lengths)
+{
+    T sum{};
+    for (const T &len : lengths)
+        sum = sum + len * len;
+    return sum;
+}
+
+template <Multipliable T>
+constexpr void addnum_scalar(std::span<const T> a, std::span<const T> b, std::span<T> out)
+{
+    for (std::size_t i = 0; i < a.size(); ++i)
+        out[i] = a[i] + b[i];
+}
+
+// ---- vector kernels: whole registers, then a scalar tail ----
+
+template <SimdArithmetic T>
+void areas_simd(std::span<const T> lengths, std::span<T> out)
+{
+    using V = stdx::native_simd<T>;
+    std::size_t i = 0;
+    for (; i + V::size() <= lengths.size(); i += V::size())
+    {
+        V len(&lengths[i], stdx::element_aligned);
+        (len * len).copy_to(&out[i], stdx::element_aligned);
+    }
+    areas_scalar(lengths.subspan(i), out.subspan(i));
+}
+
+template <SimdArithmetic T>
+T total_area_simd(std::span<const T> lengths)
+{
+    using V = stdx::native_simd<T>;
+    V acc = 0; // V::size() partial sums, added together once at the end
+    std::size_t i = 0;
+    for (; i + V::size() <= lengths.size(); i += V::size())
+    {
+        V len(&lengths[i], stdx::element_aligned);
+        acc += len * len;
+    }
+    return stdx::reduce(acc) + total_area_scalar(lengths.subspan(i));
+}
+
+template <SimdArithmetic T>
+void addnum_simd(std::span<const T> a, std::span<const T> b, std::span<T> out)
+{
+    using V = stdx::native_simd<T>;
+    std::size_t i = 0;
+    for (; i + V::size() <= a.size(); i += V::size())
+    {
+        V x(&a[i], stdx::element_aligned);
+        V y(&b[i], stdx::element_aligned);
+        (x + y).copy_to(&out[i], stdx::element_aligned);
+    }
+    addnum_scalar(a.subspan(i), b.subspan(i), out.subspan(i));
+}
+
+// ---- public API: overloads selected by concept ----
+
+// The kernels index every span up to the input length, so a short output
+// (or second input) would be read/written out of bounds. Checked once per
+// call; in a constant expression a violation is a compile error.
+constexpr void require_fits(std::size_t needed, std::size_t available, const char *what)
+{
+    if (available < needed)
+        throw std::length_error(what);
+}
+
+template <Multipliable T>
+constexpr void areas(std::span<const T> lengths, std::span<T> out)
+{
+    require_fits(lengths.size(), out.size(), "boxes::areas: out is shorter than lengths");
+    areas_scalar(lengths, out);
+}
+
+template <SimdArithmetic T> // more constrained: wins for int/float/double
+constexpr void areas(std::span<const T> lengths, std::span<T> out)
+{
+    require_fits(lengths.size(), out.size(), "boxes::areas: out is shorter than lengths");
+    if (std::is_constant_evaluated())
+        areas_scalar(lengths, out); // simd is not constexpr
+    else
+        areas_simd(lengths, out);
+}
+
+template <Multipliable T>
+constexpr T total_area(std::span<const T> lengths)
+{
+    return total_area_scalar(lengths);
+}
+
+template <SimdArithmetic T>
+constexpr T total_area(std::span<const T> lengths)
+{
+    if (std::is_constant_evaluated())
+        return total_area_scalar(lengths);
+    return total_area_simd(lengths);
+}
+
+// Element-wise addnum over whole arrays
+template <Multipliable T>
+constexpr void addnum(std::span<const T> a, std::span<const T> b, std::span<T> out)
+{
+    require_fits(a.size(), b.size(), "boxes::addnum: b is shorter than a");
+    require_fits(a.size(), out.size(), "boxes::addnum: out is shorter than a");
+    addnum_scalar(a, b, out);
+}
+
+template <SimdArithmetic T>
+constexpr void addnum(std::span<const T> a, std::span<const T> b, std::span<T> out)
+{
+    require_fits(a.size(), b.size(), "boxes::addnum: b is shorter than a");
+    require_fits(a.size(), out.size(), "boxes::addnum: out is shorter than a");
+    if (std::is_constant_evaluated())
+        addnum_scalar(a, b, out);
+    else
+        addnum_simd(a, b, out);
+}
+
+template <typename T>
+inline constexpr bool uses_simd = SimdArithmetic<T>;
+
+// N boxes stored as one contiguous array of lengths (structure of arrays):
+// exactly the layout simd loads want. Large N belongs on the heap
+// (std::make_unique<BoxArray<float, 1 << 20>>()), not on the stack.
+template <Multipliable T, std::size_t N>
+class BoxArray
+{
+public:
+    constexpr BoxArray() = default;
+    constexpr explicit BoxArray(const std::array<T, N> &lengths) : lengths_(lengths) {}
+
+    constexpr T &operator[](std::size_t i) { return lengths_[i]; }
+    constexpr const T &operator[](std::size_t i) const { return lengths_[i]; }
+    static constexpr std::size_t size() { return N; }
+    constexpr std::span<const T, N> lengths() const { return lengths_; }
+
+    // Box<T>::area for box i
+    constexpr T area(std::size_t i) const { return lengths_[i] * lengths_[i]; }
+
+    // Every area at once; out must hold N values
+    constexpr void areas(std::span<T, N> out) const { boxes::areas<T>(lengths_, out); }
+
+    constexpr T total_area() const { return boxes::total_area<T>(lengths_); }
+
+private:
+    std::array<T, N> lengths_{};
+};
+
+} // namespace boxes
+
+#endif // BOX_ARRAY_H
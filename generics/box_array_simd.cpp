@@ -0,0 +1,131 @@
+/*
+ * ===============================
+ *   BoxArray: Box<T>, vectorized
+ * ===============================
+ *
+ * genrics_basic.cpp computes one Box<T>::area at a time. Real code has a
+ * million boxes. box_array.h stores them as one array of lengths and picks
+ * the implementation by concept:
+ *
+ *   boxes::total_area<int>(...)      -> SimdArithmetic overload (simd lanes)
+ *   boxes::total_area<Length>(...)   -> Multipliable overload (scalar loop)
+ *   constexpr / static_assert        -> scalar loop (simd is not constexpr)
+ *
+ * This file demonstrates:
+ * - compile-time areas (static_assert on a constexpr BoxArray)
+ * - the scalar fallback for a user type
+ * - a benchmark of area / total area / addnum over 1M int, float and double
+ *
+ * Build (C++20): make STD=c++20 FILE=box_array_simd.cpp run
+ * Wider vectors:  g++ -std=c++20 -O2 -march=native box_array_simd.cpp
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "box_array.h"
+
+using namespace std;
+
+// A user type: has * and + (so it is Multipliable), but simd cannot hold it
+struct Length
+{
+    double meters;
+    constexpr Length operator*(Length other) const { return {meters * other.meters}; }
+    constexpr Length operator+(Length other) const { return {meters + other.meters}; }
+};
+
+static_assert(boxes::uses_simd<int> && boxes::uses_simd<float> && boxes::uses_simd<double>);
+static_assert(!boxes::uses_simd<Length>);
+
+// Evaluated entirely by the compiler: nothing of this runs at run time
+constexpr boxes::BoxArray<int, 4> small_boxes({1, 2, 3, 4});
+static_assert(small_boxes.area(2) == 9);
+static_assert(small_boxes.total_area() == 1 + 4 + 9 + 16);
+
+constexpr int sum_of_sums()
+{
+    std::array<int, 3> a{1, 2, 3}, b{10, 20, 30}, out{};
+    boxes::addnum<int>(a, b, out);
+    return out[0] + out[1] + out[2];
+}
+static_assert(sum_of_sums() == 66);
+
+// ---- benchmark ----
+
+constexpr size_t N = 1 << 20;
+
+template <typename F>
+double best_ns_per_element(F &&f)
+{
+    double best = 1e18;
+    for (int round = 0; round < 10; ++round)
+    {
+        auto start = chrono::steady_clock::now();
+        f();
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        best = min(best, ns / N);
+    }
+    return best;
+}
+
+template <typename T>
+void benchmark_type(const string &name)
+{
+    auto lengths = make_unique<boxes::BoxArray<T, N>>();
+    auto other = make_unique<boxes::BoxArray<T, N>>();
+    auto out = make_unique<array<T, N>>();
+    for (size_t i = 0; i < N; ++i)
+    {
+        (*lengths)[i] = T(i % 32 + 1) / T(2); // int: 0..16, float/double: 0.5..16
+        (*other)[i] = T(i % 7);
+    }
+    span<const T> len = lengths->lengths();
+    span<const T> oth = other->lengths();
+    span<T> dst(*out);
+
+    volatile T sink{};
+    T scalar_total{}, simd_total{};
+    double total_scalar = best_ns_per_element([&] { sink = scalar_total = boxes::total_area_scalar(len); });
+    double total_simd = best_ns_per_element([&] { sink = simd_total = lengths->total_area(); });
+    double areas_scalar = best_ns_per_element([&] { boxes::areas_scalar(len, dst); sink = dst[N / 2]; });
+    double areas_simd = best_ns_per_element([&] { lengths->areas(*out); sink = dst[N / 2]; });
+    double add_scalar = best_ns_per_element([&] { boxes::addnum_scalar(len, oth, dst); sink = dst[N / 3]; });
+    double add_simd = best_ns_per_element([&] { boxes::addnum<T>(len, oth, dst); sink = dst[N / 3]; });
+
+    auto row = [&](const string &op, double scalar, double simd) {
+        cout << left << setw(8) << name << setw(14) << op << right << fixed << setprecision(3) << setw(10)
+             << scalar << setw(10) << simd << setw(9) << setprecision(1) << scalar / simd << "x"
+             << defaultfloat << '\n';
+    };
+    row("total_area", total_scalar, total_simd);
+    row("areas", areas_scalar, areas_simd);
+    row("addnum", add_scalar, add_simd);
+    cout << "        (" << boxes::stdx::native_simd<T>::size() << " lanes; total scalar " << setprecision(12)
+         << scalar_total << ", simd " << simd_total << defaultfloat << ")\n";
+}
+
+int main()
+{
+    cout << "=== Compile time ===\n";
+    cout << "small_boxes.total_area() = " << small_boxes.total_area() << " (checked by static_assert)\n";
+
+    cout << "\n=== User type: scalar fallback ===\n";
+    boxes::BoxArray<Length, 3> rooms({Length{2.0}, Length{3.0}, Length{4.5}});
+    cout << "total floor area = " << rooms.total_area().meters << " m^2 (simd path: " << boolalpha
+         << boxes::uses_simd<Length> << ")\n";
+
+    cout << "\n=== Benchmark: " << N << " boxes, ns per element (best of 10) ===\n";
+    cout << left << setw(8) << "type" << setw(14) << "operation" << right << setw(10) << "scalar" << setw(10)
+         << "simd" << setw(10) << "speedup" << '\n';
+    benchmark_type<int>("int");
+    benchmark_type<float>("float");
+    benchmark_type<double>("double");
+    cout << "\nElement-wise loops (areas, addnum) are often auto-vectorized by the compiler anyway;\n"
+         << "float/double SUMS are not (reordering changes rounding), so explicit simd wins there.\n";
+    return 0;
+}
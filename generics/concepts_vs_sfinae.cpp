@@ -3,6 +3,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "iterable_traits.h"
+
 /*
  * Constraints: SFINAE vs Concepts
  *
@@ -14,29 +16,8 @@
 // -------- SFINAE (C++17 style) --------
 // Uses enable_if and void_t to constrain templates
 
-// void_t is available in C++17, but for C++14 compatibility:
-#if __cplusplus < 201703L
-namespace std
-{
-    template <typename...>
-    using void_t = void;
-}
-#endif
-
-template <typename, typename = void>
-struct is_iterable : std::false_type
-{
-};
-
-template <typename T>
-struct is_iterable<T, std::void_t<decltype(std::declval<T>().begin()),
-                                  decltype(std::declval<T>().end()),
-                                  typename T::value_type>> : std::true_type
-{
-};
-
-template <typename T>
-using value_type_t = typename T::value_type;
+// is_iterable<T> and value_type_t<T> live in iterable_traits.h (void_t
+// detection); par_algorithms.h reuses them as C++20 concepts.
 
 template <typename T>
 typename std::enable_if<is_iterable<T>::value && std::is_arithmetic<value_type_t<T>>::value, void>::type
@@ -73,18 +54,7 @@ print_iterable_sfinae(const T &rng)
 
 // -------- Addable example: SFINAE vs concepts --------
 
-template <typename T, typename U>
-using add_result_t = decltype(std::declval<T>() + std::declval<U>());
-
-template <typename, typename, typename = void>
-struct is_addable : std::false_type
-{
-};
-
-template <typename T, typename U>
-struct is_addable<T, U, std::void_t<add_result_t<T, U>>> : std::true_type
-{
-};
+// is_addable<T, U> (iterable_traits.h): true if decltype(a + b) is valid
 
 // enable_if using detection
 template <typename T, typename U,
@@ -0,0 +1,52 @@
+#ifndef ITERABLE_TRAITS_H
+#define ITERABLE_TRAITS_H
+
+#include <type_traits>
+#include <utility>
+
+/*
+ * Detection traits shared by concepts_vs_sfinae.cpp (SFINAE) and
+ * par_algorithms.h (C++20 concepts built on top of them).
+ *
+ *   is_iterable<T>     T has begin(), end() and a value_type
+ *   is_addable<T, U>   a + b compiles for a T and a U
+ */
+
+// void_t is available in C++17, but for C++14 compatibility:
+#if __cplusplus < 201703L
+namespace std
+{
+    template <typename...>
+    using void_t = void;
+}
+#endif
+
+template <typename, typename = void>
+struct is_iterable : std::false_type
+{
+};
+
+template <typename T>
+struct is_iterable<T, std::void_t<decltype(std::declval<T>().begin()),
+                                  decltype(std::declval<T>().end()),
+                                  typename T::value_type>> : std::true_type
+{
+};
+
+template <typename T>
+using value_type_t = typename T::value_type;
+
+template <typename T, typename U>
+using add_result_t = decltype(std::declval<T>() + std::declval<U>());
+
+template <typename, typename, typename = void>
+struct is_addable : std::false_type
+{
+};
+
+template <typename T, typename U>
+struct is_addable<T, U, std::void_t<add_result_t<T, U>>> : std::true_type
+{
+};
+
+#endif // ITERABLE_TRAITS_H
@@ -0,0 +1,362 @@
+#ifndef PAR_ALGORITHMS_H
+#define PAR_ALGORITHMS_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "iterable_traits.h"
+
+/*
+ * par_algorithms.h - par_reduce, par_transform, par_sort, par_scan (C++20)
+ *
+ * Goal: the is_iterable / is_addable traits of concepts_vs_sfinae.cpp, turned
+ * into concepts that pick an implementation at COMPILE TIME:
+ *
+ *   Iterable<R>              begin/end/value_type  -> sequential std:: algorithm
+ *   RandomAccessIterable<R>  ...and O(1) it + n    -> split into chunks, run the
+ *                                                     chunks on par::Pool
+ *
+ * RandomAccessIterable subsumes Iterable, so for a vector both overloads
+ * match and the more constrained (parallel) one is chosen; a std::list only
+ * matches the sequential one. No runtime check, no virtual call.
+ *
+ * Fork-join: chunks are CLAIMED from an atomic counter by the caller and by
+ * pool helpers alike, so a pool of P threads gives P + 1 workers. The caller
+ * keeps claiming until none are left and then only waits for chunks already
+ * running: it never waits on a chunk that is still queued. That makes par_*
+ * safe to call from a pool thread, from another executor's task, or from a
+ * par_* callback (the caller just does more of the work itself). Ranges
+ * below min_parallel elements stay sequential (a pool round trip costs
+ * microseconds).
+ *
+ *   par::par_reduce(v, 0L)                       // sum
+ *   par::par_reduce(v, 1.0, std::multiplies<>{})
+ *   par::par_transform(in, out, [](int x) { return x * x; })
+ *   par::par_sort(v)                             // std::less
+ *   par::par_scan(in, out, 0L)                   // inclusive prefix sums
+ */
+
+namespace par
+{
+
+template <typename R>
+concept Iterable = is_iterable<std::remove_cvref_t<R>>::value;
+
+template <typename R>
+concept RandomAccessIterable =
+    Iterable<R> && std::random_access_iterator<decltype(std::begin(std::declval<R &>()))>;
+
+template <typename T, typename U = T>
+concept Addable = is_addable<T, U>::value;
+
+template <typename R>
+inline constexpr bool uses_pool = RandomAccessIterable<R>;
+
+inline constexpr std::size_t min_parallel = 1 << 14;
+
+// Fixed-size FIFO thread pool, one per process (shared()). Jobs must not
+// throw; fork_join captures exceptions itself.
+class Pool
+{
+public:
+    explicit Pool(unsigned threads = 0)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; ++i)
+            workers_.emplace_back([this]
+                                  { run(); });
+    }
+
+    Pool(const Pool &) = delete;
+    Pool &operator=(const Pool &) = delete;
+
+    ~Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread &t : workers_)
+            t.join();
+    }
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+    unsigned size() const { return unsigned(workers_.size()); }
+
+    static Pool &shared()
+    {
+        static Pool pool;
+        return pool;
+    }
+
+private:
+    void run()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                cv_.wait(lock, [this]
+                         { return stop_ || !jobs_.empty(); });
+                if (jobs_.empty())
+                    return; // stop_ and drained
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+};
+
+namespace detail
+{
+
+// Number of chunks for n elements: one per worker (pool threads + caller),
+// none smaller than min_parallel / 2
+inline std::size_t chunk_count(std::size_t n)
+{
+    std::size_t workers = Pool::shared().size() + 1;
+    return std::max<std::size_t>(1, std::min(workers, n / (min_parallel / 2)));
+}
+
+// [begin, end) of chunk c out of `chunks` over n elements
+inline std::pair<std::size_t, std::size_t> chunk_bounds(std::size_t n, std::size_t chunks, std::size_t c)
+{
+    return {n * c / chunks, n * (c + 1) / chunks};
+}
+
+// Runs body(0) .. body(chunks - 1) on the caller and up to chunks - 1 pool
+// helpers, each claiming the next unstarted chunk. Returns when all are
+// done; rethrows the first exception.
+//
+// The counters live in a shared_ptr: a helper may be dequeued after the
+// caller has returned, finds nothing left to claim, and must not touch the
+// caller's frame. body is only called for a claimed chunk, i.e. while the
+// caller is still waiting.
+template <typename Body>
+void fork_join(std::size_t chunks, Body &&body)
+{
+    if (chunks <= 1)
+    {
+        body(std::size_t(0));
+        return;
+    }
+    struct State
+    {
+        std::atomic<std::size_t> next{0};
+        std::mutex m;
+        std::condition_variable done;
+        std::size_t finished = 0;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+
+    // Claims and runs chunks until none are left
+    const auto drain = [chunks](State &st, auto &fn)
+    {
+        for (std::size_t c; (c = st.next.fetch_add(1, std::memory_order_relaxed)) < chunks;)
+        {
+            std::exception_ptr e;
+            try { fn(c); } catch (...) { e = std::current_exception(); }
+            std::lock_guard<std::mutex> lock(st.m);
+            if (e && !st.error)
+                st.error = e;
+            if (++st.finished == chunks)
+                st.done.notify_one();
+        }
+    };
+
+    for (std::size_t h = 1; h < chunks; ++h)
+        Pool::shared().submit([state, &body, drain]
+                              { drain(*state, body); });
+    drain(*state, body);
+
+    std::unique_lock<std::mutex> lock(state->m);
+    state->done.wait(lock, [&]
+                     { return state->finished == chunks; });
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
+} // namespace detail
+
+// ---------------- par_reduce ----------------
+
+template <Iterable R, typename T, typename Op = std::plus<>>
+    requires Addable<T, value_type_t<std::remove_cvref_t<R>>>
+T par_reduce(const R &range, T init, Op op = {})
+{
+    return std::accumulate(std::begin(range), std::end(range), std::move(init), op);
+}
+
+// op must be associative: chunks are combined in order, but grouped differently
+template <RandomAccessIterable R, typename T, typename Op = std::plus<>>
+    requires Addable<T, value_type_t<std::remove_cvref_t<R>>>
+T par_reduce(const R &range, T init, Op op = {})
+{
+    auto first = std::begin(range);
+    std::size_t n = std::size(range);
+    std::size_t chunks = detail::chunk_count(n);
+    if (chunks == 1)
+        return std::accumulate(first, std::end(range), std::move(init), op);
+
+    std::vector<T> partial(chunks, T{}); // chunks are never empty (chunk_count)
+    detail::fork_join(chunks, [&](std::size_t c)
+                      {
+        auto [b, e] = detail::chunk_bounds(n, chunks, c);
+        T acc = first[b];
+        for (std::size_t i = b + 1; i < e; ++i)
+            acc = op(std::move(acc), first[i]);
+        partial[c] = std::move(acc); });
+    for (std::size_t c = 0; c < chunks; ++c)
+        init = op(std::move(init), std::move(partial[c]));
+    return init;
+}
+
+// ---------------- par_transform ----------------
+// out[i] = f(in[i]); out must already hold at least size(in) elements
+
+template <Iterable In, Iterable Out, typename F>
+void par_transform(const In &in, Out &out, F f)
+{
+    std::transform(std::begin(in), std::end(in), std::begin(out), f);
+}
+
+template <RandomAccessIterable In, RandomAccessIterable Out, typename F>
+void par_transform(const In &in, Out &out, F f)
+{
+    auto src = std::begin(in);
+    auto dst = std::begin(out);
+    std::size_t n = std::size(in);
+    std::size_t chunks = detail::chunk_count(n);
+    detail::fork_join(chunks, [&](std::size_t c)
+                      {
+        auto [b, e] = detail::chunk_bounds(n, chunks, c);
+        std::transform(src + b, src + e, dst + b, f); });
+}
+
+// ---------------- par_sort ----------------
+
+template <Iterable R, typename Comp = std::less<>>
+void par_sort(R &range, Comp comp = {})
+{
+    if constexpr (requires { range.sort(comp); })
+        range.sort(comp); // std::list / std::forward_list: relink nodes, no copies
+    else
+    {
+        std::vector<value_type_t<R>> tmp(std::make_move_iterator(std::begin(range)),
+                                         std::make_move_iterator(std::end(range)));
+        std::sort(tmp.begin(), tmp.end(), comp);
+        std::move(tmp.begin(), tmp.end(), std::begin(range));
+    }
+}
+
+// Sort each chunk in parallel, then merge neighbours pairwise: log2(chunks)
+// rounds of std::inplace_merge, each round in parallel
+template <RandomAccessIterable R, typename Comp = std::less<>>
+void par_sort(R &range, Comp comp = {})
+{
+    auto first = std::begin(range);
+    std::size_t n = std::size(range);
+    std::size_t chunks = detail::chunk_count(n);
+    detail::fork_join(chunks, [&](std::size_t c)
+                      {
+        auto [b, e] = detail::chunk_bounds(n, chunks, c);
+        std::sort(first + b, first + e, comp); });
+
+    for (std::size_t width = 1; width < chunks; width *= 2)
+    {
+        std::size_t merges = (chunks + 2 * width - 1) / (2 * width);
+        detail::fork_join(merges, [&](std::size_t m)
+                          {
+            std::size_t left = m * 2 * width;
+            std::size_t mid = std::min(left + width, chunks);
+            std::size_t right = std::min(left + 2 * width, chunks);
+            if (mid == right)
+                return; // odd one out: already sorted
+            std::inplace_merge(first + detail::chunk_bounds(n, chunks, left).first,
+                               first + detail::chunk_bounds(n, chunks, mid).first,
+                               first + detail::chunk_bounds(n, chunks, right - 1).second, comp); });
+    }
+}
+
+// ---------------- par_scan ----------------
+// Inclusive scan: out[i] = init op in[0] op ... op in[i]
+
+template <Iterable In, Iterable Out, typename T, typename Op = std::plus<>>
+    requires Addable<T, value_type_t<std::remove_cvref_t<In>>>
+void par_scan(const In &in, Out &out, T init, Op op = {})
+{
+    std::inclusive_scan(std::begin(in), std::end(in), std::begin(out), op, std::move(init));
+}
+
+// Three phases: reduce each chunk (parallel), scan the chunk totals
+// (sequential, `chunks` values), scan each chunk from its offset (parallel).
+// Reads the input twice - the price of not knowing the offsets up front.
+template <RandomAccessIterable In, RandomAccessIterable Out, typename T, typename Op = std::plus<>>
+    requires Addable<T, value_type_t<std::remove_cvref_t<In>>>
+void par_scan(const In &in, Out &out, T init, Op op = {})
+{
+    auto src = std::begin(in);
+    auto dst = std::begin(out);
+    std::size_t n = std::size(in);
+    std::size_t chunks = detail::chunk_count(n);
+    if (chunks == 1)
+    {
+        std::inclusive_scan(src, std::end(in), dst, op, std::move(init));
+        return;
+    }
+
+    std::vector<T> offset(chunks, T{});
+    detail::fork_join(chunks - 1, [&](std::size_t c) // the last chunk's total is never needed
+                      {
+        auto [b, e] = detail::chunk_bounds(n, chunks, c);
+        T acc = src[b];
+        for (std::size_t i = b + 1; i < e; ++i)
+            acc = op(std::move(acc), src[i]);
+        offset[c] = std::move(acc); });
+    T running = std::move(init);
+    for (std::size_t c = 0; c < chunks; ++c)
+    {
+        T total = std::move(offset[c]);
+        offset[c] = running;
+        if (c + 1 < chunks)
+            running = op(std::move(running), std::move(total));
+    }
+    detail::fork_join(chunks, [&](std::size_t c)
+                      {
+        auto [b, e] = detail::chunk_bounds(n, chunks, c);
+        std::inclusive_scan(src + b, src + e, dst + b, op, offset[c]); });
+}
+
+} // namespace par
+
+#endif // PAR_ALGORITHMS_H
@@ -0,0 +1,421 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+/*
+ * PART 11: WHAT DOES A VIRTUAL CALL COST?
+ * ========================================
+ * vptr_vtable_visual.cpp shows the mechanism: load vptr, load vtable slot,
+ * indirect call. This file measures it on 10M shapes and compares five ways
+ * to compute "sum of areas" over mixed Circle/Rectangle/Triangle/Square:
+ *
+ * 1. virtual              vector<unique_ptr<Shape>>, s->area()
+ * 2. virtual, type-sorted same pointers, sorted by type first: the indirect
+ *                         branch now goes to the same target for long runs
+ * 3. final + kind switch  switch on a kind tag, then static_cast to the
+ *                         `final` class: the compiler calls (and inlines)
+ *                         Circle::area directly - no vtable load
+ * 4. std::variant + visit objects stored by value, contiguously; visit is a
+ *                         jump on the index, no pointers to chase
+ * 5. CRTP batches         one vector per type; Shape<D>::area() is resolved
+ *                         at compile time and the loop can be vectorized
+ *
+ * ...for type mixes of different ENTROPY (how unpredictable the next type is):
+ * 0 bits = all circles, 2 bits = 4 types uniformly at random.
+ *
+ * Branch and cache misses per call come from perf_event_open (Linux, if the
+ * kernel/VM exposes hardware counters; otherwise "n/a").
+ *
+ * Build: g++ -std=c++17 -O2 11_devirtualization_benchmark.cpp -o program
+ * Run:   ./program [shapes]      (default 10000000)
+ *
+ * INTERVIEW QUESTION: Are virtual functions slow?
+ * ANSWER: The call itself is a couple of loads and an indirect jump - about
+ * as fast as a direct call when the branch predictor guesses the target.
+ * What costs is (a) mispredicted targets when types are mixed at random,
+ * (b) no inlining, so no vectorization, and (c) objects behind pointers
+ * scattered over the heap. `final` only removes the vtable load - a switch on
+ * a random type mispredicts just the same. Sorting pointers by type fixes (a)
+ * but makes (c) worse; only storing each type contiguously (CRTP batches)
+ * fixes all three.
+ */
+
+enum class Kind : unsigned char { Circle, Rectangle, Triangle, Square };
+constexpr int kKinds = 4;
+constexpr double kPi = 3.14159265358979323846;
+
+// ============================================================================
+// STRATEGIES 1-3: classic hierarchy (final leaves, plus a kind tag)
+// ============================================================================
+
+namespace virt {
+
+class Shape {
+public:
+    explicit Shape(Kind k) : kind(k) { }
+    virtual ~Shape() = default;
+    virtual double area() const = 0;
+    const Kind kind;  // lets strategy 3 switch without dynamic_cast
+};
+
+class Circle final : public Shape {
+    double r;
+public:
+    explicit Circle(double r) : Shape(Kind::Circle), r(r) { }
+    double area() const override { return kPi * r * r; }
+};
+
+class Rectangle final : public Shape {
+    double w, h;
+public:
+    Rectangle(double w, double h) : Shape(Kind::Rectangle), w(w), h(h) { }
+    double area() const override { return w * h; }
+};
+
+class Triangle final : public Shape {
+    double b, h;
+public:
+    Triangle(double b, double h) : Shape(Kind::Triangle), b(b), h(h) { }
+    double area() const override { return 0.5 * b * h; }
+};
+
+class Square final : public Shape {
+    double s;
+public:
+    explicit Square(double s) : Shape(Kind::Square), s(s) { }
+    double area() const override { return s * s; }
+};
+
+}  // namespace virt
+
+// ============================================================================
+// STRATEGY 4: variant of plain value types
+// ============================================================================
+
+namespace val {
+
+struct Circle { double r; double area() const { return kPi * r * r; } };
+struct Rectangle { double w, h; double area() const { return w * h; } };
+struct Triangle { double b, h; double area() const { return 0.5 * b * h; } };
+struct Square { double s; double area() const { return s * s; } };
+
+using Shape = variant<Circle, Rectangle, Triangle, Square>;
+
+}  // namespace val
+
+// ============================================================================
+// STRATEGY 5: CRTP - static polymorphism
+// ============================================================================
+
+namespace crtp {
+
+template <typename Derived>
+struct Shape {
+    double area() const { return static_cast<const Derived&>(*this).area_impl(); }
+};
+
+struct Circle : Shape<Circle> { double r; double area_impl() const { return kPi * r * r; } };
+struct Rectangle : Shape<Rectangle> { double w, h; double area_impl() const { return w * h; } };
+struct Triangle : Shape<Triangle> { double b, h; double area_impl() const { return 0.5 * b * h; } };
+struct Square : Shape<Square> { double s; double area_impl() const { return s * s; } };
+
+// Works for any Shape<D>: one instantiation (and one tight loop) per type
+template <typename D>
+double total_area(const vector<D>& shapes) {
+    double sum = 0;
+    for (const Shape<D>& s : shapes) sum += s.area();
+    return sum;
+}
+
+using Batches = tuple<vector<Circle>, vector<Rectangle>, vector<Triangle>, vector<Square>>;
+
+}  // namespace crtp
+
+// ============================================================================
+// Workload: kinds drawn from a distribution, with random dimensions
+// ============================================================================
+
+struct Item {
+    Kind kind;
+    double a, b;  // radius / side / width+height / base+height
+};
+
+vector<Item> make_items(size_t n, const double (&mix)[kKinds], uint32_t seed) {
+    mt19937 rng(seed);
+    discrete_distribution<int> pick(begin(mix), end(mix));
+    uniform_real_distribution<double> dim(0.5, 2.0);
+    vector<Item> items(n);
+    for (Item& it : items) it = {Kind(pick(rng)), dim(rng), dim(rng)};
+    return items;
+}
+
+double entropy_bits(const double (&mix)[kKinds]) {
+    double total = 0, h = 0;
+    for (double p : mix) total += p;
+    for (double p : mix) {
+        if (p > 0) h -= (p / total) * log2(p / total);
+    }
+    return h;
+}
+
+// ============================================================================
+// perf_event_open: hardware counters for the current thread
+// ============================================================================
+
+class PerfCounter {
+public:
+#if defined(__linux__)
+    explicit PerfCounter(uint64_t config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0) reason = strerror(errno);
+    }
+    ~PerfCounter() {
+        if (fd >= 0) close(fd);
+    }
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    long long stop() {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long value = -1;
+        if (read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+        return value;
+    }
+#else
+    explicit PerfCounter(uint64_t) { reason = "not Linux"; }
+    void start() { }
+    long long stop() { return -1; }
+#endif
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    bool available() const { return fd >= 0; }
+    string reason;
+
+private:
+    int fd = -1;
+};
+
+#if defined(__linux__)
+constexpr uint64_t kCacheMisses = PERF_COUNT_HW_CACHE_MISSES;
+constexpr uint64_t kBranchMisses = PERF_COUNT_HW_BRANCH_MISSES;
+#else
+constexpr uint64_t kCacheMisses = 0, kBranchMisses = 0;
+#endif
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+struct Result {
+    double ns_per_call = 1e18;
+    double cache_misses = -1;   // per call, -1 = unavailable
+    double branch_misses = -1;
+    double sum = 0;
+};
+
+// Best of 3 for time; counters from the best run
+template <typename F>
+Result measure(size_t n, F&& body) {
+    Result best;
+    PerfCounter cache(kCacheMisses), branch(kBranchMisses);
+    for (int round = 0; round < 3; round++) {
+        cache.start();
+        branch.start();
+        auto start = chrono::steady_clock::now();
+        double sum = body();
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / n;
+        long long cm = cache.stop(), bm = branch.stop();
+        if (ns < best.ns_per_call) {
+            best.ns_per_call = ns;
+            best.cache_misses = cm < 0 ? -1 : double(cm) / n;
+            best.branch_misses = bm < 0 ? -1 : double(bm) / n;
+            best.sum = sum;
+        }
+    }
+    return best;
+}
+
+void print_row(const string& name, const Result& r, double reference, bool keeps_order) {
+    auto counter = [](double v) {
+        if (v < 0) return string("n/a");
+        ostringstream out;
+        out << fixed << setprecision(3) << v;
+        return out.str();
+    };
+    bool same = fabs(r.sum - reference) <= 1e-9 * fabs(reference);
+    cout << "  " << left << setw(26) << name << right << fixed << setprecision(2) << setw(9) << r.ns_per_call
+         << setw(10) << setprecision(0) << 1000.0 / r.ns_per_call << setw(12) << counter(r.cache_misses)
+         << setw(13) << counter(r.branch_misses) << setw(8) << (keeps_order ? "yes" : "no")
+         << (same ? "" : "  SUM MISMATCH") << defaultfloat << endl;
+}
+
+void run_mix(const string& name, const double (&mix)[kKinds], size_t n) {
+    vector<Item> items = make_items(n, mix, 2024);
+    cout << "\n=== " << name << ": entropy " << fixed << setprecision(2) << entropy_bits(mix) << " bits/shape"
+         << defaultfloat << " ===" << endl;
+    cout << "  " << left << setw(26) << "strategy" << right << setw(9) << "ns/call" << setw(10) << "Mcalls/s"
+         << setw(12) << "cache-miss" << setw(13) << "branch-miss" << setw(8) << "order" << endl;
+
+    double reference = 0;
+    {
+        // 1-3: heap objects behind base-class pointers
+        vector<unique_ptr<virt::Shape>> shapes;
+        shapes.reserve(n);
+        for (const Item& it : items) {
+            switch (it.kind) {
+            case Kind::Circle: shapes.push_back(make_unique<virt::Circle>(it.a)); break;
+            case Kind::Rectangle: shapes.push_back(make_unique<virt::Rectangle>(it.a, it.b)); break;
+            case Kind::Triangle: shapes.push_back(make_unique<virt::Triangle>(it.a, it.b)); break;
+            case Kind::Square: shapes.push_back(make_unique<virt::Square>(it.a)); break;
+            }
+        }
+
+        Result r = measure(n, [&] {
+            double sum = 0;
+            for (const auto& s : shapes) sum += s->area();  // vptr -> vtable -> indirect call
+            return sum;
+        });
+        reference = r.sum;
+        print_row("virtual", r, reference, true);
+
+        r = measure(n, [&] {
+            double sum = 0;
+            for (const auto& s : shapes) {
+                switch (s->kind) {  // static type is a final class: direct, inlined call
+                case Kind::Circle: sum += static_cast<const virt::Circle&>(*s).area(); break;
+                case Kind::Rectangle: sum += static_cast<const virt::Rectangle&>(*s).area(); break;
+                case Kind::Triangle: sum += static_cast<const virt::Triangle&>(*s).area(); break;
+                case Kind::Square: sum += static_cast<const virt::Square&>(*s).area(); break;
+                }
+            }
+            return sum;
+        });
+        print_row("final + kind switch", r, reference, true);
+
+        // Sorting is paid once (not timed); only pays off if the loop runs often
+        stable_sort(shapes.begin(), shapes.end(), [](const auto& x, const auto& y) { return x->kind < y->kind; });
+        r = measure(n, [&] {
+            double sum = 0;
+            for (const auto& s : shapes) sum += s->area();
+            return sum;
+        });
+        print_row("virtual, type-sorted", r, reference, false);
+    }
+    {
+        vector<val::Shape> shapes;
+        shapes.reserve(n);
+        for (const Item& it : items) {
+            switch (it.kind) {
+            case Kind::Circle: shapes.emplace_back(val::Circle{it.a}); break;
+            case Kind::Rectangle: shapes.emplace_back(val::Rectangle{it.a, it.b}); break;
+            case Kind::Triangle: shapes.emplace_back(val::Triangle{it.a, it.b}); break;
+            case Kind::Square: shapes.emplace_back(val::Square{it.a}); break;
+            }
+        }
+        Result r = measure(n, [&] {
+            double sum = 0;
+            for (const auto& s : shapes) sum += visit([](const auto& shape) { return shape.area(); }, s);
+            return sum;
+        });
+        print_row("std::variant + visit", r, reference, true);
+    }
+    {
+        crtp::Batches batches;
+        for (const Item& it : items) {
+            switch (it.kind) {
+            case Kind::Circle: get<0>(batches).push_back({{}, it.a}); break;
+            case Kind::Rectangle: get<1>(batches).push_back({{}, it.a, it.b}); break;
+            case Kind::Triangle: get<2>(batches).push_back({{}, it.a, it.b}); break;
+            case Kind::Square: get<3>(batches).push_back({{}, it.a}); break;
+            }
+        }
+        Result r = measure(n, [&] {
+            return apply([](const auto&... batch) { return (crtp::total_area(batch) + ...); }, batches);
+        });
+        print_row("CRTP batches", r, reference, false);
+    }
+}
+
+// Whole argument as a number in [lo, hi]; false if it is not one
+bool parse_number(const string& text, size_t lo, size_t hi, size_t& value) {
+    try {
+        size_t used = 0;
+        unsigned long long v = stoull(text, &used);
+        if (used != text.size() || text[0] == '-' || v < lo || v > hi) return false;
+        value = size_t(v);
+        return true;
+    } catch (const exception&) {
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = 10'000'000;
+    if (argc > 2 || (argc == 2 && !parse_number(argv[1], 1, 200'000'000, n))) {
+        cerr << "usage: " << argv[0] << " [shapes 1..200000000]" << endl;
+        return 2;
+    }
+
+    cout << "=== DEVIRTUALIZATION: " << n << " shapes, sum of area() ===" << endl;
+    cout << "sizeof: virtual Circle " << sizeof(virt::Circle) << " (+ heap header), variant "
+         << sizeof(val::Shape) << ", CRTP Circle " << sizeof(crtp::Circle) << endl;
+    PerfCounter probe(kCacheMisses);
+    if (!probe.available()) {
+        cout << "hardware counters unavailable (" << probe.reason << "): miss columns show n/a" << endl;
+    }
+
+    const double one_type[kKinds] = {1, 0, 0, 0};
+    const double skewed[kKinds] = {97, 1, 1, 1};
+    const double mostly[kKinds] = {70, 10, 10, 10};
+    const double uniform[kKinds] = {1, 1, 1, 1};
+    run_mix("all circles", one_type, n);
+    run_mix("97/1/1/1", skewed, n);
+    run_mix("70/10/10/10", mostly, n);
+    run_mix("uniform", uniform, n);
+
+    cout << "\nReading the table:" << endl;
+    cout << "- At 0 bits every branch is predicted; the gap is pointer chasing and lost inlining." << endl;
+    cout << "- As entropy grows, 'virtual' mispredicts its indirect call more often. 'final + kind" << endl;
+    cout << "  switch' mispredicts the switch instead: final removes the vtable load, not the guess." << endl;
+    cout << "- Sorting the POINTERS by type restores prediction, but the objects still sit in" << endl;
+    cout << "  allocation order, so the loop now hops around the heap (cache misses)." << endl;
+    cout << "- variant keeps order with no pointers; CRTP batches make no per-shape decision at" << endl;
+    cout << "  all and stay flat at every entropy." << endl;
+    cout << "- 'order: no' strategies regroup the shapes - fine for a sum, not for draw order." << endl;
+    return 0;
+}
@@ -31,6 +31,11 @@ Solution approach
 #include<iostream>
 #include<vector>
 #include<string>
+#include<chrono>
+#include<iomanip>
+#include<random>
+#include<thread>
+#include "hms_registry.h"
 using namespace std;
 
 // COMPOSITION: Address is owned by Person - dies with Person
@@ -194,8 +199,206 @@ ASSOCIATION (Temporary Relationship):
     Doctor ---- Patient (via examine() and addPatient())
 */
 
-int main()
+/*
+REGISTRY: the same relationships at hospital scale (hms_registry.h)
+
+Doctor::showPatients and Department::showInfo walk their pointer vectors,
+and "every patient with X" means visiting every Patient object. The
+registry keeps ids instead of pointers and an index per question, so a
+query costs what its answer costs.
+*/
+void registry_demo()
+{
+    hms::Registry reg;
+    hms::DepartmentId ortho = reg.add_department("Orthopedics Department");
+    hms::DoctorId kamal = reg.add_doctor("kamal", "Orthopedics", ortho);
+    hms::DoctorId ravi = reg.add_doctor("ravi", "Orthopedics", ortho);
+
+    hms::PatientId madhu = reg.admit("madhu", 21, "fracture", kamal);
+    reg.admit("sita", 34, "fracture", ravi);
+    reg.admit("arjun", 67, "arthritis", kamal);
+
+    cout << "Orthopedics doctors : " << reg.doctors_by_specialization("Orthopedics").size() << endl;
+    cout << "fracture patients   : " << reg.count_by_diagnosis("fracture") << endl;
+    cout << "aged 20-40          : " << reg.count_by_age(20, 40) << endl;
+    cout << "kamal's patients    :";
+    reg.for_each_patient_of(kamal, [](hms::PatientId, const hms::PatientRecord& p) { cout << " " << p.name; });
+    cout << endl;
+
+    if (auto p = reg.patient(madhu)) {
+        cout << p->name << " (" << p->age << ") " << p->diagnosis << ", doctor " << reg.doctor_name(p->doctor) << endl;
+    }
+    reg.discharge(madhu);
+    cout << "after discharge     : census " << reg.department_census(ortho)
+         << ", madhu found " << boolalpha << reg.patient(madhu).has_value()
+         << ", second discharge " << reg.discharge(madhu) << noboolalpha << endl;
+}
+
+// Runs f until ~`seconds` have passed; returns calls per second
+template <typename F>
+double per_second(F&& f, double seconds = 0.5)
 {
+    auto start = chrono::steady_clock::now();
+    size_t calls = 0;
+    double elapsed = 0;
+    do {
+        for (int i = 0; i < 16; i++) f();
+        calls += 16;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    return calls / elapsed;
+}
+
+void print_rate(const string& name, double rate, const string& note = "")
+{
+    cout << left << setw(34) << name << right << fixed << setprecision(0) << setw(14) << rate
+         << "  " << note << defaultfloat << endl;
+}
+
+void registry_benchmark(size_t patients, unsigned threads)
+{
+    const int departments = 20, specializations = 50, doctors = 2000, diagnoses = 500;
+    hms::Registry reg;
+    vector<hms::DepartmentId> depts;
+    vector<hms::DoctorId> docs;
+    vector<string> diag_names, spec_names;
+    for (int i = 0; i < diagnoses; i++) diag_names.push_back("diag-" + to_string(i));
+    for (int i = 0; i < specializations; i++) spec_names.push_back("spec-" + to_string(i));
+    for (int i = 0; i < departments; i++) depts.push_back(reg.add_department("dept-" + to_string(i)));
+    for (int i = 0; i < doctors; i++) {
+        docs.push_back(reg.add_doctor("doc-" + to_string(i), spec_names[i % specializations], depts[i % departments]));
+    }
+
+    cout << "=== Registry benchmark: " << patients << " patients, " << doctors << " doctors, "
+         << diagnoses << " diagnoses, " << threads << " thread(s) for the mixed run, "
+         << thread::hardware_concurrency() << " CPU(s) ===\n";
+
+    // ---- load ----
+    mt19937 rng(42);
+    vector<hms::PatientId> ids(patients);
+    reg.reserve(patients);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < patients; i++) {
+        ids[i] = reg.admit("P" + to_string(i), int(rng() % 101), diag_names[rng() % diagnoses], docs[rng() % doctors]);
+    }
+    double load_s = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    print_rate("admit (1 thread, loading)", patients / load_s, "admits/s");
+
+    // ---- indexed queries ----
+    cout << left << setw(34) << "query" << right << setw(14) << "queries/s" << endl;
+    size_t sink = 0;
+    print_rate("count_by_diagnosis", per_second([&] { sink += reg.count_by_diagnosis(diag_names[rng() % diagnoses]); }),
+               "O(shards)");
+    print_rate("for_each_by_diagnosis (sum ages)", per_second([&] {
+                   reg.for_each_by_diagnosis(diag_names[rng() % diagnoses],
+                                             [&](hms::PatientId, const hms::PatientRecord& p) { sink += p.age; });
+               }),
+               "~" + to_string(patients / diagnoses) + " patients each");
+    print_rate("count_by_age (10-year range)", per_second([&] {
+                   int lo = int(rng() % 90);
+                   sink += reg.count_by_age(lo, lo + 9);
+               }),
+               "O(shards x years)");
+    print_rate("doctors_by_specialization", per_second([&] {
+                   sink += reg.doctors_by_specialization(spec_names[rng() % specializations]).size();
+               }));
+    print_rate("for_each_patient_of (doctor)", per_second([&] {
+                   reg.for_each_patient_of(docs[rng() % doctors],
+                                           [&](hms::PatientId, const hms::PatientRecord& p) { sink += p.age; });
+               }),
+               "~" + to_string(patients / doctors) + " patients each");
+    print_rate("department_census", per_second([&] { sink += reg.department_census(depts[rng() % departments]); }));
+    print_rate("patient(id)", per_second([&] { sink += reg.patient(ids[rng() % patients])->age; }));
+
+    // ---- the pointer-vector way: scan everyone ----
+    print_rate("full scan: count by diagnosis", per_second([&] {
+                   // a small run may never have admitted this diagnosis: no code, nothing to count
+                   if (auto code = reg.diagnosis_code(diag_names[rng() % diagnoses]))
+                       reg.for_each_patient([&](hms::PatientId, const hms::PatientRecord& p) { sink += p.diagnosis == *code; });
+               }, 1.0),
+               "baseline: what vector<Patient*> does");
+
+    // ---- concurrent: writers churn (discharge + readmit), readers query ----
+    // at most one writer per patient, so no writer's slice of ids is empty
+    unsigned writers = unsigned(min<size_t>(max(1u, threads / 2), patients));
+    unsigned readers = max(1u, threads - writers);
+    atomic<bool> stop{false};
+    atomic<size_t> updates{0}, queries{0}, checksum{0};
+    vector<thread> pool;
+    auto mixed_start = chrono::steady_clock::now();
+    for (unsigned w = 0; w < writers; w++) {
+        pool.emplace_back([&, w] {
+            mt19937 local(100 + w);
+            size_t begin = patients * w / writers, end = patients * (w + 1) / writers;  // own slice of ids
+            size_t done = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                size_t i = begin + local() % (end - begin);
+                reg.discharge(ids[i]);
+                ids[i] = reg.admit("R" + to_string(i), int(local() % 101), diag_names[local() % diagnoses],
+                                   docs[local() % doctors]);
+                done += 2;
+            }
+            updates += done;
+        });
+    }
+    for (unsigned r = 0; r < readers; r++) {
+        pool.emplace_back([&, r] {
+            mt19937 local(200 + r);
+            size_t done = 0, local_sink = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                local_sink += reg.count_by_diagnosis(diag_names[local() % diagnoses]);
+                int lo = int(local() % 90);
+                local_sink += reg.count_by_age(lo, lo + 9);
+                reg.for_each_patient_of(docs[local() % doctors],
+                                        [&](hms::PatientId, const hms::PatientRecord& p) { local_sink += p.age; });
+                done += 3;
+            }
+            queries += done;
+            checksum += local_sink;
+        });
+    }
+    this_thread::sleep_for(chrono::seconds(1));
+    stop = true;
+    for (thread& t : pool) t.join();
+    // every counted operation ran between mixed_start and the last join
+    double mixed_s = chrono::duration<double>(chrono::steady_clock::now() - mixed_start).count();
+    cout << "\nmixed, " << fixed << setprecision(2) << mixed_s << defaultfloat << " s: " << writers
+         << " writer(s), " << readers << " reader(s)\n";
+    print_rate("admit + discharge", updates / mixed_s, "updates/s");
+    print_rate("queries alongside", queries / mixed_s, "queries/s");
+    cout << "patients still admitted: " << reg.size() << (reg.size() == patients ? "" : "   MISMATCH!") << endl;
+    cout << "query checksum: " << sink + checksum << " (printed so no query is optimized away)" << endl;
+}
+
+// Whole argument as a number in 1..max, or 0 if it is not one
+size_t parse_count(const string& text, size_t max)
+{
+    try {
+        size_t used = 0;
+        unsigned long long value = stoull(text, &used);
+        if (used == text.size() && text[0] != '-' && value <= max) return size_t(value);
+    } catch (const exception&) {
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    // ./HMS.out --bench [patients] [threads] : registry benchmark only
+    if (argc > 1) {
+        size_t patients = 10000000;
+        size_t threads = max(2u, thread::hardware_concurrency());
+        if (argc > 2) patients = parse_count(argv[2], UINT32_MAX);  // slab slots are 32-bit
+        if (argc > 3) threads = parse_count(argv[3], 1024);
+        if (string(argv[1]) != "--bench" || argc > 4 || patients == 0 || threads == 0) {
+            cerr << "usage: " << argv[0] << " [--bench [patients >= 1] [threads 1..1024]]\n";
+            return 2;
+        }
+        registry_benchmark(patients, unsigned(threads));
+        return 0;
+    }
+
+
     // Create Patient: name, age, contact, hno, street, area, diagnosis, treatment
     Patient p1("madhu", 21, "79932789473", "h no 404", "gully road", "reypally", "fracture", "plaster cast");
     
@@ -223,6 +426,9 @@ int main()
     cout << "\n========== ASSOCIATION DEMO ==========\n";
     kamla.examine(&p1);  // ASSOCIATION: Doctor examines Patient
     
+    cout << "\n========== REGISTRY DEMO ==========\n";
+    registry_demo();
+
     cout << "\n========== END ==========\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,496 @@
+/*
+Hospital registry core - indexed, concurrent storage behind the HMS classes
+
+Why
+hms.cpp models the relationships (Department HAS Doctors, Doctor sees
+Patients) with vector<Doctor*> / vector<Patient*>: every question ("who has
+a fracture?", "patients aged 30-40?") is a scan of every object. Fine for
+three patients, not for ten million.
+
+Design
+1) Slab tables: Slab<T> is a vector of slots + a free list. An id is
+   {slot, generation}; discharging bumps the generation, so a stale id can
+   never reach the patient who reuses the slot.
+2) Strings that repeat (diagnosis, specialization) are interned once in a
+   Dictionary and stored as 32-bit codes.
+3) Secondary indexes are posting lists: key -> vector of patient slots.
+   Every patient remembers its position in each list, so discharge is a
+   swap-with-last + pop_back: O(1), no search.
+      by diagnosis, by doctor, by age (ages 0..kMaxAge: one list per year,
+      so an age range query touches only the years in the range)
+4) Concurrency: patients are split into kShards shards, each with its own
+   slab, indexes and shared_mutex. Admits/discharges in different shards
+   never wait for each other; queries take shared locks one shard at a time.
+   Doctors and departments change rarely: one shared_mutex for all staff.
+
+Callbacks passed to for_each_* run under a shard's shared lock: read the
+record, do not call admit()/discharge() from inside them.
+*/
+
+#ifndef HMS_REGISTRY_H
+#define HMS_REGISTRY_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hms {
+
+constexpr int kMaxAge = 130;
+constexpr std::size_t kShards = 16;
+
+struct PatientId {
+    uint32_t shard = 0;
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+};
+
+struct DoctorId {
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+};
+
+struct DepartmentId {
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Slab<T>: id-indexed table with slot reuse
+// ---------------------------------------------------------------------------
+template <typename T>
+class Slab {
+public:
+    // Returns the slot; `generation` receives the id's generation
+    uint32_t insert(T value, uint32_t& generation) {
+        uint32_t slot;
+        if (!free_.empty()) {
+            slot = free_.back();
+            free_.pop_back();
+        } else {
+            slot = uint32_t(slots_.size());
+            slots_.emplace_back();
+        }
+        Slot& s = slots_[slot];
+        s.value = std::move(value);
+        s.live = true;
+        generation = s.generation;
+        live_++;
+        return slot;
+    }
+
+    bool erase(uint32_t slot, uint32_t generation) {
+        if (!get(slot, generation)) return false;
+        free_.push_back(slot);  // the only step that can throw: do it before changing anything
+        Slot& s = slots_[slot];
+        s.value = T{};  // release the record's memory now, not at reuse
+        s.live = false;
+        s.generation++;
+        live_--;
+        return true;
+    }
+
+    T* get(uint32_t slot, uint32_t generation) {
+        if (slot >= slots_.size() || !slots_[slot].live || slots_[slot].generation != generation) return nullptr;
+        return &slots_[slot].value;
+    }
+    const T* get(uint32_t slot, uint32_t generation) const {
+        return const_cast<Slab*>(this)->get(slot, generation);
+    }
+
+    // Unchecked access for slots taken from an index (always live)
+    T& at(uint32_t slot) { return slots_[slot].value; }
+    const T& at(uint32_t slot) const { return slots_[slot].value; }
+    uint32_t generation_of(uint32_t slot) const { return slots_[slot].generation; }
+
+    template <typename F>
+    void for_each(F&& f) const {
+        for (uint32_t i = 0; i < slots_.size(); i++) {
+            if (slots_[i].live) f(i, slots_[i].value);
+        }
+    }
+
+    std::size_t size() const { return live_; }
+    void reserve(std::size_t n) { slots_.reserve(n); }
+
+private:
+    struct Slot {
+        T value{};
+        uint32_t generation = 0;
+        bool live = false;
+    };
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_;
+    std::size_t live_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Dictionary: string <-> dense code, thread-safe
+// ---------------------------------------------------------------------------
+class Dictionary {
+public:
+    uint32_t intern(std::string_view text) {
+        {
+            std::shared_lock<std::shared_mutex> lock(m_);
+            auto it = codes_.find(text);
+            if (it != codes_.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(m_);
+        auto it = codes_.find(text);  // another thread may have added it meanwhile
+        if (it != codes_.end()) return it->second;
+        names_.emplace_back(text);  // deque: existing strings never move
+        uint32_t code = uint32_t(names_.size() - 1);
+        codes_.emplace(names_.back(), code);
+        return code;
+    }
+
+    std::optional<uint32_t> find(std::string_view text) const {
+        std::shared_lock<std::shared_mutex> lock(m_);
+        auto it = codes_.find(text);
+        if (it == codes_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    std::string name(uint32_t code) const {
+        std::shared_lock<std::shared_mutex> lock(m_);
+        return names_.at(code);
+    }
+
+private:
+    mutable std::shared_mutex m_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, uint32_t> codes_;  // views into names_
+};
+
+// ---------------------------------------------------------------------------
+// Records
+// ---------------------------------------------------------------------------
+struct PatientRecord {
+    std::string name;
+    uint32_t diagnosis = 0;   // Dictionary code
+    uint32_t doctor = 0;      // doctor slot
+    uint32_t department = 0;  // department slot (the doctor's, at admission)
+    uint8_t age = 0;
+    // position of this patient in each posting list: O(1) discharge
+    uint32_t pos_diagnosis = 0;
+    uint32_t pos_doctor = 0;
+    uint32_t pos_age = 0;
+};
+
+struct DoctorRecord {
+    std::string name;
+    uint32_t specialization = 0;  // Dictionary code
+    uint32_t department = 0;
+};
+
+struct DepartmentRecord {
+    std::string name;
+    std::vector<uint32_t> doctors;  // doctor slots
+};
+
+// Copy of a patient handed out by patient(): safe to keep after the lock
+struct PatientInfo {
+    PatientId id;
+    std::string name;
+    int age = 0;
+    std::string diagnosis;
+    DoctorId doctor;
+};
+
+// ---------------------------------------------------------------------------
+// Registry
+// ---------------------------------------------------------------------------
+class Registry {
+public:
+    Registry() = default;
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    // ---- staff (rarely written) ----
+
+    DepartmentId add_department(std::string name) {
+        std::unique_lock<std::shared_mutex> lock(staff_m_);
+        DepartmentId id;
+        id.slot = departments_.insert(DepartmentRecord{std::move(name), {}}, id.generation);
+        return id;
+    }
+
+    DoctorId add_doctor(std::string name, std::string_view specialization, DepartmentId dept) {
+        uint32_t spec = specializations_.intern(specialization);
+        std::unique_lock<std::shared_mutex> lock(staff_m_);
+        DepartmentRecord* d = departments_.get(dept.slot, dept.generation);
+        if (!d) throw std::invalid_argument("add_doctor: unknown department");
+        DoctorId id;
+        id.slot = doctors_.insert(DoctorRecord{std::move(name), spec, dept.slot}, id.generation);
+        d->doctors.push_back(id.slot);
+        if (doctors_by_specialization_.size() <= spec) doctors_by_specialization_.resize(spec + 1);
+        doctors_by_specialization_[spec].push_back(id.slot);
+        return id;
+    }
+
+    std::vector<DoctorId> doctors_by_specialization(std::string_view specialization) const {
+        std::vector<DoctorId> result;
+        std::optional<uint32_t> spec = specializations_.find(specialization);
+        if (!spec) return result;
+        std::shared_lock<std::shared_mutex> lock(staff_m_);
+        if (*spec >= doctors_by_specialization_.size()) return result;
+        for (uint32_t slot : doctors_by_specialization_[*spec]) {
+            result.push_back(DoctorId{slot, doctors_.generation_of(slot)});
+        }
+        return result;
+    }
+
+    std::vector<DoctorId> doctors_in(DepartmentId dept) const {
+        std::vector<DoctorId> result;
+        std::shared_lock<std::shared_mutex> lock(staff_m_);
+        if (const DepartmentRecord* d = departments_.get(dept.slot, dept.generation)) {
+            for (uint32_t slot : d->doctors) result.push_back(DoctorId{slot, doctors_.generation_of(slot)});
+        }
+        return result;
+    }
+
+    std::string doctor_name(DoctorId id) const {
+        std::shared_lock<std::shared_mutex> lock(staff_m_);
+        const DoctorRecord* d = doctors_.get(id.slot, id.generation);
+        return d ? d->name : std::string();
+    }
+
+    // ---- patients (hot path) ----
+
+    PatientId admit(std::string name, int age, std::string_view diagnosis, DoctorId doctor) {
+        if (age < 0 || age > kMaxAge) throw std::invalid_argument("admit: age out of range");
+        uint32_t department;
+        {
+            std::shared_lock<std::shared_mutex> lock(staff_m_);
+            const DoctorRecord* d = doctors_.get(doctor.slot, doctor.generation);
+            if (!d) throw std::invalid_argument("admit: unknown doctor");
+            department = d->department;
+        }
+        uint32_t diag = diagnoses_.intern(diagnosis);
+
+        PatientId id;
+        id.shard = uint32_t(next_shard_.fetch_add(1, std::memory_order_relaxed) % kShards);
+        Shard& s = shards_[id.shard];
+        std::unique_lock<std::shared_mutex> lock(s.m);
+        id.slot = s.patients.insert(PatientRecord{std::move(name), diag, doctor.slot, department, uint8_t(age), 0, 0, 0},
+                                    id.generation);
+        // Index the stored record. If a list cannot grow, take back the links
+        // already made and the slab entry: admit either fully happens or not at all.
+        PatientRecord& r = s.patients.at(id.slot);
+        int linked = 0;
+        try {
+            if (s.per_department.size() <= department) s.per_department.resize(department + 1);
+            r.pos_diagnosis = link(s.by_diagnosis, diag, id.slot);
+            linked++;
+            r.pos_doctor = link(s.by_doctor, doctor.slot, id.slot);
+            linked++;
+            r.pos_age = link(s.by_age, uint32_t(age), id.slot);
+        } catch (...) {
+            if (linked > 1) s.by_doctor[doctor.slot].pop_back();
+            if (linked > 0) s.by_diagnosis[diag].pop_back();
+            s.patients.erase(id.slot, id.generation);
+            throw;
+        }
+        s.per_department[department]++;
+        return id;
+    }
+
+    bool discharge(PatientId id) {
+        if (id.shard >= kShards) return false;
+        Shard& s = shards_[id.shard];
+        std::unique_lock<std::shared_mutex> lock(s.m);
+        PatientRecord* p = s.patients.get(id.slot, id.generation);
+        if (!p) return false;  // unknown or already discharged
+        unlink(s, s.by_diagnosis[p->diagnosis], p->pos_diagnosis, &PatientRecord::pos_diagnosis);
+        unlink(s, s.by_doctor[p->doctor], p->pos_doctor, &PatientRecord::pos_doctor);
+        unlink(s, s.by_age[p->age], p->pos_age, &PatientRecord::pos_age);
+        s.per_department[p->department]--;
+        s.patients.erase(id.slot, id.generation);
+        return true;
+    }
+
+    std::optional<PatientInfo> patient(PatientId id) const {
+        if (id.shard >= kShards) return std::nullopt;
+        const Shard& s = shards_[id.shard];
+        std::shared_lock<std::shared_mutex> lock(s.m);
+        const PatientRecord* p = s.patients.get(id.slot, id.generation);
+        if (!p) return std::nullopt;
+        DoctorId doc{p->doctor, 0};
+        uint32_t diag = p->diagnosis;
+        PatientInfo info{id, p->name, p->age, {}, doc};
+        lock.unlock();
+        info.diagnosis = diagnoses_.name(diag);
+        std::shared_lock<std::shared_mutex> staff(staff_m_);
+        info.doctor.generation = doctors_.generation_of(doc.slot);
+        return info;
+    }
+
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (const Shard& s : shards_) {
+            std::shared_lock<std::shared_mutex> lock(s.m);
+            n += s.patients.size();
+        }
+        return n;
+    }
+
+    // ---- queries: cost proportional to the answer, not to the hospital ----
+
+    std::size_t count_by_diagnosis(std::string_view diagnosis) const {
+        std::optional<uint32_t> diag = diagnoses_.find(diagnosis);
+        if (!diag) return 0;
+        std::size_t n = 0;
+        for (const Shard& s : shards_) {
+            std::shared_lock<std::shared_mutex> lock(s.m);
+            if (*diag < s.by_diagnosis.size()) n += s.by_diagnosis[*diag].size();
+        }
+        return n;
+    }
+
+    // f(PatientId, const PatientRecord&)
+    template <typename F>
+    void for_each_by_diagnosis(std::string_view diagnosis, F&& f) const {
+        std::optional<uint32_t> diag = diagnoses_.find(diagnosis);
+        if (!diag) return;
+        for_each_in_lists([&](const Shard& s) { return *diag < s.by_diagnosis.size() ? &s.by_diagnosis[*diag] : nullptr; },
+                          f);
+    }
+
+    // Patients aged lo..hi (inclusive)
+    std::size_t count_by_age(int lo, int hi) const {
+        lo = std::max(lo, 0);
+        hi = std::min(hi, kMaxAge);
+        std::size_t n = 0;
+        for (const Shard& s : shards_) {
+            std::shared_lock<std::shared_mutex> lock(s.m);
+            for (int age = lo; age <= hi; age++) n += s.by_age[age].size();
+        }
+        return n;
+    }
+
+    template <typename F>
+    void for_each_in_age_range(int lo, int hi, F&& f) const {
+        lo = std::max(lo, 0);
+        hi = std::min(hi, kMaxAge);
+        for (uint32_t shard = 0; shard < kShards; shard++) {
+            const Shard& s = shards_[shard];
+            std::shared_lock<std::shared_mutex> lock(s.m);
+            for (int age = lo; age <= hi; age++) {
+                for (uint32_t slot : s.by_age[age]) {
+                    f(PatientId{shard, slot, s.patients.generation_of(slot)}, s.patients.at(slot));
+                }
+            }
+        }
+    }
+
+    std::size_t count_patients_of(DoctorId doctor) const {
+        std::size_t n = 0;
+        for (const Shard& s : shards_) {
+            std::shared_lock<std::shared_mutex> lock(s.m);
+            if (doctor.slot < s.by_doctor.size()) n += s.by_doctor[doctor.slot].size();
+        }
+        return n;
+    }
+
+    // Replaces Doctor::showPatients' vector<Patient*>
+    template <typename F>
+    void for_each_patient_of(DoctorId doctor, F&& f) const {
+        for_each_in_lists([&](const Shard& s) { return doctor.slot < s.by_doctor.size() ? &s.by_doctor[doctor.slot] : nullptr; },
+                          f);
+    }
+
+    // Patients currently admitted under a department: O(kShards)
+    std::size_t department_census(DepartmentId dept) const {
+        std::size_t n = 0;
+        for (const Shard& s : shards_) {
+            std::shared_lock<std::shared_mutex> lock(s.m);
+            if (dept.slot < s.per_department.size()) n += s.per_department[dept.slot];
+        }
+        return n;
+    }
+
+    // Full scan (what the vector<Patient*> design does for every query)
+    template <typename F>
+    void for_each_patient(F&& f) const {
+        for (uint32_t shard = 0; shard < kShards; shard++) {
+            const Shard& s = shards_[shard];
+            std::shared_lock<std::shared_mutex> lock(s.m);
+            s.patients.for_each([&](uint32_t slot, const PatientRecord& p) {
+                f(PatientId{shard, slot, s.patients.generation_of(slot)}, p);
+            });
+        }
+    }
+
+    std::optional<uint32_t> diagnosis_code(std::string_view diagnosis) const { return diagnoses_.find(diagnosis); }
+
+    void reserve(std::size_t patients) {
+        for (Shard& s : shards_) {
+            std::unique_lock<std::shared_mutex> lock(s.m);
+            s.patients.reserve(patients / kShards + 1);
+        }
+    }
+
+private:
+    using Postings = std::vector<std::vector<uint32_t>>;
+
+    struct alignas(64) Shard {  // own cache line: no false sharing between shard locks
+        mutable std::shared_mutex m;
+        Slab<PatientRecord> patients;
+        Postings by_diagnosis;
+        Postings by_doctor;
+        Postings by_age = Postings(kMaxAge + 1);
+        std::vector<std::size_t> per_department;
+    };
+
+    // Appends slot to lists[key]; returns its position (unchanged lists if it throws)
+    static uint32_t link(Postings& lists, uint32_t key, uint32_t slot) {
+        if (lists.size() <= key) lists.resize(key + 1);
+        lists[key].push_back(slot);
+        return uint32_t(lists[key].size() - 1);
+    }
+
+    // Swap-remove position `pos`; the patient moved into it learns its new position
+    static void unlink(Shard& s, std::vector<uint32_t>& list, uint32_t pos, uint32_t PatientRecord::*field) {
+        uint32_t moved = list.back();
+        list[pos] = moved;
+        list.pop_back();
+        if (pos < list.size()) s.patients.at(moved).*field = pos;
+    }
+
+    template <typename ListOf, typename F>
+    void for_each_in_lists(ListOf&& list_of, F& f) const {
+        for (uint32_t shard = 0; shard < kShards; shard++) {
+            const Shard& s = shards_[shard];
+            std::shared_lock<std::shared_mutex> lock(s.m);
+            if (const std::vector<uint32_t>* list = list_of(s)) {
+                for (uint32_t slot : *list) f(PatientId{shard, slot, s.patients.generation_of(slot)}, s.patients.at(slot));
+            }
+        }
+    }
+
+    std::array<Shard, kShards> shards_;
+    std::atomic<std::size_t> next_shard_{0};
+    Dictionary diagnoses_;
+    Dictionary specializations_;
+
+    mutable std::shared_mutex staff_m_;
+    Slab<DoctorRecord> doctors_;
+    Slab<DepartmentRecord> departments_;
+    Postings doctors_by_specialization_;
+};
+
+}  // namespace hms
+
+#endif  // HMS_REGISTRY_H
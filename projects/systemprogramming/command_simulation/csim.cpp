@@ -37,15 +37,62 @@
  * - Process creation and replacement
  * - Inter-process communication via pipes
  * - Shell pipeline implementation internals
+ *
+ * ============================================================================
+ * EXTENSION: General N-stage pipeline runner
+ * ============================================================================
+ *
+ * The hard-wired `ls | wc -l` above becomes a small pipeline executor:
+ *
+ *   ./program -c "head -c 100M /dev/zero | tee copy.bin | wc -c"
+ *   ./program -c "..." --pipe-size=1048576
+ *   ./program --bench [--bytes=N]
+ *
+ * 1. parse_pipeline() splits on '|' (quotes respected) into stages.
+ * 2. External stages are started with posix_spawnp() instead of fork().
+ *    fork() must copy the parent's page tables (expensive for a big parent);
+ *    posix_spawn() uses vfork/CLONE_VM semantics and only runs the file
+ *    actions (dup2) before exec. Numbers: concurrency/08_ipc_benchmark.cpp.
+ * 3. All pipes are created O_CLOEXEC, so a child only keeps the two fds
+ *    that its dup2() file actions install as stdin/stdout - no close() list.
+ * 4. `tee [-a] [FILE...]` is a BUILTIN fan-out stage run on a thread in the
+ *    runner (-a appends instead of truncating; any other option makes the
+ *    stage exec the real tee). It never copies bytes through userspace:
+ *      tee(2)    duplicates pipe buffers (page references) into a scratch pipe
+ *      splice(2) moves scratch pipe -> file, and input pipe -> next stage
+ *    With no FILE arguments it is a zero-copy `cat`.
+ * 5. --pipe-size sets every pipe's capacity with fcntl(F_SETPIPE_SZ):
+ *    fewer, larger transfers = fewer context switches per GB.
+ * 6. The runner ignores SIGPIPE (so its tee thread sees EPIPE instead of
+ *    dying); children get SIGPIPE reset to default via POSIX_SPAWN_SETSIGDEF.
+ *
+ * --bench moves --bytes through multi-stage pipelines with this runner and
+ * with `/bin/sh -c` running the same text, and prints GB/s for each.
  */
 
 #include <iostream>
 #include <vector>
+#include <array>
 #include <string>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <iomanip>
 #include <unistd.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
 using namespace std;
 
-int main()
+extern char **environ;
+
+// The original hand-written version: one pipe, two fork()s, execlp().
+int simulate_ls_wc()
 {
     cout << "Hello simulating shell command 'ls | wc -l'\n";
     cout << "Main program PID: " << getpid() << endl;
@@ -104,4 +151,535 @@ int main()
     cout << "[Parent] Both children completed!\n";
 
     return 0;
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+struct Stage
+{
+    vector<string> argv;
+    bool builtin_tee = false; // `tee [-a] [FILE...]` runs in-process via splice/tee
+    bool tee_append = false;  // -a / --append: O_APPEND instead of O_TRUNC
+    vector<string> tee_files;
+};
+
+// Split a command line into stages on '|' and into words on whitespace.
+// Single and double quotes group words; no variables, globs or redirections.
+vector<Stage> parse_pipeline(const string &line)
+{
+    vector<Stage> stages(1);
+    string word;
+    bool in_word = false;
+    char quote = 0;
+
+    auto end_word = [&]()
+    {
+        if (in_word)
+            stages.back().argv.push_back(word);
+        word.clear();
+        in_word = false;
+    };
+
+    for (char c : line)
+    {
+        if (quote)
+        {
+            if (c == quote)
+                quote = 0;
+            else
+                word += c;
+        }
+        else if (c == '\'' || c == '"')
+        {
+            quote = c;
+            in_word = true;
+        }
+        else if (c == '|')
+        {
+            end_word();
+            stages.emplace_back();
+        }
+        else if (isspace(static_cast<unsigned char>(c)))
+        {
+            end_word();
+        }
+        else
+        {
+            word += c;
+            in_word = true;
+        }
+    }
+    if (quote)
+        throw runtime_error("unterminated quote");
+    end_word();
+
+    for (Stage &st : stages)
+    {
+        if (st.argv.empty())
+            throw runtime_error("empty pipeline stage");
+        if (st.argv[0] != "tee")
+            continue;
+        // Only -a is implemented in-process; for anything else (-i, -p, --,
+        // ...) run the real tee rather than mistake an option for a file.
+        st.builtin_tee = true;
+        for (size_t k = 1; k < st.argv.size(); k++)
+        {
+            const string &a = st.argv[k];
+            if (a == "-a" || a == "--append")
+                st.tee_append = true;
+            else if (a.size() > 1 && a[0] == '-')
+                st.builtin_tee = false;
+            else
+                st.tee_files.push_back(a);
+        }
+        if (!st.builtin_tee)
+        {
+            st.tee_append = false;
+            st.tee_files.clear();
+        }
+    }
+    return stages;
+}
+
+// ============================================================================
+// Zero-copy fan-out (builtin tee)
+// ============================================================================
+
+bool is_pipe(int fd)
+{
+    struct stat st;
+    return fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+// Move exactly n bytes from pipe `in` to `out`. splice() when the kernel
+// supports the destination; plain read/write otherwise (e.g. some ttys).
+bool move_bytes(int in, int out, size_t n)
+{
+    while (n > 0)
+    {
+        ssize_t m = splice(in, nullptr, out, nullptr, n, SPLICE_F_MOVE);
+        if (m < 0 && errno == EINTR)
+            continue;
+        if (m < 0 && errno == EINVAL)
+        {
+            char buf[65536];
+            ssize_t r = read(in, buf, min(n, sizeof(buf)));
+            if (r <= 0)
+                return false;
+            for (ssize_t off = 0; off < r;)
+            {
+                ssize_t w = write(out, buf + off, r - off);
+                if (w < 0 && errno == EINTR)
+                    continue;
+                if (w <= 0)
+                    return false;
+                off += w;
+            }
+            m = r;
+        }
+        if (m <= 0)
+            return false;
+        n -= m;
+    }
+    return true;
+}
+
+// Userspace fallback when the input is not a pipe (tee(2) needs two pipes).
+int copy_fan_out(int in, int out, const vector<int> &files)
+{
+    char buf[65536];
+    ssize_t r;
+    while ((r = read(in, buf, sizeof(buf))) > 0)
+    {
+        for (int fd : files)
+            if (write(fd, buf, r) != r)
+                return 1;
+        if (write(out, buf, r) != r)
+            return 1;
+    }
+    return r < 0 ? 1 : 0;
+}
+
+// Body of the builtin tee stage. Per round:
+//   1. tee(in -> scratch[0]) learns how many bytes (n) are queued, without
+//      consuming them; tee(in -> scratch[j]) duplicates the same n bytes.
+//      Each scratch pipe is empty and as large as `in`, so n always fits.
+//   2. splice(scratch[j] -> file[j]) drains every copy to its file.
+//   3. splice(in -> out) consumes the n bytes and hands them downstream.
+// Only page references move between pipes; the bytes are never copied.
+int fan_out(int in, int out, const vector<string> &paths, bool append)
+{
+    vector<int> files;
+    for (const string &p : paths)
+    {
+        int fd = open(p.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0644);
+        if (fd < 0)
+        {
+            cerr << "tee: " << p << ": " << strerror(errno) << "\n";
+            for (int f : files)
+                close(f);
+            close(in);
+            close(out);
+            return 1;
+        }
+        files.push_back(fd);
+    }
+
+    int status = 0;
+    if (!is_pipe(in))
+    {
+        status = copy_fan_out(in, out, files);
+    }
+    else if (files.empty())
+    {
+        // Pass-through: a zero-copy `cat`.
+        ssize_t m;
+        while ((m = splice(in, nullptr, out, nullptr, 1 << 20, SPLICE_F_MOVE)) > 0 ||
+               (m < 0 && errno == EINTR))
+        {
+        }
+        if (m < 0 && errno == EINVAL)
+            status = copy_fan_out(in, out, files);
+        else if (m < 0)
+            status = 1;
+    }
+    else
+    {
+        int in_size = fcntl(in, F_GETPIPE_SZ);
+        vector<array<int, 2>> scratch(files.size(), {-1, -1});
+        for (auto &sp : scratch)
+        {
+            if (pipe2(sp.data(), O_CLOEXEC) < 0)
+            {
+                cerr << "tee: pipe2: " << strerror(errno) << "\n";
+                sp = {-1, -1};
+                status = 1; // fall through: closing `in` unblocks the writer
+                break;
+            }
+            fcntl(sp[1], F_SETPIPE_SZ, in_size);
+        }
+
+        while (status == 0)
+        {
+            ssize_t n = tee(in, scratch[0][1], INT_MAX, 0);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+            {
+                status = n < 0 ? 1 : 0; // 0 = EOF: writers gone, pipe empty
+                break;
+            }
+            for (size_t j = 1; j < scratch.size() && status == 0; j++)
+                if (tee(in, scratch[j][1], n, 0) != n)
+                    status = 1;
+            for (size_t j = 0; j < scratch.size() && status == 0; j++)
+                if (!move_bytes(scratch[j][0], files[j], n))
+                    status = 1;
+            if (status == 0 && !move_bytes(in, out, n))
+                status = 1; // downstream closed (EPIPE) or write error
+        }
+        for (auto &sp : scratch)
+        {
+            if (sp[0] >= 0)
+                close(sp[0]);
+            if (sp[1] >= 0)
+                close(sp[1]);
+        }
+    }
+
+    for (int f : files)
+        close(f);
+    // Closing our ends propagates EOF downstream and SIGPIPE upstream.
+    close(in);
+    close(out);
+    return status;
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+struct PipelineOptions
+{
+    int pipe_size = 0;            // 0 = kernel default (64KB)
+    int in_fd = STDIN_FILENO;     // stdin of the first stage
+    int out_fd = STDOUT_FILENO;   // stdout of the last stage
+};
+
+// Runs the pipeline and returns the last stage's exit status, like sh.
+int run_pipeline(const vector<Stage> &stages, const PipelineOptions &opt)
+{
+    signal(SIGPIPE, SIG_IGN);
+
+    size_t n = stages.size();
+    vector<array<int, 2>> pipes(n - 1);
+    for (auto &p : pipes)
+    {
+        if (pipe2(p.data(), O_CLOEXEC) < 0)
+        {
+            perror("pipe2");
+            return 1;
+        }
+        if (opt.pipe_size > 0 && fcntl(p[1], F_SETPIPE_SZ, opt.pipe_size) < 0)
+            perror("F_SETPIPE_SZ");
+    }
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t defaults;
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attr, &defaults);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+    vector<pid_t> pids(n, -1);
+    vector<thread> tees;
+    vector<int> tee_status(n, 0);
+    vector<bool> owned_by_tee(2 * pipes.size(), false);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        int in = (i == 0) ? opt.in_fd : pipes[i - 1][0];
+        int out = (i == n - 1) ? opt.out_fd : pipes[i][1];
+
+        if (stages[i].builtin_tee)
+        {
+            // The thread owns (and closes) its pipe ends; stdio is dup'ed so
+            // that closing it does not close the runner's own stdin/stdout.
+            if (i == 0)
+                in = dup(in);
+            else
+                owned_by_tee[2 * (i - 1)] = true;
+            if (i == n - 1)
+                out = dup(out);
+            else
+                owned_by_tee[2 * i + 1] = true;
+
+            tees.emplace_back([&tee_status, &stages, i, in, out]()
+                              { tee_status[i] = fan_out(in, out, stages[i].tee_files,
+                                                        stages[i].tee_append); });
+            continue;
+        }
+
+        // dup2() in a file action clears O_CLOEXEC on the target, so the
+        // child ends up with exactly stdin/stdout/stderr from us.
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        if (in != STDIN_FILENO)
+            posix_spawn_file_actions_adddup2(&actions, in, STDIN_FILENO);
+        if (out != STDOUT_FILENO)
+            posix_spawn_file_actions_adddup2(&actions, out, STDOUT_FILENO);
+
+        vector<char *> argv;
+        for (const string &a : stages[i].argv)
+            argv.push_back(const_cast<char *>(a.c_str()));
+        argv.push_back(nullptr);
+
+        int rc = posix_spawnp(&pids[i], argv[0], &actions, &attr, argv.data(), environ);
+        if (rc != 0)
+        {
+            cerr << argv[0] << ": " << strerror(rc) << "\n";
+            pids[i] = -1;
+        }
+        posix_spawn_file_actions_destroy(&actions);
+    }
+    posix_spawnattr_destroy(&attr);
+
+    // Parent keeps no pipe ends, otherwise readers never see EOF.
+    for (size_t k = 0; k < pipes.size(); k++)
+    {
+        if (!owned_by_tee[2 * k])
+            close(pipes[k][0]);
+        if (!owned_by_tee[2 * k + 1])
+            close(pipes[k][1]);
+    }
+
+    int last_status = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (stages[i].builtin_tee)
+            continue;
+        int st = 127; // command not found, like sh
+        if (pids[i] > 0)
+        {
+            while (waitpid(pids[i], &st, 0) < 0 && errno == EINTR)
+            {
+            }
+            st = WIFEXITED(st) ? WEXITSTATUS(st) : 128 + WTERMSIG(st);
+        }
+        if (i == n - 1)
+            last_status = st;
+    }
+    for (thread &t : tees)
+        t.join();
+    if (stages.back().builtin_tee)
+        last_status = tee_status[n - 1];
+    return last_status;
+}
+
+// ============================================================================
+// Benchmark: this runner vs /bin/sh
+// ============================================================================
+
+// Runs `cmd` through /bin/sh -c with stdout redirected to out_fd.
+int run_with_sh(const string &cmd, int out_fd)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, out_fd, STDOUT_FILENO);
+    char *argv[] = {const_cast<char *>("sh"), const_cast<char *>("-c"),
+                    const_cast<char *>(cmd.c_str()), nullptr};
+    pid_t pid;
+    int rc = posix_spawn(&pid, "/bin/sh", &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0)
+        return 127;
+    int st = 0;
+    waitpid(pid, &st, 0);
+    return WIFEXITED(st) ? WEXITSTATUS(st) : 128 + WTERMSIG(st);
+}
+
+double gb_per_sec(size_t bytes, chrono::steady_clock::time_point start)
+{
+    double s = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return bytes / s / 1e9;
+}
+
+void benchmark_pipelines(size_t bytes)
+{
+    int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    string src = "head -c " + to_string(bytes) + " /dev/zero";
+
+    struct Case
+    {
+        string name;
+        string ours;    // pipeline text for run_pipeline()
+        string shell;   // equivalent text for /bin/sh
+    };
+    vector<Case> cases = {
+        {"3 x cat relay", src + " | cat | cat | cat | wc -c",
+         src + " | cat | cat | cat | wc -c"},
+        {"3 x relay (splice tee)", src + " | tee | tee | tee | wc -c",
+         src + " | cat | cat | cat | wc -c"},
+        {"fan-out to /dev/null", src + " | tee /dev/null | wc -c",
+         src + " | tee /dev/null | wc -c"},
+        {"fan-out x2 + relay", src + " | tee /dev/null /dev/null | tee | wc -c",
+         src + " | tee /dev/null /dev/null | cat | wc -c"},
+    };
+
+    cout << "\n=== PIPELINE THROUGHPUT: " << bytes / (1 << 20) << " MB per run ===\n";
+    cout << "(builtin tee = splice/tee zero-copy; /bin/sh runs /usr/bin/tee and cat)\n\n";
+    cout << left << setw(26) << "pipeline" << right << setw(14) << "/bin/sh"
+         << setw(14) << "runner 64K" << setw(14) << "runner 1M" << "   (GB/s)\n";
+
+    for (const Case &c : cases)
+    {
+        cout << left << setw(26) << c.name << right << fixed << setprecision(2);
+
+        auto start = chrono::steady_clock::now();
+        run_with_sh(c.shell, devnull);
+        cout << setw(14) << gb_per_sec(bytes, start);
+
+        for (int pipe_size : {0, 1 << 20})
+        {
+            PipelineOptions opt;
+            opt.pipe_size = pipe_size;
+            opt.out_fd = devnull;
+            start = chrono::steady_clock::now();
+            run_pipeline(parse_pipeline(c.ours), opt);
+            cout << setw(14) << gb_per_sec(bytes, start);
+        }
+        cout << "\n";
+    }
+    cout << defaultfloat;
+    cout << "\nNotes:\n"
+         << "- head and wc still copy through userspace; the builtin stages do not.\n"
+         << "- Larger pipes (F_SETPIPE_SZ) mean fewer wakeups per GB on few cores.\n"
+         << "- Pipe sizes above /proc/sys/fs/pipe-max-size need CAP_SYS_RESOURCE.\n";
+    close(devnull);
+}
+
+// Whole argument as a number in [lo, hi]; false if it is not one
+bool parse_number(const string &text, size_t lo, size_t hi, size_t &value)
+{
+    try
+    {
+        size_t used = 0;
+        unsigned long long v = stoull(text, &used);
+        if (used != text.size() || text[0] == '-' || v < lo || v > hi)
+            return false;
+        value = size_t(v);
+        return true;
+    }
+    catch (const exception &)
+    {
+        return false;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t kMaxPipeSize = size_t(1) << 30; // F_SETPIPE_SZ takes an int
+    const size_t kMaxBenchBytes = size_t(1) << 40;
+    string command;
+    bool bench = false;
+    size_t bench_bytes = size_t(1) << 30;
+    PipelineOptions opt;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool ok = true;
+        size_t pipe_size = 0;
+        if (arg == "-c" && i + 1 < argc)
+            command = argv[++i];
+        else if (arg.rfind("--pipe-size=", 0) == 0)
+        {
+            ok = parse_number(arg.substr(12), 0, kMaxPipeSize, pipe_size);
+            opt.pipe_size = int(pipe_size);
+        }
+        else if (arg == "--bench")
+            bench = true;
+        else if (arg.rfind("--bytes=", 0) == 0)
+            ok = parse_number(arg.substr(8), 1, kMaxBenchBytes, bench_bytes);
+        else
+            ok = false;
+        if (!ok)
+        {
+            cerr << "usage: " << argv[0] << " [-c \"cmd | cmd ...\"] [--pipe-size=0.." << kMaxPipeSize
+                 << "] [--bench [--bytes=1.." << kMaxBenchBytes << "]]\n";
+            return 2;
+        }
+    }
+
+    if (bench)
+    {
+        benchmark_pipelines(bench_bytes);
+        return 0;
+    }
+
+    if (!command.empty())
+    {
+        try
+        {
+            return run_pipeline(parse_pipeline(command), opt);
+        }
+        catch (const exception &e)
+        {
+            cerr << "parse error: " << e.what() << "\n";
+            return 2;
+        }
+    }
+
+    // No arguments: the classic demo, then the same pipeline via the runner.
+    simulate_ls_wc();
+
+    cout << "\n[Runner] ls | tee listing.txt | wc -l  (posix_spawn + splice tee)\n";
+    cout.flush();
+    int st = run_pipeline(parse_pipeline("ls | tee listing.txt | wc -l"), opt);
+    cout << "[Runner] exit status " << st << ", listing.txt written by the builtin tee\n";
+    unlink("listing.txt");
+    return 0;
+}
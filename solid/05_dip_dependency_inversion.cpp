@@ -21,6 +21,34 @@
 #include <vector>
 #include <memory>
 #include <fstream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string_view>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+// POSIX I/O for the real FileLogger / CloudLogger backends
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -70,12 +98,26 @@ namespace bad_design
 namespace good_design
 {
 
+    struct MessageBatch; // bulk campaign types, defined after UserNotifier
+
+    enum class Channel : uint8_t
+    {
+        Email,
+        SMS,
+        Push
+    };
+    constexpr size_t kChannelCount = 3;
+
     // Abstraction - high-level policy
     class MessageService
     {
     public:
         virtual ~MessageService() = default;
         virtual void send(const string &recipient, const string &message) = 0;
+
+        // Bulk path; the default falls back to one send() per message so
+        // every existing service works, bulk-capable ones override it.
+        virtual void sendBatch(const MessageBatch &batch);
     };
 
     // Low-level detail - Email implementation
@@ -132,6 +174,490 @@ namespace good_design
         }
     };
 
+    // ------------------------------------------------------------------------
+    // BULK CAMPAIGNS: one template, millions of recipients, three channels.
+    // Still depends only on MessageService - channels are injected.
+    // ------------------------------------------------------------------------
+
+    // Recipients stored column-wise in one arena instead of one heap string
+    // per field: ~1 allocation per million strings and good cache locality
+    // when render threads stream through it.
+    class RecipientList
+    {
+    private:
+        vector<string> fieldNames; // template placeholders this list can fill
+        string arena;              // address, field1, field2, ... back to back
+        vector<uint32_t> starts;   // (fields + 1) offsets per recipient, + sentinel (arena < 4 GiB)
+        vector<Channel> channels;
+
+    public:
+        explicit RecipientList(vector<string> fields) : fieldNames(move(fields))
+        {
+            starts.push_back(0);
+        }
+
+        void reserve(size_t recipients, size_t bytesPerRecipient)
+        {
+            arena.reserve(recipients * bytesPerRecipient);
+            starts.reserve(recipients * (fieldNames.size() + 1) + 1);
+            channels.reserve(recipients);
+        }
+
+        void add(Channel channel, const string &address, const vector<string> &fields)
+        {
+            if (fields.size() != fieldNames.size())
+            {
+                throw invalid_argument("RecipientList: expected " + to_string(fieldNames.size()) + " fields");
+            }
+            size_t needed = address.size();
+            for (const string &value : fields)
+            {
+                needed += value.size();
+            }
+            if (arena.size() + needed > numeric_limits<uint32_t>::max())
+            {
+                throw length_error("RecipientList: arena would exceed 4 GiB (32-bit offsets)");
+            }
+            arena += address;
+            starts.push_back(static_cast<uint32_t>(arena.size()));
+            for (const string &value : fields)
+            {
+                arena += value;
+                starts.push_back(static_cast<uint32_t>(arena.size()));
+            }
+            channels.push_back(channel);
+        }
+
+        size_t size() const { return channels.size(); }
+        Channel channel(size_t i) const { return channels[i]; }
+        const vector<string> &fields() const { return fieldNames; }
+
+        // column 0 is the address, column k >= 1 is field k-1
+        string_view column(size_t i, size_t k) const
+        {
+            const size_t idx = i * (fieldNames.size() + 1) + k;
+            return string_view(arena).substr(starts[idx], starts[idx + 1] - starts[idx]);
+        }
+
+        string_view address(size_t i) const { return column(i, 0); }
+
+        size_t bytes() const
+        {
+            return arena.size() + starts.size() * sizeof(uint32_t) +
+                   channels.size() * sizeof(Channel);
+        }
+    };
+
+    // "Hi {name}, order {order} shipped" compiled ONCE into literal/field
+    // segments, so rendering is a flat sequence of appends - no parsing,
+    // no find/replace per recipient.
+    class MessageTemplate
+    {
+    private:
+        // Offsets, not string_views: views into `source` would dangle after
+        // the template is copied or moved.
+        struct Segment
+        {
+            size_t offset; // literal = source.substr(offset, length) when column == 0
+            size_t length;
+            size_t column; // RecipientList column (>= 1) or 0 for literal
+        };
+
+        string source;
+        vector<Segment> segments;
+
+    public:
+        MessageTemplate(string text, const vector<string> &fieldNames) : source(move(text))
+        {
+            const string_view src(source);
+            size_t pos = 0;
+            while (pos < src.size())
+            {
+                const size_t open = src.find('{', pos);
+                if (open == string_view::npos)
+                {
+                    segments.push_back({pos, src.size() - pos, 0});
+                    break;
+                }
+                const size_t close = src.find('}', open);
+                if (close == string_view::npos)
+                {
+                    throw invalid_argument("MessageTemplate: unterminated placeholder");
+                }
+                if (open > pos)
+                {
+                    segments.push_back({pos, open - pos, 0});
+                }
+                const string_view name = src.substr(open + 1, close - open - 1);
+                const auto it = find(fieldNames.begin(), fieldNames.end(), name);
+                if (it == fieldNames.end())
+                {
+                    throw invalid_argument("MessageTemplate: unknown field {" + string(name) + "}");
+                }
+                segments.push_back({0, 0, static_cast<size_t>(it - fieldNames.begin()) + 1});
+                pos = close + 1;
+            }
+        }
+
+        void renderInto(string &out, const RecipientList &list, size_t recipient) const
+        {
+            for (const Segment &seg : segments)
+            {
+                if (seg.column == 0)
+                {
+                    out.append(source, seg.offset, seg.length);
+                }
+                else
+                {
+                    out += list.column(recipient, seg.column);
+                }
+            }
+        }
+    };
+
+    // A batch of rendered messages for ONE channel. Bodies live back to back
+    // in one buffer; batches are recycled through BatchPool so the buffer
+    // capacity is reused instead of reallocated per message.
+    struct MessageBatch
+    {
+        struct Entry
+        {
+            uint32_t recipient;
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        Channel channel = Channel::Email;
+        const RecipientList *recipients = nullptr;
+        string buffer;
+        vector<Entry> entries;
+
+        string_view body(const Entry &e) const { return string_view(buffer).substr(e.offset, e.length); }
+    };
+
+    inline void MessageService::sendBatch(const MessageBatch &batch)
+    {
+        for (const auto &entry : batch.entries)
+        {
+            send(string(batch.recipients->address(entry.recipient)), string(batch.body(entry)));
+        }
+    }
+
+    // Bounded pool: at most `limit` batches exist, so memory stays flat no
+    // matter how many recipients a campaign has (renderers block when the
+    // channels fall behind).
+    class BatchPool
+    {
+    private:
+        mutex mtx;
+        condition_variable available;
+        vector<unique_ptr<MessageBatch>> free;
+        size_t created = 0;
+        size_t limit;
+        size_t reserveBytes;
+
+    public:
+        BatchPool(size_t maxBatches, size_t bytesPerBatch) : limit(maxBatches), reserveBytes(bytesPerBatch) {}
+
+        unique_ptr<MessageBatch> acquire()
+        {
+            unique_lock<mutex> lock(mtx);
+            available.wait(lock, [&]() { return !free.empty() || created < limit; });
+            if (!free.empty())
+            {
+                auto batch = move(free.back());
+                free.pop_back();
+                return batch;
+            }
+            ++created;
+            lock.unlock();
+            auto batch = make_unique<MessageBatch>();
+            batch->buffer.reserve(reserveBytes);
+            return batch;
+        }
+
+        void release(unique_ptr<MessageBatch> batch)
+        {
+            batch->buffer.clear(); // keeps capacity
+            batch->entries.clear();
+            {
+                lock_guard<mutex> lock(mtx);
+                free.push_back(move(batch));
+            }
+            available.notify_one();
+        }
+
+        size_t batchesCreated()
+        {
+            lock_guard<mutex> lock(mtx);
+            return created;
+        }
+
+        size_t bytes()
+        {
+            lock_guard<mutex> lock(mtx);
+            size_t total = 0;
+            for (const auto &b : free)
+            {
+                total += sizeof(MessageBatch) + b->buffer.capacity() +
+                         b->entries.capacity() * sizeof(MessageBatch::Entry);
+            }
+            return total;
+        }
+    };
+
+    struct CampaignStats
+    {
+        uint64_t messages = 0;
+        uint64_t batches = 0;
+        uint64_t bytes = 0;
+        size_t poolBatches = 0;
+        size_t poolBytes = 0;
+        double seconds = 0;
+    };
+
+    // Bulk notify: render threads split the recipient list; each keeps one
+    // open batch per channel and hands full batches to that channel's
+    // dispatcher thread. Channels therefore send in parallel with each other
+    // and with rendering.
+    //
+    //   render[0..T) --batches--> queue[Email] --> EmailService::sendBatch
+    //                        \--> queue[SMS]   --> SMSService::sendBatch
+    //                         \-> queue[Push]  --> PushService::sendBatch
+    class BulkNotifier
+    {
+    public:
+        static constexpr size_t kBatchMessages = 512;
+
+    private:
+        array<MessageService *, kChannelCount> services;
+        size_t renderThreads;
+
+        struct ChannelQueue
+        {
+            mutex mtx;
+            condition_variable cv;
+            deque<unique_ptr<MessageBatch>> batches;
+            bool closed = false;
+        };
+
+    public:
+        BulkNotifier(MessageService *email, MessageService *sms, MessageService *push,
+                     size_t threads = thread::hardware_concurrency())
+            : services{email, sms, push}, renderThreads(threads == 0 ? 1 : threads) {}
+
+        CampaignStats notifyAll(const MessageTemplate &tmpl, const RecipientList &recipients)
+        {
+            const auto start = chrono::steady_clock::now();
+            // Enough batches for every renderer's open batches plus some in flight
+            BatchPool pool(renderThreads * kChannelCount + 4 * kChannelCount, kBatchMessages * 96);
+            array<ChannelQueue, kChannelCount> queues;
+            atomic<uint64_t> sentMessages{0}, sentBatches{0}, sentBytes{0};
+
+            vector<thread> dispatchers;
+            for (size_t c = 0; c < kChannelCount; ++c)
+            {
+                dispatchers.emplace_back([&, c]() {
+                    ChannelQueue &q = queues[c];
+                    while (true)
+                    {
+                        unique_ptr<MessageBatch> batch;
+                        {
+                            unique_lock<mutex> lock(q.mtx);
+                            q.cv.wait(lock, [&]() { return q.closed || !q.batches.empty(); });
+                            if (q.batches.empty())
+                            {
+                                return;
+                            }
+                            batch = move(q.batches.front());
+                            q.batches.pop_front();
+                        }
+                        services[c]->sendBatch(*batch);
+                        sentMessages += batch->entries.size();
+                        sentBytes += batch->buffer.size();
+                        ++sentBatches;
+                        pool.release(move(batch));
+                    }
+                });
+            }
+
+            auto ship = [&](unique_ptr<MessageBatch> batch) {
+                ChannelQueue &q = queues[static_cast<size_t>(batch->channel)];
+                {
+                    lock_guard<mutex> lock(q.mtx);
+                    q.batches.push_back(move(batch));
+                }
+                q.cv.notify_one();
+            };
+
+            vector<thread> renderers;
+            const size_t n = recipients.size();
+            for (size_t t = 0; t < renderThreads; ++t)
+            {
+                renderers.emplace_back([&, t]() {
+                    array<unique_ptr<MessageBatch>, kChannelCount> open;
+                    for (size_t i = t * n / renderThreads; i < (t + 1) * n / renderThreads; ++i)
+                    {
+                        const size_t c = static_cast<size_t>(recipients.channel(i));
+                        if (!open[c])
+                        {
+                            open[c] = pool.acquire();
+                            open[c]->channel = recipients.channel(i);
+                            open[c]->recipients = &recipients;
+                        }
+                        MessageBatch &batch = *open[c];
+                        const size_t offset = batch.buffer.size();
+                        tmpl.renderInto(batch.buffer, recipients, i);
+                        batch.entries.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(offset),
+                                                 static_cast<uint32_t>(batch.buffer.size() - offset)});
+                        if (batch.entries.size() == kBatchMessages)
+                        {
+                            ship(move(open[c]));
+                        }
+                    }
+                    for (auto &batch : open)
+                    {
+                        if (batch)
+                        {
+                            ship(move(batch)); // partial tail batches
+                        }
+                    }
+                });
+            }
+            for (auto &r : renderers)
+            {
+                r.join();
+            }
+            for (auto &q : queues)
+            {
+                {
+                    lock_guard<mutex> lock(q.mtx);
+                    q.closed = true;
+                }
+                q.cv.notify_one();
+            }
+            for (auto &d : dispatchers)
+            {
+                d.join();
+            }
+
+            CampaignStats stats;
+            stats.messages = sentMessages;
+            stats.batches = sentBatches;
+            stats.bytes = sentBytes;
+            stats.poolBatches = pool.batchesCreated();
+            stats.poolBytes = pool.bytes();
+            stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            return stats;
+        }
+    };
+
+    // ------------------------------------------------------------------------
+    // Benchmark: messages/sec and memory per recipient
+    // ------------------------------------------------------------------------
+
+    // Stand-in for a real channel: consumes every byte (checksum) so the
+    // work cannot be optimised away, but performs no I/O.
+    class CountingMessageService : public MessageService
+    {
+    private:
+        atomic<uint64_t> messages{0};
+        atomic<uint64_t> checksum{0};
+
+    public:
+        void send(const string &recipient, const string &message) override
+        {
+            uint64_t h = recipient.size();
+            for (char ch : message)
+            {
+                h = h * 31 + static_cast<unsigned char>(ch);
+            }
+            checksum += h;
+            ++messages;
+        }
+
+        void sendBatch(const MessageBatch &batch) override
+        {
+            uint64_t h = 0;
+            for (char ch : batch.buffer)
+            {
+                h = h * 31 + static_cast<unsigned char>(ch);
+            }
+            checksum += h;
+            messages += batch.entries.size();
+        }
+
+        uint64_t count() const { return messages.load(); }
+    };
+
+    inline size_t residentBytes()
+    {
+        ifstream status("/proc/self/status");
+        string line;
+        while (getline(status, line))
+        {
+            if (line.rfind("VmRSS:", 0) == 0)
+            {
+                return stoul(line.substr(6)) * 1024;
+            }
+        }
+        return 0;
+    }
+
+    inline void benchmarkBulkNotify()
+    {
+        constexpr size_t kRecipients = 1000000;
+        cout << "\n--- BULK NOTIFY BENCHMARK (" << kRecipients << " recipients, 3 channels) ---\n";
+
+        const size_t rssBefore = residentBytes();
+        RecipientList recipients({"name", "order"});
+        recipients.reserve(kRecipients, 40);
+        for (size_t i = 0; i < kRecipients; ++i)
+        {
+            const string id = to_string(i);
+            recipients.add(static_cast<Channel>(i % kChannelCount), "user" + id + "@example.com",
+                           {"User" + id, "ORD-" + id});
+        }
+        const size_t rssAfterLoad = residentBytes();
+
+        const string text = "Hi {name}, your order {order} has shipped!";
+        CountingMessageService email, sms, push;
+
+        // Baseline: UserNotifier, one send() per recipient with a freshly
+        // find/replace-rendered string
+        {
+            CountingMessageService counting;
+            UserNotifier notifier(&counting);
+            const size_t sample = kRecipients / 10;
+            const auto start = chrono::steady_clock::now();
+            for (size_t i = 0; i < sample; ++i)
+            {
+                string message = text;
+                message.replace(message.find("{name}"), 6, string(recipients.column(i, 1)));
+                message.replace(message.find("{order}"), 7, string(recipients.column(i, 2)));
+                notifier.notifyUser(string(recipients.address(i)), message);
+            }
+            const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << "  UserNotifier (per call) : " << static_cast<uint64_t>(sample / seconds)
+                 << " messages/sec\n";
+        }
+
+        BulkNotifier bulk(&email, &sms, &push);
+        const MessageTemplate tmpl(text, recipients.fields());
+        const CampaignStats s = bulk.notifyAll(tmpl, recipients);
+        const size_t rssAfterSend = residentBytes();
+
+        cout << "  BulkNotifier (batched)  : " << static_cast<uint64_t>(s.messages / s.seconds)
+             << " messages/sec, " << s.batches << " batches, "
+             << email.count() << "/" << sms.count() << "/" << push.count() << " email/sms/push\n";
+        cout << "  memory per recipient    : " << recipients.bytes() / kRecipients
+             << " B recipient table, " << static_cast<double>(s.poolBytes) / kRecipients
+             << " B render buffers (" << s.poolBatches << " pooled batches), RSS +"
+             << (rssAfterLoad - rssBefore) / kRecipients << " B load / +"
+             << (rssAfterSend > rssAfterLoad ? (rssAfterSend - rssAfterLoad) / kRecipients : 0)
+             << " B send\n";
+    }
+
     // Benefits:
     // 1. UserNotifier is decoupled from specific implementations
     // 2. Easy to switch between Email, SMS, Push, etc.
@@ -147,6 +673,13 @@ namespace good_design
 namespace payment_system
 {
 
+    // Keyed request used by the async layer further down
+    struct ChargeRequest
+    {
+        string idempotencyKey;
+        double amount;
+    };
+
     // High-level abstraction
     class PaymentProcessor
     {
@@ -154,6 +687,18 @@ namespace payment_system
         virtual ~PaymentProcessor() = default;
         virtual bool processPayment(double amount) = 0;
         virtual string getProcessorName() const = 0;
+
+        // Keyed variants for AsyncPaymentGateway. Defaults keep existing
+        // processors valid: charge forwards, refund is "not supported".
+        virtual bool charge(const ChargeRequest &request)
+        {
+            return processPayment(request.amount);
+        }
+
+        virtual bool refund(const ChargeRequest &)
+        {
+            return false;
+        }
     };
 
     // Low-level implementations
@@ -208,35 +753,674 @@ namespace payment_system
     // High-level business logic depends on abstraction
     class OrderService
     {
-    private:
-        PaymentProcessor *processor;
+    private:
+        PaymentProcessor *processor;
+
+    public:
+        OrderService(PaymentProcessor *proc) : processor(proc) {}
+
+        void checkout(double amount)
+        {
+            cout << "\n=== Checkout Process ===\n";
+            cout << "Using payment processor: "
+                 << processor->getProcessorName() << "\n";
+
+            bool success = processor->processPayment(amount);
+
+            if (success)
+            {
+                cout << "Order completed successfully!\n";
+            }
+            else
+            {
+                cout << "Payment failed!\n";
+            }
+        }
+
+        void setPaymentProcessor(PaymentProcessor *proc)
+        {
+            processor = proc;
+        }
+    };
+
+    // ------------------------------------------------------------------------
+    // ASYNC PAYMENT LAYER: idempotency keys, per-processor in-flight limits,
+    // failover on timeout. OrderService above stays as the simple synchronous
+    // version; AsyncOrderService depends on the same PaymentProcessor abstraction.
+    // ------------------------------------------------------------------------
+
+    using Clock = chrono::steady_clock;
+
+    struct PaymentResult
+    {
+        bool success = false;
+        string processor; // who finally charged the customer
+        int attempts = 0;
+    };
+
+    // Fixed-size worker pool. Processor calls block on (simulated) network I/O,
+    // so the pool is sized to the sum of the per-processor in-flight limits.
+    class WorkerPool
+    {
+    private:
+        mutex mtx;
+        condition_variable cv;
+        deque<function<void()>> tasks;
+        vector<thread> workers;
+        bool stopping = false;
+
+    public:
+        explicit WorkerPool(size_t threads)
+        {
+            for (size_t i = 0; i < threads; ++i)
+            {
+                workers.emplace_back([this]() {
+                    while (true)
+                    {
+                        function<void()> task;
+                        {
+                            unique_lock<mutex> lock(mtx);
+                            cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                            if (tasks.empty())
+                            {
+                                return;
+                            }
+                            task = move(tasks.front());
+                            tasks.pop_front();
+                        }
+                        task();
+                    }
+                });
+            }
+        }
+
+        ~WorkerPool() { shutdown(); }
+
+        // Runs every queued task (including ones the tasks themselves
+        // submit), then joins the workers. Idempotent.
+        void shutdown()
+        {
+            {
+                lock_guard<mutex> lock(mtx);
+                stopping = true;
+            }
+            cv.notify_all();
+            for (auto &w : workers)
+            {
+                if (w.joinable())
+                {
+                    w.join();
+                }
+            }
+        }
+
+        void submit(function<void()> task)
+        {
+            {
+                lock_guard<mutex> lock(mtx);
+                tasks.push_back(move(task));
+            }
+            cv.notify_one();
+        }
+    };
+
+    // One thread that fires callbacks at deadlines (attempt timeouts).
+    class TimerWheel
+    {
+    private:
+        using Entry = pair<Clock::time_point, function<void()>>;
+        struct Later
+        {
+            bool operator()(const Entry &a, const Entry &b) const { return a.first > b.first; }
+        };
+
+        mutex mtx;
+        condition_variable cv;
+        priority_queue<Entry, vector<Entry>, Later> timers;
+        bool stopping = false;
+        thread worker;
+
+        void run()
+        {
+            unique_lock<mutex> lock(mtx);
+            while (!stopping)
+            {
+                if (timers.empty())
+                {
+                    cv.wait(lock);
+                    continue;
+                }
+                const Clock::time_point due = timers.top().first;
+                if (Clock::now() < due)
+                {
+                    cv.wait_until(lock, due); // woken early if an earlier timer arrives
+                    continue;
+                }
+                function<void()> fire = timers.top().second;
+                timers.pop();
+                lock.unlock();
+                fire();
+                lock.lock();
+            }
+        }
+
+    public:
+        TimerWheel() : worker(&TimerWheel::run, this) {}
+
+        ~TimerWheel() { shutdown(); }
+
+        // Stops firing; timers scheduled afterwards are kept but never run. Idempotent.
+        void shutdown()
+        {
+            {
+                lock_guard<mutex> lock(mtx);
+                stopping = true;
+            }
+            cv.notify_one();
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+
+        void schedule(Clock::time_point when, function<void()> fn)
+        {
+            {
+                lock_guard<mutex> lock(mtx);
+                timers.emplace(when, move(fn));
+            }
+            cv.notify_one();
+        }
+    };
+
+    struct GatewayStats
+    {
+        uint64_t submitted = 0;
+        uint64_t dedupedRetries = 0; // retries answered from the idempotency table
+        uint64_t attempts = 0;
+        uint64_t timeouts = 0;
+        uint64_t failovers = 0;
+        uint64_t lateRefunds = 0; // timed-out attempt charged anyway -> reversed
+        uint64_t failedRefunds = 0; // late duplicate the processor would not reverse
+        uint64_t skippedAttempts = 0; // queued attempt dropped: payment already settled
+        uint64_t evictedKeys = 0;     // settled keys expired from the idempotency table
+        uint64_t succeeded = 0;
+        uint64_t failed = 0;
+    };
+
+    // Async payment gateway.
+    //
+    //   submit(key, amount) --> idempotency table (sharded) --hit--> same future
+    //                                    | miss
+    //                                    v
+    //        lane[0] (limit N) --timeout--> lane[1] --timeout--> lane[2]
+    //
+    // Invariants:
+    // - One PaymentState per idempotency key; retries share its future, so a
+    //   retry can never start a second charge.
+    // - A lane never has more than maxInFlight calls inside its processor;
+    //   excess attempts wait in that lane's FIFO.
+    // - On timeout we fail over, but the slow attempt may still succeed later.
+    //   First success settles the payment; any later success is refunded.
+    class AsyncPaymentGateway
+    {
+    public:
+        struct Options
+        {
+            chrono::milliseconds attemptTimeout{25};
+            size_t maxInFlightPerProcessor = 32;
+            bool idempotency = true; // false = naive baseline for the benchmark
+            // Settled keys are forgotten after the TTL, or earlier once a shard
+            // holds more than maxKeysPerShard. In-flight keys are never evicted.
+            chrono::milliseconds idempotencyTtl = chrono::minutes(10);
+            size_t maxKeysPerShard = 1 << 16;
+        };
+
+    private:
+        struct PaymentState
+        {
+            string key;
+            double amount = 0;
+            promise<PaymentResult> done;
+            shared_future<PaymentResult> result;
+
+            mutex mtx;
+            int currentAttempt = 0; // attempt id that owns the deadline
+            int outstanding = 0;    // attempts still inside a processor / lane queue
+            size_t nextLane = 0;    // failover order: lane 0, 1, 2, ...
+            bool settled = false;
+            // Read by eviction under the shard lock, without p->mtx
+            atomic<Clock::rep> settledAt{0};
+        };
+        using PaymentPtr = shared_ptr<PaymentState>;
+
+        struct Lane
+        {
+            PaymentProcessor *processor;
+            mutex mtx;
+            size_t inFlight = 0;
+            deque<function<void()>> waiting;
+        };
+
+        static constexpr size_t kShards = 16;
+        struct Shard
+        {
+            mutex mtx;
+            unordered_map<string, PaymentPtr> byKey;
+            deque<PaymentPtr> byAge; // insertion order, for eviction
+        };
+
+        // Workers and timers touch every other member, so they are declared
+        // last (destroyed first) and explicitly shut down in the destructor.
+        Options options;
+        vector<unique_ptr<Lane>> lanes;
+        array<Shard, kShards> table;
+        mutable mutex statsMtx;
+        GatewayStats stats_;
+        WorkerPool pool;
+        TimerWheel timers;
+
+        template <typename Fn>
+        void bump(Fn &&update)
+        {
+            lock_guard<mutex> lock(statsMtx);
+            update(stats_);
+        }
+
+        // Takes a lane slot or queues the attempt until one frees up.
+        void runOnLane(size_t laneIdx, function<void()> attempt)
+        {
+            Lane &lane = *lanes[laneIdx];
+            {
+                lock_guard<mutex> lock(lane.mtx);
+                if (lane.inFlight >= options.maxInFlightPerProcessor)
+                {
+                    lane.waiting.push_back(move(attempt));
+                    return;
+                }
+                ++lane.inFlight;
+            }
+            pool.submit(move(attempt));
+        }
+
+        void releaseLane(size_t laneIdx)
+        {
+            Lane &lane = *lanes[laneIdx];
+            function<void()> next;
+            {
+                lock_guard<mutex> lock(lane.mtx);
+                if (lane.waiting.empty())
+                {
+                    --lane.inFlight;
+                    return;
+                }
+                next = move(lane.waiting.front()); // slot handed over, inFlight unchanged
+                lane.waiting.pop_front();
+            }
+            pool.submit(move(next));
+        }
+
+        // Caller holds p->mtx.
+        void settleLocked(const PaymentPtr &p, bool success, const string &processor, int attempts)
+        {
+            p->settled = true;
+            p->settledAt.store(Clock::now().time_since_epoch().count(), memory_order_release);
+            p->done.set_value({success, processor, attempts});
+            bump([&](GatewayStats &s) { ++(success ? s.succeeded : s.failed); });
+        }
+
+        // Caller holds p->mtx. Starts the next attempt, or settles as failed
+        // when every lane was tried and nothing is still running.
+        void failoverLocked(const PaymentPtr &p)
+        {
+            if (p->nextLane < lanes.size())
+            {
+                startAttemptLocked(p);
+                return;
+            }
+            if (p->outstanding == 0)
+            {
+                settleLocked(p, false, "", p->currentAttempt);
+            }
+        }
+
+        void startAttemptLocked(const PaymentPtr &p)
+        {
+            const size_t laneIdx = p->nextLane++;
+            const int attemptId = ++p->currentAttempt;
+            ++p->outstanding;
+            if (attemptId > 1)
+            {
+                bump([](GatewayStats &s) { ++s.failovers; });
+            }
+
+            runOnLane(laneIdx, [this, p, laneIdx, attemptId]() {
+                // Queued behind a timeout or an earlier success: do not charge
+                // at all. (Settling between here and charge() is still possible;
+                // onAttemptDone refunds that case.)
+                bool skip = false;
+                {
+                    lock_guard<mutex> lock(p->mtx);
+                    if (p->settled)
+                    {
+                        --p->outstanding;
+                        skip = true;
+                    }
+                }
+                if (skip)
+                {
+                    bump([](GatewayStats &s) { ++s.skippedAttempts; });
+                    releaseLane(laneIdx);
+                    return;
+                }
+                // Deadline starts when the call really starts, not while queued
+                timers.schedule(Clock::now() + options.attemptTimeout,
+                                [this, p, attemptId]() { onTimeout(p, attemptId); });
+                bump([](GatewayStats &s) { ++s.attempts; });
+                PaymentProcessor *proc = lanes[laneIdx]->processor;
+                const bool ok = proc->charge({p->key, p->amount});
+                releaseLane(laneIdx);
+                onAttemptDone(p, proc, attemptId, ok);
+            });
+        }
+
+        // Caller holds shard.mtx. Drops settled keys from the oldest end:
+        // expired ones, and any settled ones while the shard is over its cap.
+        // An unsettled key at the front stops the sweep (amortised O(1)).
+        void evictLocked(Shard &shard)
+        {
+            const Clock::rep now = Clock::now().time_since_epoch().count();
+            const Clock::rep ttl = chrono::duration_cast<Clock::duration>(options.idempotencyTtl).count();
+            while (!shard.byAge.empty())
+            {
+                const PaymentPtr &oldest = shard.byAge.front();
+                const Clock::rep at = oldest->settledAt.load(memory_order_acquire);
+                if (at == 0 || (now - at < ttl && shard.byKey.size() <= options.maxKeysPerShard))
+                {
+                    break;
+                }
+                shard.byKey.erase(oldest->key);
+                shard.byAge.pop_front();
+                bump([](GatewayStats &s) { ++s.evictedKeys; });
+            }
+        }
+
+        void onTimeout(const PaymentPtr &p, int attemptId)
+        {
+            lock_guard<mutex> lock(p->mtx);
+            if (p->settled || attemptId != p->currentAttempt)
+            {
+                return; // already answered, or a newer attempt owns the deadline
+            }
+            bump([](GatewayStats &s) { ++s.timeouts; });
+            failoverLocked(p);
+        }
+
+        void onAttemptDone(const PaymentPtr &p, PaymentProcessor *proc, int attemptId, bool ok)
+        {
+            bool refund = false;
+            {
+                lock_guard<mutex> lock(p->mtx);
+                --p->outstanding;
+                if (p->settled)
+                {
+                    refund = ok; // a different attempt already charged the customer
+                }
+                else if (ok)
+                {
+                    settleLocked(p, true, proc->getProcessorName(), attemptId);
+                }
+                else if (attemptId == p->currentAttempt)
+                {
+                    failoverLocked(p); // hard decline/error: try the next processor now
+                }
+                else if (p->nextLane >= lanes.size() && p->outstanding == 0)
+                {
+                    settleLocked(p, false, "", p->currentAttempt);
+                }
+            }
+            if (refund)
+            {
+                // Compensate the late duplicate. A processor that cannot refund
+                // leaves the customer double-charged, so count that separately.
+                if (proc->refund({p->key, p->amount}))
+                {
+                    bump([](GatewayStats &s) { ++s.lateRefunds; });
+                }
+                else
+                {
+                    bump([](GatewayStats &s) { ++s.failedRefunds; });
+                }
+            }
+        }
+
+    public:
+        AsyncPaymentGateway(const vector<PaymentProcessor *> &processors, Options opts)
+            : options(opts), pool(processors.size() * opts.maxInFlightPerProcessor)
+        {
+            for (PaymentProcessor *proc : processors)
+            {
+                lanes.push_back(make_unique<Lane>());
+                lanes.back()->processor = proc;
+            }
+        }
+
+        // Timers first, so no new failover is started; then the pool runs
+        // what is queued and joins, while every other member is still alive.
+        ~AsyncPaymentGateway()
+        {
+            timers.shutdown();
+            pool.shutdown();
+        }
+
+        AsyncPaymentGateway(const AsyncPaymentGateway &) = delete;
+        AsyncPaymentGateway &operator=(const AsyncPaymentGateway &) = delete;
+
+        // Safe to call again with the same key (client retry): the original
+        // payment's result is returned and no second charge is started.
+        shared_future<PaymentResult> submit(const string &idempotencyKey, double amount)
+        {
+            bump([](GatewayStats &s) { ++s.submitted; });
+            auto p = make_shared<PaymentState>();
+            p->key = idempotencyKey;
+            p->amount = amount;
+            p->result = p->done.get_future().share();
+
+            if (options.idempotency)
+            {
+                Shard &shard = table[hash<string>{}(idempotencyKey) % kShards];
+                lock_guard<mutex> lock(shard.mtx);
+                evictLocked(shard);
+                auto [it, inserted] = shard.byKey.emplace(idempotencyKey, p);
+                if (!inserted)
+                {
+                    bump([](GatewayStats &s) { ++s.dedupedRetries; });
+                    return it->second->result;
+                }
+                shard.byAge.push_back(p);
+            }
+
+            lock_guard<mutex> lock(p->mtx);
+            startAttemptLocked(p);
+            return p->result;
+        }
+
+        GatewayStats stats() const
+        {
+            lock_guard<mutex> lock(statsMtx);
+            return stats_;
+        }
+    };
+
+    // Same checkout flow as OrderService, but non-blocking: the caller gets a
+    // future and the order id doubles as the idempotency key.
+    class AsyncOrderService
+    {
+    private:
+        AsyncPaymentGateway *gateway;
+
+    public:
+        AsyncOrderService(AsyncPaymentGateway *gw) : gateway(gw) {}
+
+        shared_future<PaymentResult> checkoutAsync(const string &orderId, double amount)
+        {
+            return gateway->submit("order-" + orderId, amount);
+        }
+    };
+
+    // Local fake processor with injected latency, slow outliers and declines.
+    // Keeps a ledger of net charges per idempotency key so duplicate charges
+    // are measured at the "bank", independent of the gateway's bookkeeping.
+    class FakeProcessor : public PaymentProcessor
+    {
+    public:
+        struct Behaviour
+        {
+            chrono::microseconds latency{2000};
+            double slowRate = 0.0; // fraction of calls that take slowLatency
+            chrono::microseconds slowLatency{60000};
+            double declineRate = 0.0;
+        };
+
+    private:
+        string name;
+        Behaviour behaviour;
+        mutex ledgerMtx;
+        unordered_map<string, int> ledger; // key -> net charges
+
+        double roll()
+        {
+            thread_local mt19937_64 rng(hash<thread::id>{}(this_thread::get_id()));
+            return uniform_real_distribution<double>(0.0, 1.0)(rng);
+        }
+
+    public:
+        FakeProcessor(string processorName, Behaviour b) : name(move(processorName)), behaviour(b) {}
+
+        bool processPayment(double amount) override
+        {
+            return charge({"", amount});
+        }
+
+        bool charge(const ChargeRequest &request) override
+        {
+            this_thread::sleep_for(roll() < behaviour.slowRate ? behaviour.slowLatency
+                                                               : behaviour.latency);
+            if (roll() < behaviour.declineRate)
+            {
+                return false;
+            }
+            lock_guard<mutex> lock(ledgerMtx);
+            ++ledger[request.idempotencyKey];
+            return true;
+        }
+
+        bool refund(const ChargeRequest &request) override
+        {
+            lock_guard<mutex> lock(ledgerMtx);
+            --ledger[request.idempotencyKey];
+            return true;
+        }
+
+        string getProcessorName() const override
+        {
+            return name;
+        }
+
+        // Adds this processor's net charges into a cross-processor ledger.
+        void mergeLedger(unordered_map<string, int> &total)
+        {
+            lock_guard<mutex> lock(ledgerMtx);
+            for (const auto &[key, n] : ledger)
+            {
+                total[key] += n;
+            }
+        }
+    };
+
+    // ------------------------------------------------------------------------
+    // Benchmark: orders/sec and duplicate charges under client retries
+    // ------------------------------------------------------------------------
+
+    inline void runPaymentLoad(const char *label, bool idempotency)
+    {
+        constexpr int kOrders = 10000;
+        constexpr double kRetryRate = 0.3; // clients re-submit 30% of orders
 
-    public:
-        OrderService(PaymentProcessor *proc) : processor(proc) {}
+        FakeProcessor stripe("Stripe", {chrono::microseconds(2000), 0.05, chrono::microseconds(60000), 0.01});
+        FakeProcessor paypal("PayPal", {chrono::microseconds(3000), 0.02, chrono::microseconds(60000), 0.01});
+        FakeProcessor square("Square", {chrono::microseconds(4000), 0.0, chrono::microseconds(0), 0.01});
 
-        void checkout(double amount)
-        {
-            cout << "\n=== Checkout Process ===\n";
-            cout << "Using payment processor: "
-                 << processor->getProcessorName() << "\n";
+        AsyncPaymentGateway::Options opts;
+        opts.idempotency = idempotency;
+        AsyncPaymentGateway gateway({&stripe, &paypal, &square}, opts);
+        AsyncOrderService orders(&gateway);
 
-            bool success = processor->processPayment(amount);
+        mt19937 rng(42);
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        vector<shared_future<PaymentResult>> pending;
+        pending.reserve(kOrders * 2);
 
-            if (success)
-            {
-                cout << "Order completed successfully!\n";
-            }
-            else
+        const auto start = Clock::now();
+        for (int i = 0; i < kOrders; ++i)
+        {
+            const string id = to_string(i);
+            pending.push_back(orders.checkoutAsync(id, 10.0 + i % 90));
+            if (coin(rng) < kRetryRate)
             {
-                cout << "Payment failed!\n";
+                pending.push_back(orders.checkoutAsync(id, 10.0 + i % 90)); // impatient client
             }
         }
+        uint64_t ok = 0;
+        for (auto &f : pending)
+        {
+            ok += f.get().success;
+        }
+        const double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+        unordered_map<string, int> ledger;
+        stripe.mergeLedger(ledger);
+        paypal.mergeLedger(ledger);
+        square.mergeLedger(ledger);
+        uint64_t duplicates = 0;
+        for (const auto &[key, n] : ledger)
+        {
+            duplicates += n > 1 ? n - 1 : 0;
+        }
 
-        void setPaymentProcessor(PaymentProcessor *proc)
+        const GatewayStats s = gateway.stats();
+        cout << "  " << label << ": " << static_cast<uint64_t>(kOrders / seconds) << " orders/sec, "
+             << s.submitted << " submits (" << s.dedupedRetries << " deduped), "
+             << ok << " ok responses, " << s.timeouts << " timeouts, " << s.failovers
+             << " failovers, " << s.skippedAttempts << " queued attempts skipped, "
+             << s.lateRefunds << " late charges refunded, "
+             << s.failedRefunds << " refunds FAILED, "
+             << duplicates << " DUPLICATE CHARGES\n";
+    }
+
+    inline void benchmarkPayments()
+    {
+        cout << "\n--- ASYNC PAYMENTS BENCHMARK (10k orders, 30% client retries) ---\n";
+
+        // Baseline: the synchronous OrderService path, one order at a time
         {
-            processor = proc;
+            constexpr int kOrders = 300;
+            FakeProcessor stripe("Stripe", {chrono::microseconds(2000), 0.05, chrono::microseconds(60000), 0.01});
+            OrderService service(&stripe);
+            streambuf *console = cout.rdbuf(nullptr); // checkout() narrates every order
+            const auto start = Clock::now();
+            for (int i = 0; i < kOrders; ++i)
+            {
+                service.checkout(10.0);
+            }
+            const double seconds = chrono::duration<double>(Clock::now() - start).count();
+            cout.rdbuf(console); // also clears the badbit set while silenced
+            cout << "  sync OrderService          : " << static_cast<uint64_t>(kOrders / seconds)
+                 << " orders/sec (one processor, one call at a time)\n";
         }
-    };
+        runPaymentLoad("async, no idempotency keys", false);
+        runPaymentLoad("async + idempotency table  ", true);
+    }
 }
 
 // ============================================================================
@@ -384,54 +1568,802 @@ namespace logging_system
         }
     };
 
-    // File logger
+    // ------------------------------------------------------------------------
+    // Production-grade details behind the SAME Logger abstraction.
+    // ApplicationService below is untouched - that is the point of DIP.
+    // ------------------------------------------------------------------------
+
+    using Clock = chrono::steady_clock;
+
+    // Durability/throughput counters shared by the buffered backends.
+    // "lag" = time from log() returning to the record being durable
+    // (fsync'd for FileLogger, acknowledged by the sink for CloudLogger).
+    struct BackendStats
+    {
+        uint64_t linesAccepted = 0;
+        uint64_t linesDurable = 0;
+        uint64_t batches = 0;   // fsync groups / HTTP requests that succeeded
+        uint64_t rotations = 0; // FileLogger only
+        uint64_t retries = 0;   // CloudLogger only
+        uint64_t linesDropped = 0; // failed write/fsync, or retries exhausted
+        uint64_t errors = 0;       // failed write/fsync/rotation
+        uint64_t rawBytes = 0;
+        uint64_t shippedBytes = 0; // bytes after compression (CloudLogger)
+        double avgLagMs = 0; // per durable line, from its batch's oldest line
+        double maxLagMs = 0;
+    };
+
+    // Double-buffered staging area used by both backends.
+    // Callers append under a short mutex; a background thread swaps the
+    // buffer out and does the slow I/O without holding the lock.
+    //
+    //   callers --append--> [front] --swap--> [back] --write/fsync or POST-->
+    //
+    // Memory is bounded: when front is full, callers block (backpressure)
+    // instead of growing an unbounded queue.
+    class StagingBuffer
+    {
+    private:
+        mutex mtx;
+        condition_variable dataReady;
+        condition_variable spaceReady;
+        string front;
+        size_t capacity;
+        size_t wakeThreshold;
+        uint64_t frontLines = 0;
+        Clock::time_point frontOldest;
+        bool stopping = false;
+
+    public:
+        struct Batch
+        {
+            string bytes;
+            uint64_t lines = 0;
+            Clock::time_point oldest;
+        };
+
+        StagingBuffer(size_t capacityBytes, size_t wakeBytes)
+            : capacity(capacityBytes), wakeThreshold(wakeBytes)
+        {
+            front.reserve(capacity);
+        }
+
+        void append(const char *tag, const string &message)
+        {
+            const size_t needed = strlen(tag) + message.size() + 1;
+            unique_lock<mutex> lock(mtx);
+            // An oversized line is accepted into an empty buffer rather than
+            // waiting forever for space that can never appear.
+            spaceReady.wait(lock, [&]() {
+                return front.empty() || front.size() + needed <= capacity;
+            });
+            if (front.empty())
+            {
+                frontOldest = Clock::now();
+            }
+            front += tag;
+            front += message;
+            front += '\n';
+            ++frontLines;
+            if (front.size() >= wakeThreshold)
+            {
+                dataReady.notify_one();
+            }
+        }
+
+        // Waits up to `interval` (or until wakeThreshold bytes are staged),
+        // then hands the staged bytes over. Returns false once stopped and empty.
+        bool take(Batch &batch, chrono::milliseconds interval)
+        {
+            unique_lock<mutex> lock(mtx);
+            dataReady.wait_for(lock, interval, [&]() {
+                return stopping || front.size() >= wakeThreshold;
+            });
+            if (front.empty())
+            {
+                return !stopping;
+            }
+            batch.bytes.clear();
+            swap(front, batch.bytes); // front inherits the old batch's capacity
+            batch.lines = frontLines;
+            batch.oldest = frontOldest;
+            frontLines = 0;
+            lock.unlock();
+            spaceReady.notify_all();
+            return true;
+        }
+
+        void stop()
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+            dataReady.notify_one();
+        }
+    };
+
+    // Lag bookkeeping shared by both backends. accepted() is on the caller's
+    // path, so it is a single relaxed atomic; the rest runs on the I/O thread.
+    class LagTracker
+    {
+    private:
+        atomic<uint64_t> accepted_{0};
+        atomic<uint64_t> settled_{0}; // durable + abandoned
+        mutable mutex mtx;
+        BackendStats stats;
+        double totalLagMs = 0;
+
+    public:
+        void accepted() { accepted_.fetch_add(1, memory_order_relaxed); }
+
+        void durable(const StagingBuffer::Batch &batch, size_t shippedBytes)
+        {
+            const double lagMs =
+                chrono::duration<double, milli>(Clock::now() - batch.oldest).count();
+            {
+                lock_guard<mutex> lock(mtx);
+                stats.linesDurable += batch.lines;
+                stats.rawBytes += batch.bytes.size();
+                stats.shippedBytes += shippedBytes;
+                ++stats.batches;
+                totalLagMs += lagMs * batch.lines; // per-line mean, not per-batch
+                stats.maxLagMs = max(stats.maxLagMs, lagMs);
+            }
+            settled_.fetch_add(batch.lines, memory_order_release);
+        }
+
+        // The lines are settled (flush() stops waiting for them) but NOT durable.
+        void abandoned(uint64_t lines)
+        {
+            {
+                lock_guard<mutex> lock(mtx);
+                stats.linesDropped += lines;
+            }
+            settled_.fetch_add(lines, memory_order_release);
+        }
+
+        void failed()
+        {
+            lock_guard<mutex> lock(mtx);
+            ++stats.errors;
+        }
+
+        void rotated()
+        {
+            lock_guard<mutex> lock(mtx);
+            ++stats.rotations;
+        }
+
+        void retried()
+        {
+            lock_guard<mutex> lock(mtx);
+            ++stats.retries;
+        }
+
+        BackendStats snapshot() const
+        {
+            lock_guard<mutex> lock(mtx);
+            BackendStats s = stats;
+            s.linesAccepted = accepted_.load(memory_order_relaxed);
+            s.avgLagMs = s.linesDurable ? totalLagMs / s.linesDurable : 0;
+            return s;
+        }
+
+        // Blocks until every accepted line is durable or was given up on.
+        void waitDrained() const
+        {
+            while (settled_.load(memory_order_acquire) < accepted_.load(memory_order_relaxed))
+            {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        }
+    };
+
+    struct FileLoggerOptions
+    {
+        size_t bufferBytes = 1 << 20;                 // 1 MiB userspace buffer
+        size_t rotateBytes = 64u << 20;               // rotate at 64 MiB...
+        chrono::seconds rotateAge = chrono::hours(1); // ...or after 1 hour
+        int maxBackups = 3;                           // app.log.1 .. app.log.3
+        chrono::milliseconds fsyncInterval{20};       // group-commit window
+    };
+
+    // File logger: appends to disk through a large userspace buffer.
+    // One background thread owns the fd: it writes each swapped-out buffer
+    // with write(2), then issues ONE fsync for the whole group (group commit),
+    // so durability costs one fsync per interval instead of one per line.
     class FileLogger : public Logger
     {
     private:
         string filename;
+        FileLoggerOptions options;
+        int fd = -1;
+        size_t fileBytes = 0;
+        Clock::time_point fileOpened;
+
+        StagingBuffer staging;
+        LagTracker tracker;
+        thread flusher;
+
+        // fd only changes once the new file is open
+        void openFile()
+        {
+            const int newFd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (newFd < 0)
+            {
+                throw runtime_error("FileLogger: cannot open " + filename + ": " + strerror(errno));
+            }
+            fd = newFd;
+            struct stat st;
+            fileBytes = (::fstat(fd, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+            fileOpened = Clock::now();
+        }
+
+        // app.log -> app.log.1 -> app.log.2 ... oldest backup is overwritten.
+        // Runs on the flusher thread: a failure must not throw out of it
+        // (std::terminate), so the old fd - now the renamed backup - stays in use.
+        void rotate()
+        {
+            for (int i = options.maxBackups - 1; i >= 1; --i)
+            {
+                const string from = filename + "." + to_string(i);
+                const string to = filename + "." + to_string(i + 1);
+                ::rename(from.c_str(), to.c_str()); // missing backups are fine
+            }
+            if (options.maxBackups > 0)
+            {
+                ::rename(filename.c_str(), (filename + ".1").c_str());
+            }
+            else
+            {
+                ::unlink(filename.c_str());
+            }
+            const int oldFd = fd;
+            try
+            {
+                openFile();
+            }
+            catch (const exception &e)
+            {
+                cerr << e.what() << " (rotation failed, still writing to the old file)\n";
+                tracker.failed();
+                fileBytes = 0; // do not retry on every batch
+                fileOpened = Clock::now();
+                return;
+            }
+            ::close(oldFd);
+            tracker.rotated();
+        }
+
+        bool writeAll(const string &bytes)
+        {
+            size_t done = 0;
+            while (done < bytes.size())
+            {
+                const ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    cerr << "FileLogger: write failed: " << strerror(errno) << "\n";
+                    fileBytes += done;
+                    return false;
+                }
+                done += static_cast<size_t>(n);
+            }
+            fileBytes += done;
+            return true;
+        }
+
+        void flushLoop()
+        {
+            StagingBuffer::Batch batch;
+            batch.bytes.reserve(options.bufferBytes);
+            while (staging.take(batch, options.fsyncInterval))
+            {
+                if (batch.lines == 0)
+                {
+                    continue; // interval elapsed with nothing staged
+                }
+                // one fsync covers every line in the group
+                if (!writeAll(batch.bytes))
+                {
+                    tracker.failed();
+                    tracker.abandoned(batch.lines);
+                }
+                else if (::fsync(fd) != 0)
+                {
+                    cerr << "FileLogger: fsync failed: " << strerror(errno) << "\n";
+                    tracker.failed();
+                    tracker.abandoned(batch.lines);
+                }
+                else
+                {
+                    tracker.durable(batch, batch.bytes.size());
+                }
+                batch.lines = 0;
+
+                if (fileBytes >= options.rotateBytes ||
+                    Clock::now() - fileOpened >= options.rotateAge)
+                {
+                    rotate();
+                }
+            }
+        }
+
+        void append(const char *tag, const string &message)
+        {
+            tracker.accepted();
+            staging.append(tag, message);
+        }
 
     public:
-        FileLogger(const string &file) : filename(file) {}
+        FileLogger(const string &file, FileLoggerOptions opts = FileLoggerOptions())
+            : filename(file), options(opts),
+              staging(opts.bufferBytes, opts.bufferBytes / 2)
+        {
+            openFile();
+            flusher = thread(&FileLogger::flushLoop, this);
+        }
+
+        ~FileLogger() override
+        {
+            staging.stop(); // flusher drains what is staged, then exits
+            flusher.join();
+            ::close(fd);
+        }
+
+        FileLogger(const FileLogger &) = delete;
+        FileLogger &operator=(const FileLogger &) = delete;
 
         void log(const string &message) override
         {
-            cout << "[FILE LOG to " << filename << "] " << message << "\n";
+            append("[LOG] ", message);
         }
 
         void error(const string &message) override
         {
-            cout << "[FILE ERROR to " << filename << "] " << message << "\n";
+            append("[ERROR] ", message);
         }
 
         void warning(const string &message) override
         {
-            cout << "[FILE WARNING to " << filename << "] " << message << "\n";
+            append("[WARNING] ", message);
+        }
+
+        // Blocks until everything logged so far was fsync'd or dropped (see stats().linesDropped).
+        void flush() { tracker.waitDrained(); }
+
+        BackendStats stats() const { return tracker.snapshot(); }
+    };
+
+    // Minimal LZ77 codec (no external dependency). Log batches are highly
+    // repetitive (same prefixes, same message templates), so even this tiny
+    // scheme usually shrinks them several-fold.
+    //   token 0xxxxxxx            : (x+1) literal bytes follow
+    //   token 1xxxxxxx  lo  hi    : copy (x+4) bytes from `offset` back
+    namespace lz
+    {
+        inline string compress(const string &in)
+        {
+            string out;
+            out.reserve(in.size() / 2 + 16);
+            vector<int32_t> table(1 << 12, -1); // last position of each 4-byte hash
+            size_t i = 0;
+            size_t literalStart = 0;
+
+            auto emitLiterals = [&](size_t end) {
+                while (literalStart < end)
+                {
+                    const size_t n = min<size_t>(128, end - literalStart);
+                    out.push_back(static_cast<char>(n - 1));
+                    out.append(in, literalStart, n);
+                    literalStart += n;
+                }
+            };
+
+            while (i + 4 <= in.size())
+            {
+                uint32_t word;
+                memcpy(&word, in.data() + i, 4);
+                const uint32_t h = (word * 2654435761u) >> 20;
+                const int32_t candidate = table[h];
+                table[h] = static_cast<int32_t>(i);
+
+                if (candidate >= 0 && i - candidate <= 0xFFFF &&
+                    memcmp(in.data() + candidate, in.data() + i, 4) == 0)
+                {
+                    size_t len = 4;
+                    while (i + len < in.size() && len < 131 && in[candidate + len] == in[i + len])
+                    {
+                        ++len;
+                    }
+                    emitLiterals(i);
+                    const size_t offset = i - candidate;
+                    out.push_back(static_cast<char>(0x80 | (len - 4)));
+                    out.push_back(static_cast<char>(offset & 0xFF));
+                    out.push_back(static_cast<char>(offset >> 8));
+                    i += len;
+                    literalStart = i;
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+            emitLiterals(in.size());
+            return out;
+        }
+
+        // The input may come off the network, so every length and offset is
+        // checked; malformed input throws instead of reading out of bounds.
+        inline string decompress(const string &in)
+        {
+            string out;
+            size_t i = 0;
+            while (i < in.size())
+            {
+                const auto token = static_cast<unsigned char>(in[i++]);
+                if (token & 0x80)
+                {
+                    if (in.size() - i < 2)
+                    {
+                        throw runtime_error("lz: truncated match token");
+                    }
+                    const size_t len = (token & 0x7F) + 4;
+                    const size_t offset = static_cast<unsigned char>(in[i]) |
+                                          (static_cast<unsigned char>(in[i + 1]) << 8);
+                    i += 2;
+                    if (offset == 0 || offset > out.size())
+                    {
+                        throw runtime_error("lz: match offset out of range");
+                    }
+                    const size_t from = out.size() - offset;
+                    for (size_t k = 0; k < len; ++k) // byte-wise: ranges may overlap
+                    {
+                        out.push_back(out[from + k]);
+                    }
+                }
+                else
+                {
+                    const size_t len = token + 1u;
+                    if (in.size() - i < len)
+                    {
+                        throw runtime_error("lz: truncated literal run");
+                    }
+                    out.append(in, i, len);
+                    i += len;
+                }
+            }
+            return out;
+        }
+    }
+
+    // Blocking HTTP/1.1 POST over a fresh TCP connection; returns the status
+    // code or -1 on a transport error. Enough for a local sink stand-in.
+    inline int httpPost(const string &host, uint16_t port, const string &path,
+                        const string &body, uint64_t lines)
+    {
+        const int sock = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0)
+        {
+            return -1;
+        }
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1 ||
+            ::connect(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(sock);
+            return -1;
+        }
+
+        const string header = "POST " + path + " HTTP/1.1\r\nHost: " + host +
+                              "\r\nContent-Type: text/plain\r\nContent-Encoding: x-lz77" +
+                              "\r\nX-Log-Lines: " + to_string(lines) +
+                              "\r\nContent-Length: " + to_string(body.size()) +
+                              "\r\nConnection: close\r\n\r\n";
+        iovec iov[2] = {{const_cast<char *>(header.data()), header.size()},
+                        {const_cast<char *>(body.data()), body.size()}};
+        size_t total = header.size() + body.size();
+        size_t sent = 0;
+        while (sent < total)
+        {
+            msghdr msg{};
+            size_t skip = sent;
+            iovec parts[2];
+            int count = 0;
+            for (auto &part : iov)
+            {
+                if (skip >= part.iov_len)
+                {
+                    skip -= part.iov_len;
+                    continue;
+                }
+                parts[count++] = {static_cast<char *>(part.iov_base) + skip, part.iov_len - skip};
+                skip = 0;
+            }
+            msg.msg_iov = parts;
+            msg.msg_iovlen = count;
+            const ssize_t n = ::sendmsg(sock, &msg, MSG_NOSIGNAL);
+            if (n <= 0)
+            {
+                ::close(sock);
+                return -1;
+            }
+            sent += static_cast<size_t>(n);
+        }
+
+        char response[256];
+        const ssize_t n = ::recv(sock, response, sizeof(response) - 1, 0);
+        ::close(sock);
+        if (n < 12) // "HTTP/1.1 200"
+        {
+            return -1;
         }
+        response[n] = '\0';
+        return atoi(response + 9);
+    }
+
+    struct CloudLoggerOptions
+    {
+        size_t batchBytes = 256 << 10;          // ship when 256 KiB are staged...
+        chrono::milliseconds batchInterval{50}; // ...or every 50 ms
+        int maxAttempts = 5;                    // then the batch is dropped
+        chrono::milliseconds retryBackoff{2};   // doubled after every failure
     };
 
-    // Cloud logger
+    // Cloud logger: batches lines, compresses each batch and POSTs it to an
+    // HTTP ingest endpoint ("http://127.0.0.1:<port>/<path>") with retries and
+    // exponential backoff. Callers never touch the network.
     class CloudLogger : public Logger
     {
     private:
         string endpoint;
+        string host;
+        uint16_t port = 0;
+        string path;
+        CloudLoggerOptions options;
+
+        StagingBuffer staging;
+        LagTracker tracker;
+        thread shipper;
+
+        void parseEndpoint()
+        {
+            const string scheme = "http://";
+            if (endpoint.compare(0, scheme.size(), scheme) != 0)
+            {
+                throw invalid_argument("CloudLogger: only http:// endpoints are supported: " + endpoint);
+            }
+            const size_t hostStart = scheme.size();
+            const size_t colon = endpoint.find(':', hostStart);
+            const size_t slash = endpoint.find('/', hostStart);
+            if (colon == string::npos || (slash != string::npos && colon > slash))
+            {
+                throw invalid_argument("CloudLogger: endpoint needs an explicit port: " + endpoint);
+            }
+            host = endpoint.substr(hostStart, colon - hostStart);
+            port = static_cast<uint16_t>(stoi(endpoint.substr(colon + 1, slash - colon - 1)));
+            path = slash == string::npos ? "/" : endpoint.substr(slash);
+        }
+
+        void shipLoop()
+        {
+            StagingBuffer::Batch batch;
+            while (staging.take(batch, options.batchInterval))
+            {
+                if (batch.lines == 0)
+                {
+                    continue;
+                }
+                const string payload = lz::compress(batch.bytes);
+                auto backoff = options.retryBackoff;
+                bool shipped = false;
+                for (int attempt = 1; attempt <= options.maxAttempts && !shipped; ++attempt)
+                {
+                    const int status = httpPost(host, port, path, payload, batch.lines);
+                    shipped = status >= 200 && status < 300;
+                    if (!shipped && attempt < options.maxAttempts)
+                    {
+                        tracker.retried();
+                        this_thread::sleep_for(backoff);
+                        backoff *= 2;
+                    }
+                }
+                if (shipped)
+                {
+                    tracker.durable(batch, payload.size());
+                }
+                else
+                {
+                    cerr << "CloudLogger: dropping batch of " << batch.lines
+                         << " lines after " << options.maxAttempts << " attempts\n";
+                    tracker.abandoned(batch.lines);
+                }
+                batch.lines = 0;
+            }
+        }
+
+        void append(const char *tag, const string &message)
+        {
+            tracker.accepted();
+            staging.append(tag, message);
+        }
 
     public:
-        CloudLogger(const string &ep) : endpoint(ep) {}
+        CloudLogger(const string &ep, CloudLoggerOptions opts = CloudLoggerOptions())
+            : endpoint(ep), options(opts),
+              staging(opts.batchBytes * 4, opts.batchBytes)
+        {
+            parseEndpoint();
+            shipper = thread(&CloudLogger::shipLoop, this);
+        }
+
+        ~CloudLogger() override
+        {
+            staging.stop();
+            shipper.join();
+        }
+
+        CloudLogger(const CloudLogger &) = delete;
+        CloudLogger &operator=(const CloudLogger &) = delete;
 
         void log(const string &message) override
         {
-            cout << "[CLOUD LOG to " << endpoint << "] " << message << "\n";
+            append("[LOG] ", message);
         }
 
         void error(const string &message) override
         {
-            cout << "[CLOUD ERROR to " << endpoint << "] " << message << "\n";
+            append("[ERROR] ", message);
         }
 
         void warning(const string &message) override
         {
-            cout << "[CLOUD WARNING to " << endpoint << "] " << message << "\n";
+            append("[WARNING] ", message);
+        }
+
+        // Blocks until every accepted line was acknowledged (or given up on).
+        void flush() { tracker.waitDrained(); }
+
+        BackendStats stats() const { return tracker.snapshot(); }
+    };
+
+    // Local stand-in for a log-ingest service: accepts POSTs on 127.0.0.1,
+    // decompresses and counts lines, and fails every Nth request with 503 so
+    // the retry path is exercised.
+    class LocalHttpSink
+    {
+    private:
+        int listenFd = -1;
+        uint16_t port = 0;
+        int failEvery;
+        bool verbose;
+        atomic<bool> stopping{false};
+        atomic<uint64_t> requests{0};
+        atomic<uint64_t> linesReceived{0};
+        thread server;
+
+        static bool readRequest(int fd, string &headers, string &body)
+        {
+            string data;
+            char chunk[64 << 10];
+            size_t headerEnd = string::npos;
+            size_t contentLength = 0;
+            while (true)
+            {
+                const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0)
+                {
+                    return false;
+                }
+                data.append(chunk, static_cast<size_t>(n));
+                if (headerEnd == string::npos)
+                {
+                    headerEnd = data.find("\r\n\r\n");
+                    if (headerEnd == string::npos)
+                    {
+                        continue;
+                    }
+                    headers = data.substr(0, headerEnd);
+                    const size_t pos = headers.find("Content-Length: ");
+                    contentLength = pos == string::npos ? 0 : stoul(headers.substr(pos + 16));
+                }
+                if (data.size() >= headerEnd + 4 + contentLength)
+                {
+                    body = data.substr(headerEnd + 4, contentLength);
+                    return true;
+                }
+            }
+        }
+
+        void serve()
+        {
+            while (!stopping.load())
+            {
+                pollfd pfd{listenFd, POLLIN, 0};
+                if (::poll(&pfd, 1, 20) <= 0)
+                {
+                    continue; // timeout: re-check stopping
+                }
+                const int client = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client < 0)
+                {
+                    continue;
+                }
+                string headers, body;
+                if (readRequest(client, headers, body))
+                {
+                    const uint64_t n = ++requests;
+                    const char *reply;
+                    if (failEvery > 0 && n % failEvery == 0)
+                    {
+                        reply = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n";
+                    }
+                    else
+                    {
+                        string text;
+                        try
+                        {
+                            text = lz::decompress(body);
+                            reply = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+                        }
+                        catch (const runtime_error &)
+                        {
+                            reply = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+                        }
+                        const uint64_t lines = static_cast<uint64_t>(count(text.begin(), text.end(), '\n'));
+                        linesReceived += lines;
+                        if (verbose)
+                        {
+                            cout << "[SINK] batch of " << lines << " lines ("
+                                 << body.size() << " bytes compressed, "
+                                 << text.size() << " raw)\n";
+                        }
+                    }
+                    ::send(client, reply, strlen(reply), MSG_NOSIGNAL);
+                }
+                ::close(client);
+            }
+        }
+
+    public:
+        explicit LocalHttpSink(int failEveryNth = 0, bool verboseOutput = false)
+            : failEvery(failEveryNth), verbose(verboseOutput)
+        {
+            listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = 0; // let the kernel pick a free port
+            socklen_t len = sizeof(addr);
+            if (listenFd < 0 ||
+                ::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+                ::listen(listenFd, 64) != 0 ||
+                ::getsockname(listenFd, reinterpret_cast<sockaddr *>(&addr), &len) != 0)
+            {
+                throw runtime_error(string("LocalHttpSink: ") + strerror(errno));
+            }
+            port = ntohs(addr.sin_port);
+            server = thread(&LocalHttpSink::serve, this);
+        }
+
+        ~LocalHttpSink()
+        {
+            stopping = true;
+            server.join();
+            ::close(listenFd);
+        }
+
+        string endpoint() const
+        {
+            return "http://127.0.0.1:" + to_string(port) + "/ingest";
         }
+
+        uint64_t lines() const { return linesReceived.load(); }
     };
 
     // Application service depends on logger abstraction
@@ -465,6 +2397,91 @@ namespace logging_system
             logger = log;
         }
     };
+
+    // ------------------------------------------------------------------------
+    // Benchmark: sustained lines/sec and durability lag per backend
+    // ------------------------------------------------------------------------
+
+    // kThreads writers each log kLinesPerThread lines, then we wait until the
+    // backend reports them durable. Throughput includes that final flush.
+    inline void runLoggerLoad(const char *name, Logger &logger, const function<void()> &flush,
+                              const function<BackendStats()> &stats)
+    {
+        constexpr int kThreads = 4;
+        constexpr int kLinesPerThread = 250000;
+
+        const auto start = Clock::now();
+        vector<thread> writers;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            writers.emplace_back([&logger, t]() {
+                const string msg = "order " + to_string(t) + " processed for user@example.com in 12ms";
+                for (int i = 0; i < kLinesPerThread; ++i)
+                {
+                    if (i % 50 == 0)
+                    {
+                        logger.warning(msg);
+                    }
+                    else
+                    {
+                        logger.log(msg);
+                    }
+                }
+            });
+        }
+        for (auto &w : writers)
+        {
+            w.join();
+        }
+        flush();
+        const double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+        const BackendStats s = stats();
+        cout << "  " << name << ": " << static_cast<uint64_t>(s.linesDurable / seconds)
+             << " lines/sec (" << s.linesDurable << "/" << s.linesAccepted << " durable), "
+             << s.batches << " batches, lag avg " << s.avgLagMs << " ms / max "
+             << s.maxLagMs << " ms";
+        if (s.rotations)
+        {
+            cout << ", " << s.rotations << " rotations";
+        }
+        if (s.errors || s.linesDropped)
+        {
+            cout << ", " << s.errors << " I/O errors, " << s.linesDropped << " lines dropped";
+        }
+        if (s.shippedBytes != s.rawBytes)
+        {
+            cout << ", compression " << static_cast<double>(s.rawBytes) / s.shippedBytes
+                 << "x, " << s.retries << " retries";
+        }
+        cout << "\n";
+    }
+
+    inline void benchmarkLoggers()
+    {
+        cout << "\n--- LOGGING BACKENDS BENCHMARK (4 threads x 250k lines) ---\n";
+
+        const string dir = "/tmp/dip_logger_bench_" + to_string(::getpid());
+        ::mkdir(dir.c_str(), 0755);
+        {
+            FileLoggerOptions opts;
+            opts.rotateBytes = 16u << 20; // small, so rotation shows up in the run
+            FileLogger file(dir + "/bench.log", opts);
+            runLoggerLoad("FileLogger ", file, [&]() { file.flush(); }, [&]() { return file.stats(); });
+        }
+        {
+            LocalHttpSink sink(/*failEveryNth=*/7);
+            CloudLogger cloud(sink.endpoint());
+            runLoggerLoad("CloudLogger", cloud, [&]() { cloud.flush(); }, [&]() { return cloud.stats(); });
+            cout << "  sink received " << sink.lines() << " lines\n";
+        }
+        for (int i = 0; i <= FileLoggerOptions().maxBackups; ++i)
+        {
+            const string path = dir + "/bench.log" + (i ? "." + to_string(i) : "");
+            ::unlink(path.c_str());
+        }
+        ::rmdir(dir.c_str());
+    }
 }
 
 // ============================================================================
@@ -686,8 +2703,23 @@ namespace testing_example
 // MAIN: Demonstration
 // ============================================================================
 
-int main()
+int main(int argc, char *argv[])
 {
+    bool bench = false;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--bench")
+        {
+            bench = true;
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--bench]\n";
+            return 2;
+        }
+    }
+
     cout << "=== DEPENDENCY INVERSION PRINCIPLE (DIP) ===\n\n";
 
     // Notification System Demo
@@ -707,6 +2739,20 @@ int main()
     notifier.setMessageService(&push);
     notifier.notifyUser("user_device_id", "Your order has shipped!");
 
+    cout << "\nBulk campaign (one template, per-channel batches):\n";
+    good_design::RecipientList campaign({"name"});
+    campaign.add(good_design::Channel::Email, "user@example.com", {"Alice"});
+    campaign.add(good_design::Channel::SMS, "+1234567890", {"Bob"});
+    campaign.add(good_design::Channel::Push, "user_device_id", {"Carol"});
+    good_design::BulkNotifier bulk(&email, &sms, &push, 1);
+    bulk.notifyAll(good_design::MessageTemplate("Hi {name}, your order has shipped!", campaign.fields()),
+                   campaign);
+
+    if (bench)
+    {
+        good_design::benchmarkBulkNotify();
+    }
+
     // Payment Processing Demo
     cout << "\n--- PAYMENT PROCESSING ---\n";
     payment_system::StripeProcessor stripe;
@@ -722,6 +2768,11 @@ int main()
     order.setPaymentProcessor(&square);
     order.checkout(79.99);
 
+    if (bench)
+    {
+        payment_system::benchmarkPayments();
+    }
+
     // Storage System Demo
     cout << "\n--- STORAGE SYSTEM ---\n";
     storage_system::MySQLRepository mysql;
@@ -742,9 +2793,10 @@ int main()
 
     // Logging System Demo
     cout << "\n--- LOGGING SYSTEM ---\n";
+    logging_system::LocalHttpSink logSink(0, /*verbose=*/true); // stand-in for the log service
     logging_system::ConsoleLogger consoleLog;
     logging_system::FileLogger fileLog("app.log");
-    logging_system::CloudLogger cloudLog("https://logs.example.com");
+    logging_system::CloudLogger cloudLog(logSink.endpoint());
 
     logging_system::ApplicationService app(&consoleLog);
     cout << "\nWith Console Logger:\n";
@@ -753,10 +2805,18 @@ int main()
     cout << "\nWith File Logger:\n";
     app.setLogger(&fileLog);
     app.performOperation();
+    fileLog.flush();
+    cout << "(appended + fsync'd to app.log)\n";
 
     cout << "\nWith Cloud Logger:\n";
     app.setLogger(&cloudLog);
     app.performOperation();
+    cloudLog.flush();
+
+    if (bench)
+    {
+        logging_system::benchmarkLoggers();
+    }
 
     // Multi-layer System Demo
     cout << "\n--- MULTI-LAYER SYSTEM ---\n";
@@ -792,5 +2852,10 @@ int main()
     cout << "6. Makes code more flexible and maintainable\n";
     cout << "7. Core principle of IoC (Inversion of Control) containers\n";
 
+    if (!bench)
+    {
+        cout << "\n(run with --bench for the notification, payment and logging benchmarks)\n";
+    }
+
     return 0;
 }
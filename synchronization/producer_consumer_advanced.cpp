@@ -1,5 +1,8 @@
 // Advanced Producer-Consumer Example: Multiple Producers and Consumers
 // Demonstrates use of std::condition_variable, std::mutex, and safe shutdown for multiple threads.
+// Messages are heap objects allocated by producers and freed by consumers through the
+// thread-local caching allocator (../concurrency/tcache_allocator.h): every free is a
+// cross-thread "remote" free that flows back to the producer's cache in batches.
 
 #include <iostream>
 #include <thread>
@@ -8,12 +11,22 @@
 #include <queue>
 #include <vector>
 #include <chrono>
+#include <string>
+
+#include "../concurrency/tcache_allocator.h"
 
 using namespace std;
 
+struct Message
+{
+    int producer_id;
+    int value;
+    string text;
+};
+
 mutex mtx;
 condition_variable cv;
-queue<int> data_queue;
+queue<Message *> data_queue;
 bool finished_producing = false;
 const int NUM_PRODUCERS = 2;
 const int NUM_CONSUMERS = 3;
@@ -27,7 +40,7 @@ void producer(int id)
         lock_guard<mutex> lock(mtx);
         int value = id * 100 + i;
         cout << "Producer " << id << " pushing: " << value << endl;
-        data_queue.push(value);
+        data_queue.push(tcache::make<Message>(Message{id, value, "item " + to_string(value)}));
         cv.notify_one();
     }
     // Atomically update producer count and signal shutdown if all are done
@@ -51,13 +64,15 @@ void consumer(int id)
                 { return !data_queue.empty() || finished_producing; });
         if (!data_queue.empty())
         {
-            int data = data_queue.front();
+            Message *msg = data_queue.front();
             data_queue.pop();
             lock.unlock();
-            cout << "    Consumer " << id << " processed: " << data << endl;
+            cout << "    Consumer " << id << " processed: " << msg->value << " (" << msg->text << ")" << endl;
+            tcache::destroy(msg); // remote free: msg lives in the producer's span
         }
         else if (finished_producing)
         {
+            tcache::flush(); // hand pending remote frees back before exiting
             cout << "Consumer " << id << " finished." << endl;
             break;
         }
@@ -76,6 +91,9 @@ int main()
         t.join();
     for (auto &t : consumers)
         t.join();
+    tcache::Stats st = tcache::stats();
+    cout << "\nAllocator: " << st.allocs << " allocs, " << st.remote_frees << " remote frees in "
+         << st.remote_pushes << " batched pushes, " << st.spans << " span(s)" << endl;
     cout << "\nAll threads finished. Program complete." << endl;
     return 0;
 }
@@ -0,0 +1,111 @@
+// Producer-Consumer on the coroutine runtime (../concurrency/coro_runtime.h)
+//
+// Same story as producer_consumer.cpp, but nobody blocks an OS thread:
+// - the producer's sleep_for() is a timer in the reactor, not this_thread::sleep_for
+// - queue + mutex + condition_variable become one coro::Channel<int>
+//   - recv() on an empty channel suspends the consumer (its frame goes on a list)
+//   - close() replaces the finished_producing flag: recv() returns nullopt once drained
+// Part 2 scales the same code to 1000 producers / 100 consumers on 2 threads,
+// which as std::threads would be 1100 stacks and kernel tasks.
+//
+// Build: make STD=c++20 FILE=producer_consumer_coro.cpp run
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "../concurrency/coro_runtime.h"
+
+using namespace std;
+
+coro::task<void> producer(coro::Runtime &rt, coro::Channel<int> &channel)
+{
+    cout << "Producer starting..." << endl;
+    for (int i = 0; i < 10; ++i)
+    {
+        co_await rt.sleep_for(chrono::milliseconds(200)); // Simulate work; the worker thread stays free
+        cout << "  Producer pushing: " << i << endl;
+        co_await channel.send(i); // suspends only if the channel is full
+    }
+    cout << "Producer finished." << endl;
+    channel.close(); // wakes the consumer once the buffer is drained
+}
+
+coro::task<void> consumer(coro::Channel<int> &channel)
+{
+    cout << "Consumer starting..." << endl;
+    // No unique_lock, no predicate, no spurious wake-up loop: recv() either
+    // returns a value or nullopt (closed and empty).
+    while (optional<int> data = co_await channel.recv())
+    {
+        cout << "    Consumer processed: " << *data << endl;
+    }
+    cout << "Consumer finished." << endl;
+}
+
+// ---- Part 2: many producers and consumers ----
+
+coro::task<void> bulk_producer(coro::Runtime &rt, coro::Channel<int> &channel, int id, int items)
+{
+    for (int i = 0; i < items; ++i)
+    {
+        co_await rt.sleep_for(chrono::milliseconds(1 + id % 5));
+        co_await channel.send(id * items + i);
+    }
+}
+
+coro::task<void> bulk_consumer(coro::Channel<int> &channel, atomic<long> &sum, atomic<long> &count)
+{
+    while (optional<int> data = co_await channel.recv())
+    {
+        sum += *data;
+        count++;
+    }
+}
+
+coro::task<void> produce_then_close(coro::Runtime &rt, coro::Channel<int> &channel, int producers, int items)
+{
+    vector<coro::task<void>> producing;
+    for (int p = 0; p < producers; ++p)
+        producing.push_back(bulk_producer(rt, channel, p, items));
+    co_await coro::when_all(rt, std::move(producing));
+    channel.close(); // every producer is done: let the consumers drain and exit
+}
+
+coro::task<void> run_many(coro::Runtime &rt, int producers, int consumers, int items)
+{
+    coro::Channel<int> channel(rt, 64);
+    atomic<long> sum{0}, count{0};
+
+    vector<coro::task<void>> everyone;
+    everyone.push_back(produce_then_close(rt, channel, producers, items));
+    for (int c = 0; c < consumers; ++c)
+        everyone.push_back(bulk_consumer(channel, sum, count));
+    co_await coro::when_all(rt, std::move(everyone));
+
+    long n = long(producers) * items;
+    cout << producers << " producers -> " << consumers << " consumers: " << count << " items, sum "
+         << sum << " (expected " << n * (n - 1) / 2 << ") on " << rt.threads() << " threads" << endl;
+}
+
+int main()
+{
+    cout << "--- Producer-Consumer with coro::Channel ---" << endl;
+
+    coro::Runtime rt(2);
+    coro::Channel<int> channel(rt, 4);
+    vector<coro::task<void>> both;
+    both.push_back(producer(rt, channel));
+    both.push_back(consumer(channel));
+    rt.block_on(coro::when_all(rt, std::move(both)));
+
+    cout << "\n--- Scaling: 1000 producers x 10 items, 100 consumers ---" << endl;
+    auto start = chrono::steady_clock::now();
+    rt.block_on(run_many(rt, 1000, 100, 10));
+    auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    cout << "took " << ms << " ms" << endl;
+
+    cout << "\nAll coroutines finished. Program complete." << endl;
+    return 0;
+}
@@ -0,0 +1,73 @@
+// =============================================
+// Semaphore Example on the coroutine runtime
+// =============================================
+// Same problem as semaphore_native.cpp / semaphore_cpp20.cpp: only 3 workers
+// may use the "connection pool" at a time. Here the workers are coroutines:
+//   - co_await sem.acquire() suspends the coroutine instead of parking a thread
+//     in cv.wait(); release() hands the permit straight to the next waiter (FIFO)
+//   - the 500ms of "work" is a reactor timer, so 2 OS threads serve all workers
+//
+// Part 2 runs 10,000 workers through 100 slots - as threads that would be
+// 10,000 stacks, almost all of them blocked in cv.wait().
+//
+// Build: make STD=c++20 FILE=semaphore_coro.cpp run
+// See ../concurrency/coro_runtime.h for the runtime itself.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "../concurrency/coro_runtime.h"
+
+using namespace std;
+
+atomic<int> active{0};
+atomic<int> peak{0};
+
+coro::task<void> pooled_worker(coro::Runtime &rt, coro::Semaphore &sem, int id, chrono::milliseconds work, bool verbose)
+{
+    co_await sem.acquire(); // Wait for a slot
+    int now = ++active;
+    int seen = peak.load();
+    while (now > seen && !peak.compare_exchange_weak(seen, now))
+    {
+    }
+    if (verbose)
+        cout << "Coroutine " << id << " entered. Active: " << now << endl;
+
+    co_await rt.sleep_for(work); // Simulate work
+
+    now = --active;
+    if (verbose)
+        cout << "Coroutine " << id << " leaving. Active: " << now << endl;
+    sem.release(); // Release the slot
+}
+
+void run_pool(coro::Runtime &rt, int workers, int slots, chrono::milliseconds work, bool verbose)
+{
+    coro::Semaphore sem(rt, slots);
+    active = 0;
+    peak = 0;
+    vector<coro::task<void>> tasks;
+    for (int i = 0; i < workers; ++i)
+        tasks.push_back(pooled_worker(rt, sem, i, work, verbose));
+
+    auto start = chrono::steady_clock::now();
+    rt.block_on(coro::when_all(rt, std::move(tasks)));
+    auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    cout << workers << " workers, " << slots << " slots: peak active " << peak << ", took " << ms
+         << " ms (ideal " << (workers + slots - 1) / slots * work.count() << " ms)" << endl;
+}
+
+int main()
+{
+    cout << "Connection pool with coro::Semaphore..\n";
+    coro::Runtime rt(2);
+
+    run_pool(rt, 10, 3, chrono::milliseconds(500), true);
+
+    cout << "\n--- Scaling: 10000 workers through 100 slots ---" << endl;
+    run_pool(rt, 10000, 100, chrono::milliseconds(10), false);
+    return 0;
+}
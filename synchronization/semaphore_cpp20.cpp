@@ -11,6 +11,10 @@
 //   1. C++20 std::counting_semaphore (if supported by your compiler)
 //   2. A portable implementation using mutex and condition_variable (uncomment to use)
 //
+// Each worker receives its request as a heap object allocated by main() and
+// frees it when done, through the thread-local caching allocator
+// (../concurrency/tcache_allocator.h): a 1 -> N pool, every free is remote.
+//
 // Usage Note:
 //   - If your compiler does not support <semaphore>, use the portable CountingSemaphore class.
 //   - Both versions provide acquire()/release() methods for limiting concurrency.
@@ -24,6 +28,9 @@
 #include <condition_variable>
 #include <vector>
 #include <chrono>
+#include <string>
+
+#include "../concurrency/tcache_allocator.h"
 using namespace std;
 // Portable counting semaphore implementation
 class CountingSemaphore
@@ -53,22 +60,33 @@ CountingSemaphore sem(3);
 // Create a counting semaphore with 3 available slots
 // std::counting_semaphore<3> sem(3);
 
-void worker(int id)
+struct Request
+{
+    int id;
+    string query;
+};
+
+void worker(Request *req)
 {
     sem.acquire(); // Wait for a slot
-    cout << "Thread " << id << " entered\n";
+    cout << "Thread " << req->id << " entered (" << req->query << ")\n";
     // Simulate work
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    cout << "Thread " << id << " leaving\n";
+    cout << "Thread " << req->id << " leaving\n";
     sem.release(); // Release the slot
+    tcache::destroy(req); // remote free: req lives in main()'s span
+    tcache::flush();      // hand the pending remote free back before exiting
 }
 
 int main()
 {
     vector<thread> threads;
     for (int i = 0; i < 10; ++i)
-        threads.emplace_back(worker, i);
+        threads.emplace_back(worker, tcache::make<Request>(Request{i, "SELECT " + to_string(i)}));
     for (auto &t : threads)
         t.join();
+    tcache::Stats st = tcache::stats();
+    cout << "\nAllocator: " << st.allocs << " allocs, " << st.remote_frees << " remote frees in "
+         << st.remote_pushes << " batched pushes, " << st.spans << " span(s)\n";
     return 0;
 }